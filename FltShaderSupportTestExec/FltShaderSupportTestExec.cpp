@@ -4,18 +4,95 @@
 #include "stdafx.h"
 #include <GLTools.h>            // OpenGL toolkit
 #include <FL/Fl.H>
+#include <stdlib.h>
+#include <string.h>
 
 #include "config.h"
 #include "ShaderViewUI.h"
 
+// Headless benchmark mode (no window or display needed; falls back on a hidden window if the driver
+// can't make a window-less context):
+//   FltShaderSupportTestExec -headless <frames> [-size <w>x<h>] [-profile <file.csv|file.json>] [-image <file.tga>]
+// Input recording and replay:
+//   FltShaderSupportTestExec -record <file.irec>
+//   FltShaderSupportTestExec -replay <file.irec> [-fast] [-size <w>x<h>] [-profile <file.csv|file.json>]
+// -fast replays offscreen as fast as possible instead of in real time.
+// -ondemand only draws frames when something has changed.
+// -idpick picks through the object ID buffer (click or drag a box) instead of occlusion queries.
+// -raypick picks by casting a ray against the objects' bounding volumes on the CPU.
+// Anything else is passed on to FLTK
 int _tmain(int argc, _TCHAR* argv[])
 {
+	char **args = (char**)argv;
+	int headlessFrames = 0;
+	int headlessWidth = 550;
+	int headlessHeight = 550;
+	const char *profileFile = NULL;
+	const char *imageFile = NULL;
+	const char *recordFile = NULL;
+	const char *replayFile = NULL;
+	bool fastReplay = false;
+	bool onDemand = false;
+	bool idPick = false;
+	bool rayPick = false;
+	vector<char*> fltkArgs;
+
 	gltSetWorkingDirectory((const char*)argv[0]);
 
+	fltkArgs.push_back(args[0]);
+	for(int i = 1; i < argc; ++i){
+		if(strcmp(args[i], "-fast") == 0)
+			fastReplay = true;
+		else if(strcmp(args[i], "-ondemand") == 0)
+			onDemand = true;
+		else if(strcmp(args[i], "-idpick") == 0)
+			idPick = true;
+		else if(strcmp(args[i], "-raypick") == 0)
+			rayPick = true;
+		else if(i == argc-1)
+			fltkArgs.push_back(args[i]);
+		else if(strcmp(args[i], "-headless") == 0)
+			headlessFrames = atoi(args[++i]);
+		else if(strcmp(args[i], "-size") == 0)
+			sscanf_s(args[++i], "%dx%d", &headlessWidth, &headlessHeight);
+		else if(strcmp(args[i], "-profile") == 0)
+			profileFile = args[++i];
+		else if(strcmp(args[i], "-image") == 0)
+			imageFile = args[++i];
+		else if(strcmp(args[i], "-record") == 0)
+			recordFile = args[++i];
+		else if(strcmp(args[i], "-replay") == 0)
+			replayFile = args[++i];
+		else
+			fltkArgs.push_back(args[i]);
+	}
+
 	ShaderViewUI *svui = new ShaderViewUI;
+	GeoTestShaderWindow *gtsw = svui->geoTestShaderWindow;
+
+	if(replayFile != NULL){
+		if(!gtsw->startReplay(replayFile, fastReplay ? NULL : profileFile))
+			return 1;
+		if(fastReplay)
+			headlessFrames = gtsw->getReplayFrames();
+	}
+
+	if(headlessFrames > 0){
+		bool ok = gtsw->runHeadless(headlessFrames, headlessWidth, headlessHeight, profileFile, imageFile);
+		gtsw->cleanup();
+		return ok ? 0 : 1;
+	}
+
+	if(recordFile != NULL)
+		gtsw->startRecording(recordFile);
+	gtsw->setOnDemandRedraw(onDemand);
+	if(idPick)
+		gtsw->setPickMode(Gl_ShaderWindow::PICK_ID_BUFFER);
+	else if(rayPick)
+		gtsw->setPickMode(Gl_ShaderWindow::PICK_RAY);
 
 	Fl::visual(FL_DOUBLE|FL_INDEX);
-	svui->show(argc, (char**)argv);
+	svui->show((int)fltkArgs.size(), &fltkArgs[0]);
 	Fl::run();
 	return 0;
 }
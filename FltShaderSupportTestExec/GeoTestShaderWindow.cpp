@@ -27,9 +27,15 @@ void GeoTestShaderWindow::localInit(){
 	glEnable(GL_DEPTH_TEST);
 
 	gridStage = new GridStage(10.0f, 10);
-	solarSystem = new SolarSystem(GL_TEXTURE0);
+	gridStage->setPickCallback(pickCallback, this);
+	solarSystem = new SolarSystem(GL_TEXTURE0, &assetLoader);
 
 	screenRepaint = new ScreenRepaint(GL_TEXTURE1, "/shaders/texpassthrough.vs", "/shaders/gaussianGlow.fs");
+
+	// the scene owns these from here on
+	addObject(gridStage);
+	addObject(solarSystem);
+	addObject(screenRepaint, LAYER_SCREEN);
 }
 
 void GeoTestShaderWindow::resize(){
@@ -37,45 +43,36 @@ void GeoTestShaderWindow::resize(){
 }
 
 void GeoTestShaderWindow::environmentCalc(){
-	solarSystem->environmentCalc();
+	calcScene();
 }
 
 void GeoTestShaderWindow::draw(){
-	DrawableObject::PICK_RESULT pickResult;
-
 	
 		// 3D draw stuff here!
 
 	if(isPicking){
 		preDraw3D();
-			gridStage->pickRender(modelViewMatrix, projectionMatrix, shaderManager);
-			pickResult = gridStage->pickResult();
-			if(pickResult == DrawableObject::HIT)
-				printf("Gridstage Hit\n");
-			else if(pickResult == DrawableObject::MISS)
-				printf("Gridstage Miss\n");
-			else if(pickResult == DrawableObject::UNAVAILABLE)
-				printf("Gridstage Unavailable\n");
+			gridStage->pickRender(modelViewMatrix, projectionMatrix, shaderManager); // the result comes back in pickCallback()
 		postDraw3D();
 	}
 
 	preDraw3D();
-		gridStage->render(modelViewMatrix, projectionMatrix, shaderManager);
-		solarSystem->render(modelViewMatrix, projectionMatrix, shaderManager);
-
+		renderScene(LAYER_WORLD);
 	postDraw3D();
-	screenRepaint->render(modelViewMatrix, projectionMatrix, shaderManager);
+	Dprint::add("visible = %d, culled = %d", getVisibleCount(), getCulledCount());
+	renderScene(LAYER_SCREEN);
 	
 	draw2D();
 }
 
-void GeoTestShaderWindow::localCleanup(){
-	gridStage->cleanup();
-	delete(gridStage);
-
-	solarSystem->cleanup();
-	delete(solarSystem);
+// called by pollPickResults() a frame or two after the pick was drawn
+void GeoTestShaderWindow::pickCallback(DrawableObject *obj, bool hit, void *data){
+	printf("%s %s\n", obj->getName(), hit ? "Hit" : "Miss");
+}
 
-	screenRepaint->cleanup();
-	delete (screenRepaint);
+void GeoTestShaderWindow::localCleanup(){
+	// gridStage, solarSystem and screenRepaint are deleted with the rest of the scene
+	gridStage = NULL;
+	solarSystem = NULL;
+	screenRepaint = NULL;
 }
\ No newline at end of file
@@ -16,6 +16,8 @@ public:
 	virtual void localCleanup();
 
 private:
+	static void pickCallback(DrawableObject *obj, bool hit, void *data);
+
 	GridStage			*gridStage;
 	SolarSystem			*solarSystem;
 	ScreenRepaint		*screenRepaint;
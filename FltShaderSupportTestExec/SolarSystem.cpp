@@ -3,9 +3,15 @@
 
 //M3DMatrix44f		cameraMatrix;
 
-SolarSystem::SolarSystem(GLuint activeTexture) : DrawableObject(activeTexture)
+SolarSystem::SolarSystem(GLuint activeTexture, AssetLoader *loader) : DrawableObject(activeTexture)
 {
+	setName("SolarSystem");
+	assetLoader = loader;
+	setAnimating(true); // the planets orbit in environmentCalc()
+	setParallelCalc(true); // environmentCalc() only moves this object's own orbits
+	setSnapshotSafe(true); // render() only reads the orbits through getOrbitState()
 	setup();
+	publishState(); // the base class couldn't publish the orbits before they existed
 }
 
 
@@ -16,6 +22,15 @@ SolarSystem::~SolarSystem(void)
 void SolarSystem::setup()
 {
 	gltMakeSphere(sphereBatch, 1, 18, 18);
+	gltMakeSphere(sphereBatchMedium, 1, 12, 12);
+	gltMakeSphere(sphereBatchLow, 1, 6, 6);
+	sphereLod.addLevel(&sphereBatch, 80.0f);
+	sphereLod.addLevel(&sphereBatchMedium, 24.0f);
+	sphereLod.addLevel(&sphereBatchLow, 0.0f);
+	for(int i = 0; i < NUM_PLANETS; ++i){
+		reflectionLod[i] = 0;
+		planetLod[i] = 0;
+	}
 
 	// Make the solid ground
 	GLfloat texSize = 10.0f;
@@ -37,24 +52,20 @@ void SolarSystem::setup()
 	glActiveTexture(activeTextureID);
 	glGenTextures(3, uiTextures);
 	
-	
-	// Load the Marble
-	glBindTexture(GL_TEXTURE_2D, uiTextures[0]);
-	bool success = LoadTGATexture("c:/textures/Marble.tga", GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT);
-	if(!success)
-		fl_alert("Unable to load 'c:/textures/Marble.tga'");
-
-	// Load Mars
-	glBindTexture(GL_TEXTURE_2D, uiTextures[1]);
-	success = LoadTGATexture("c:/textures/SunTexture_128x128.tga", GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE);
-	if(!success)
-		fl_alert("Unable to load ''c:/textures/SunTexture_128x128.tga'");
-	
-	// Load Moon
-	glBindTexture(GL_TEXTURE_2D, uiTextures[2]);
-	success = LoadTGATexture("c:/textures/Moonlike.tga", GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE);
-	if(!success)
-		fl_alert("Unable to load 'c:/textures/Moonlike.tga'");
+	const char *texFiles[3] = {	"c:/textures/Marble.tga",			// Marble
+								"c:/textures/SunTexture_128x128.tga",	// Mars
+								"c:/textures/Moonlike.tga" };		// Moon
+	GLenum texWrap[3] = { GL_REPEAT, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+
+	for(int i = 0; i < 3; ++i){
+		if(assetLoader != NULL){
+			assetLoader->loadTexture(uiTextures[i], texFiles[i], GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, texWrap[i]);
+		}else{
+			glBindTexture(GL_TEXTURE_2D, uiTextures[i]);
+			if(!LoadTGATexture(texFiles[i], GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, texWrap[i]))
+				fl_alert("Unable to load '%s'", texFiles[i]);
+		}
+	}
 	/****/
 
 	// load the shaders
@@ -111,13 +122,45 @@ void SolarSystem::setup()
 	neptuneStep = 1.0f/neptuneDist;
 
 	timeScalar = 5.0f;
-	
+
+	mercuryNode = orbits.addNode();
+	venusNode = orbits.addNode();
+	earthNode = orbits.addNode();
+	moonNode = orbits.addNode(earthNode);
+	marsNode = orbits.addNode();
+	jupiterNode = orbits.addNode();
+	saturnNode = orbits.addNode();
+	uranusNode = orbits.addNode();
+	neptuneNode = orbits.addNode();
+	placePlanets();
+}
+
+void SolarSystem::setOrbit(int node, float angle, float dist, float size)
+{
+	M3DMatrix44f mat;
+
+	m3dScaleMatrix44(mat, size, size, size);
+	mat[12] = cos(angle)*dist;
+	mat[14] = sin(angle)*dist;
+	orbits.setLocalMatrix(node, mat);
 }
 
-void SolarSystem::drawPlanet(float angle, float dist, float size, GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager)
+void SolarSystem::placePlanets()
+{
+	setOrbit(mercuryNode, mercuryAngle, mercuryDist, 0.5f);
+	setOrbit(venusNode, venusAngle, venusDist, 0.75f);
+	setOrbit(earthNode, earthAngle, earthDist, 1.0f); // not scaled, so the moon's orbit isn't either
+	setOrbit(moonNode, -mercuryAngle, mercuryDist, 0.5f);
+	setOrbit(marsNode, marsAngle, marsDist, 0.75f);
+	setOrbit(jupiterNode, jupiterAngle, jupiterDist, 2.0f);
+	setOrbit(saturnNode, saturnAngle, saturnDist, 1.5f);
+	setOrbit(uranusNode, uranusAngle, uranusDist, 1.5f);
+	setOrbit(neptuneNode, neptuneAngle, neptuneDist, 1.75f);
+	orbits.update();
+}
+
+void SolarSystem::drawPlanet(const M3DMatrix44f world, int &lodLevel, GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager)
 {
-	float px = cos(angle)*dist;
-	float pz = sin(angle)*dist;
 	GLfloat vFloorColor[] = { 1.0f, 1.0f, 1.0f, 0.75f};
 	GLfloat vAmbientColor[] = { 0.2f, 0.2f, 0.2f, 1.0f };
 	GLfloat vDiffuseColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
@@ -135,9 +178,10 @@ void SolarSystem::drawPlanet(float angle, float dist, float size, GLMatrixStack
 
 
 	modelViewStack.PushMatrix();
-		modelViewStack.Translate(px, 0.0f, pz);
-		modelViewStack.Scale(size, size, size);		
+		modelViewStack.MultMatrix(world);
 		//modelViewStack.Rotate(angle*200.0f, 0.0f, 1.0f, 0.0f);
+		float pixels = LodChain::projectedSize(1.0f, modelViewStack.GetMatrix(), projectionStack.GetMatrix(), getViewportHeight());
+		lodLevel = sphereLod.selectLevel(pixels, lodLevel);
 		projectionStack.PushMatrix();
 			projectionStack.MultMatrix(modelViewStack.GetMatrix());
 			glBindTexture(GL_TEXTURE_2D, uiTextures[2]);
@@ -153,21 +197,29 @@ void SolarSystem::drawPlanet(float angle, float dist, float size, GLMatrixStack
 			glUniformMatrix3fv(testLocNM, 1, GL_FALSE, normal33);
 			glUniform1i(testLocTexture, 0);
 			/*****/
-			sphereBatch.Draw();
+			sphereLod.getBatch(lodLevel)->Draw();
 			glUseProgram(NULL);
 		projectionStack.PopMatrix();
 	modelViewStack.PopMatrix();
 }
 
+void SolarSystem::drawPlanets(const M3DMatrix44f *worlds, int *lodLevels, GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager)
+{
+	for(int i = 0; i < NUM_PLANETS; ++i){
+		drawPlanet(worlds[i], lodLevels[i], modelViewStack, projectionStack, shaderManager);
+	}
+}
+
 void SolarSystem::render(GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager)
 {
 	float px;
 	float pz;
 	float dissolveFactor;
+	const OrbitState &state = getOrbitState();
 
-	dissolveFactor = (sin(earthAngle)+1.0f)*0.5f;
-	px = cos(earthAngle)*earthDist;
-	pz = sin(earthAngle)*earthDist;
+	dissolveFactor = (sin(state.earthAngle)+1.0f)*0.5f;
+	px = cos(state.earthAngle)*earthDist;
+	pz = sin(state.earthAngle)*earthDist;
 	GLfloat vEyeLight[] = { px, 3.0, pz, 1.0 };
 	GLfloat vFloorColor[] = { 1.0f, 1.0f, 1.0f, 0.75f};
 	GLfloat vAmbientColor[] = { 0.2f, 0.2f, 0.2f, 0.75f };
@@ -202,20 +254,7 @@ void SolarSystem::render(GLMatrixStack &modelViewStack, GLMatrixStack &projectio
 				projectionStack.PopMatrix();
 			modelViewStack.PopMatrix();
 		 
-			drawPlanet(mercuryAngle, mercuryDist, 0.5f, modelViewStack, projectionStack, shaderManager);
-			drawPlanet(venusAngle, venusDist, 0.75f, modelViewStack, projectionStack, shaderManager);
-			drawPlanet(earthAngle, earthDist, 1.0f, modelViewStack, projectionStack, shaderManager);
-			// draw the moon
-			modelViewStack.PushMatrix();
-				modelViewStack.Translate(px, 0.0f, pz);
-				drawPlanet(-mercuryAngle, mercuryDist, 0.5f, modelViewStack, projectionStack, shaderManager);
-			modelViewStack.PopMatrix();
-
-			drawPlanet(marsAngle, marsDist, 0.75f, modelViewStack, projectionStack, shaderManager);
-			drawPlanet(jupiterAngle, jupiterDist, 2.0f, modelViewStack, projectionStack, shaderManager);
-			drawPlanet(saturnAngle, saturnDist, 1.5f, modelViewStack, projectionStack, shaderManager);
-			drawPlanet(uranusAngle, uranusDist, 1.5f, modelViewStack, projectionStack, shaderManager);
-			drawPlanet(neptuneAngle, neptuneDist, 1.75f, modelViewStack, projectionStack, shaderManager);
+			drawPlanets(state.worldMatrices, reflectionLod, modelViewStack, projectionStack, shaderManager);
 		modelViewStack.PopMatrix();	
 		
 		// Draw the solid ground
@@ -255,20 +294,7 @@ void SolarSystem::render(GLMatrixStack &modelViewStack, GLMatrixStack &projectio
 		modelViewStack.PopMatrix();
 
 		 
-		drawPlanet(mercuryAngle, mercuryDist, 0.5f, modelViewStack, projectionStack, shaderManager);
-		drawPlanet(venusAngle, venusDist, 0.75f, modelViewStack, projectionStack, shaderManager);
-		drawPlanet(earthAngle, earthDist, 1.0f, modelViewStack, projectionStack, shaderManager);
-		// draw the moon
-		modelViewStack.PushMatrix();
-			modelViewStack.Translate(px, 0.0f, pz);
-			drawPlanet(-mercuryAngle, mercuryDist, 0.5f, modelViewStack, projectionStack, shaderManager);
-		modelViewStack.PopMatrix();
-
-		drawPlanet(marsAngle, marsDist, 0.75f, modelViewStack, projectionStack, shaderManager);
-		drawPlanet(jupiterAngle, jupiterDist, 2.0f, modelViewStack, projectionStack, shaderManager);
-		drawPlanet(saturnAngle, saturnDist, 1.5f, modelViewStack, projectionStack, shaderManager);
-		drawPlanet(uranusAngle, uranusDist, 1.5f, modelViewStack, projectionStack, shaderManager);
-		drawPlanet(neptuneAngle, neptuneDist, 1.75f, modelViewStack, projectionStack, shaderManager);
+		drawPlanets(state.worldMatrices, planetLod, modelViewStack, projectionStack, shaderManager);
 	modelViewStack.PopMatrix();
 
 }
@@ -284,6 +310,35 @@ void SolarSystem::environmentCalc()
 	saturnAngle += saturnStep*deltaTime*timeScalar;
 	uranusAngle += uranusStep*deltaTime*timeScalar;
 	neptuneAngle += neptuneStep*deltaTime*timeScalar;
+	placePlanets();
+}
+
+// copies what render() reads into the buffer, on the simulation thread
+void SolarSystem::publishLocalState()
+{
+	copyOrbits(orbitBuffer.writeBuffer());
+	orbitBuffer.publish();
+}
+
+// takes the angle and the planets' world matrices out of the live orbits
+void SolarSystem::copyOrbits(OrbitState &state)
+{
+	const int nodes[NUM_PLANETS] = {mercuryNode, venusNode, earthNode, moonNode, marsNode, jupiterNode, saturnNode, uranusNode, neptuneNode};
+
+	state.earthAngle = earthAngle;
+	for(int i = 0; i < NUM_PLANETS; ++i)
+		m3dCopyMatrix44(state.worldMatrices[i], orbits.getWorldMatrix(nodes[i]));
+}
+
+// the newest published orbits when the simulation has its own thread, otherwise the live ones
+const SolarSystem::OrbitState& SolarSystem::getOrbitState()
+{
+	if(isUsingSnapshots()){
+		orbitBuffer.update();
+		return orbitBuffer.readBuffer();
+	}
+	copyOrbits(liveOrbits);
+	return liveOrbits;
 }
 
 void SolarSystem::localCleanup(){
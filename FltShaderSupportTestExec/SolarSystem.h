@@ -1,22 +1,32 @@
 #pragma once
 #include "drawableobject.h"
+#include "AssetLoader.h"
+#include "TransformHierarchy.h"
 class SolarSystem :
 	public DrawableObject
 {
 public:
-	SolarSystem(GLuint activeTexture);
+	SolarSystem(GLuint activeTexture, AssetLoader *loader = NULL);
 	~SolarSystem(void);
 	void setup();
 	void render(GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager);
 	void environmentCalc();
-	void drawPlanet(float angle, float dist, float size, GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager);
+	void drawPlanet(const M3DMatrix44f world, int &lodLevel, GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager);
+	void drawPlanets(const M3DMatrix44f *worlds, int *lodLevels, GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager);
 	void localCleanup();
 
+protected:
+	void publishLocalState();
+
 private:
 	GLTriangleBatch     sphereBatch;
+	GLTriangleBatch     sphereBatchMedium;
+	GLTriangleBatch     sphereBatchLow;
+	LodChain			sphereLod;			// sphereBatch, then the medium and low ones, for the planets
 	GLBatch				floorBatch;
 	M3DMatrix44f		cameraMatrix;
 	GLuint				uiTextures[3];
+	AssetLoader			*assetLoader;		// if not NULL, textures are loaded in the background
 
 	GLuint	flatShader;
 	GLint	flatLocMVP;				// The location of the ModelViewProjection matrix uniform
@@ -67,5 +77,36 @@ private:
 	float neptuneDist;
 
 	float timeScalar;
+
+	// where each body is, relative to the sun. The moon is a child of the earth
+	void setOrbit(int node, float angle, float dist, float size);
+	void placePlanets();
+	TransformHierarchy	orbits;
+	int					mercuryNode;
+	int					venusNode;
+	int					earthNode;
+	int					moonNode;
+	int					marsNode;
+	int					jupiterNode;
+	int					saturnNode;
+	int					uranusNode;
+	int					neptuneNode;
+
+	// the level of detail each planet was drawn at, in the reflection and above the floor
+	static const int	NUM_PLANETS = 9;
+	int					reflectionLod[NUM_PLANETS];
+	int					planetLod[NUM_PLANETS];
+
+	// what render() reads of the orbits, handed over from the simulation thread when there is one.
+	// The world matrices are in drawPlanets() order
+	struct OrbitState
+	{
+		float earthAngle;
+		M3DMatrix44f worldMatrices[NUM_PLANETS];
+	};
+	TripleBuffer<OrbitState> orbitBuffer;
+	OrbitState liveOrbits;
+	void copyOrbits(OrbitState &state);
+	const OrbitState& getOrbitState();
 };
 
@@ -0,0 +1,402 @@
+#include "StdAfx.h"
+#include "AssetLoader.h"
+#include "GLCapabilities.h"
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+// mid grey, so that a texture that hasn't arrived yet doesn't stand out
+static const GLubyte placeholderTexel[4] = {128, 128, 128, 255};
+
+static bool isMipmapFilter(GLenum filter){
+	return filter == GL_LINEAR_MIPMAP_LINEAR ||
+		filter == GL_LINEAR_MIPMAP_NEAREST ||
+		filter == GL_NEAREST_MIPMAP_LINEAR ||
+		filter == GL_NEAREST_MIPMAP_NEAREST;
+}
+
+// gltReadTGABits() hands back the internal format as 'components', so the
+// client-side size has to come from the pixel format it reports alongside it
+static int bytesPerPixel(GLenum format){
+	switch(format){
+	case GL_LUMINANCE:
+		return 1;
+	case GL_LUMINANCE_ALPHA:
+		return 2;
+	case GL_BGR:
+	case GL_RGB:
+		return 3;
+	default:
+		return 4;
+	}
+}
+
+/**
+ * @fn	AssetLoader::AssetLoader(void)
+ *
+ * @brief	Constructor. No threads are started until the first request
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+AssetLoader::AssetLoader(void)
+{
+	InitializeCriticalSection(&loadLock);
+	InitializeCriticalSection(&uploadLock);
+	wakeSemaphore = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+
+	numThreads = 2; // reading files is mostly waiting on the disk, so a couple of threads is plenty
+	quit = 0;
+	numPending = 0;
+	numFailed = 0;
+
+	memset(pbos, 0, sizeof(pbos));
+	nextPbo = 0;
+	usePbos = true;
+}
+
+AssetLoader::~AssetLoader(void)
+{
+	stopThreads();
+	while(!loadQueue.empty()){
+		free(loadQueue.front()->pixels);
+		delete loadQueue.front();
+		loadQueue.pop_front();
+	}
+	while(!uploadQueue.empty()){
+		free(uploadQueue.front()->pixels);
+		delete uploadQueue.front();
+		uploadQueue.pop_front();
+	}
+	CloseHandle(wakeSemaphore);
+	DeleteCriticalSection(&loadLock);
+	DeleteCriticalSection(&uploadLock);
+}
+
+/**
+ * @fn	void AssetLoader::loadTexture(GLuint textureId, const char *fileName, GLenum minFilter,
+ * 		GLenum magFilter, GLenum wrapMode)
+ *
+ * @brief	Gives textureId a placeholder texel now, and queues the tga file to be read and uploaded
+ * 			into it.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	textureId	A texture name from glGenTextures().
+ * @param	fileName 	Filename of the tga file.
+ * @param	minFilter	e.g. GL_LINEAR_MIPMAP_LINEAR.
+ * @param	magFilter	e.g. GL_LINEAR.
+ * @param	wrapMode 	The wrap mode (e.g. GL_REPEAT).
+ */
+void AssetLoader::loadTexture(GLuint textureId, const char *fileName, GLenum minFilter, GLenum magFilter, GLenum wrapMode){
+	Request *req = new Request;
+	req->textureId = textureId;
+	req->fileName = fileName;
+	req->minFilter = minFilter;
+	req->magFilter = magFilter;
+	req->wrapMode = wrapMode;
+	req->pixels = NULL;
+	req->width = req->height = req->components = 0;
+	req->format = GL_RGB;
+	req->load = NULL;
+	req->upload = NULL;
+	req->data = NULL;
+
+	// the placeholder has no mipmaps, so it needs a non-mipmap filter to be complete
+	glBindTexture(GL_TEXTURE_2D, textureId);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderTexel);
+
+	submit(req);
+}
+
+/**
+ * @fn	void AssetLoader::queueTask(TaskFunction load, TaskFunction upload, void *data)
+ *
+ * @brief	Queues a generic asset. 'load' is run on a worker thread, then 'upload' on the render
+ * 			thread during update().
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	load		 	The worker thread step.
+ * @param	upload		 	The render thread step.
+ * @param [in,out]	data	Passed through to both functions.
+ */
+void AssetLoader::queueTask(TaskFunction load, TaskFunction upload, void *data){
+	Request *req = new Request;
+	req->textureId = 0;
+	req->minFilter = req->magFilter = req->wrapMode = 0;
+	req->pixels = NULL;
+	req->width = req->height = req->components = 0;
+	req->format = 0;
+	req->load = load;
+	req->upload = upload;
+	req->data = data;
+
+	submit(req);
+}
+
+/**
+ * @fn	void AssetLoader::submit(Request *req)
+ *
+ * @brief	Hands a request to the workers
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	req	The request.
+ */
+void AssetLoader::submit(Request *req){
+	startThreads();
+	InterlockedIncrement(&numPending);
+
+	EnterCriticalSection(&loadLock);
+	loadQueue.push_back(req);
+	LeaveCriticalSection(&loadLock);
+	ReleaseSemaphore(wakeSemaphore, 1, NULL);
+}
+
+/**
+ * @fn	int AssetLoader::update(float budgetMs)
+ *
+ * @brief	Does the GL side of any assets that have finished loading, until the budget is used up.
+ * 			At least one asset is always done, so that loading can't stall.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	budgetMs	The time to spend, in milliseconds.
+ *
+ * @return	The number of assets uploaded.
+ */
+int AssetLoader::update(float budgetMs){
+	Request *req;
+	int count = 0;
+
+	if(numPending == 0)
+		return 0;
+
+	budgetWatch.Reset();
+	while(count == 0 || budgetWatch.GetElapsedSeconds()*1000.0f < budgetMs){
+		EnterCriticalSection(&uploadLock);
+		if(uploadQueue.empty()){
+			LeaveCriticalSection(&uploadLock);
+			break;
+		}
+		req = uploadQueue.front();
+		uploadQueue.pop_front();
+		LeaveCriticalSection(&uploadLock);
+
+		if(req->textureId != 0)
+			uploadTexture(req);
+		else if(req->upload != NULL)
+			req->upload(req->data);
+
+		delete req;
+		InterlockedDecrement(&numPending);
+		++count;
+	}
+	return count;
+}
+
+/**
+ * @fn	void AssetLoader::uploadTexture(Request *req)
+ *
+ * @brief	Copies the decoded pixels into a pixel buffer and from there into the texture. The texture
+ * 			uses the tga's own internal format rather than asking the driver to compress it, since
+ * 			compressing is done on the CPU inside glTexImage2D() and would blow the budget.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	req	The request.
+ */
+void AssetLoader::uploadTexture(Request *req){
+	const GLvoid *src = req->pixels;
+	GLsizeiptr size;
+	void *dst;
+
+	if(req->pixels == NULL){
+		fprintf(stderr, "AssetLoader::uploadTexture() unable to load '%s'. Make sure RLE is off!\n", req->fileName.c_str());
+		++numFailed;
+		return;
+	}
+
+	if(usePbos && pbos[0] == 0){
+		usePbos = GLCapabilities::isVersion(2, 1) || GLCapabilities::hasExtension("GL_ARB_pixel_buffer_object");
+		if(usePbos)
+			glGenBuffers(NUM_PBOS, pbos);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, req->textureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if(usePbos){
+		size = req->width*req->height*bytesPerPixel(req->format);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[nextPbo]);
+		nextPbo = (nextPbo + 1) % NUM_PBOS;
+
+		// re-specifying the storage orphans whatever the buffer held last, so mapping it doesn't wait
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+		dst = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+		if(dst != NULL){
+			memcpy(dst, req->pixels, size);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			src = NULL; // offset into the bound buffer
+		}else{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+	}
+
+	glTexImage2D(GL_TEXTURE_2D, 0, req->components, req->width, req->height, 0,
+		req->format, GL_UNSIGNED_BYTE, src);
+	if(usePbos)
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	free(req->pixels);
+	req->pixels = NULL;
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, req->minFilter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, req->magFilter);
+	if(isMipmapFilter(req->minFilter))
+		glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+/**
+ * @fn	void AssetLoader::finish()
+ *
+ * @brief	Blocks until everything that has been requested is uploaded, ignoring the budget. Useful
+ * 			when every frame must look the same from the start, e.g. in headless benchmark runs.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void AssetLoader::finish(){
+	while(numPending > 0){
+		if(update(1000.0f) == 0)
+			Sleep(1);
+	}
+}
+
+/**
+ * @fn	void AssetLoader::startThreads()
+ *
+ * @brief	Starts the worker threads if they aren't already running
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void AssetLoader::startThreads(){
+	HANDLE thread;
+
+	if(!threads.empty())
+		return;
+
+	quit = 0;
+	for(int i = 0; i < numThreads; ++i){
+		thread = CreateThread(NULL, 0, workerProc, this, 0, NULL);
+		if(thread == NULL)
+			fprintf(stderr, "AssetLoader::startThreads() CreateThread failed: %d\n", GetLastError());
+		else
+			threads.push_back(thread);
+	}
+}
+
+/**
+ * @fn	void AssetLoader::stopThreads()
+ *
+ * @brief	Stops and waits for the worker threads. A worker finishes the file it is reading first.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void AssetLoader::stopThreads(){
+	if(threads.empty())
+		return;
+
+	InterlockedExchange(&quit, 1);
+	ReleaseSemaphore(wakeSemaphore, (LONG)threads.size(), NULL);
+	for(unsigned int i = 0; i < threads.size(); ++i){
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	}
+	threads.clear();
+}
+
+/**
+ * @fn	DWORD WINAPI AssetLoader::workerProc(LPVOID data)
+ *
+ * @brief	The worker thread's loop: take a request, load it, pass it to the completed queue
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	data	pointer to the AssetLoader
+ *
+ * @return	0 when the thread exits
+ */
+DWORD WINAPI AssetLoader::workerProc(LPVOID data){
+	AssetLoader *loader = (AssetLoader*)data;
+	Request *req;
+
+	while(true){
+		WaitForSingleObject(loader->wakeSemaphore, INFINITE);
+		if(loader->quit != 0)
+			break;
+
+		EnterCriticalSection(&loader->loadLock);
+		if(loader->loadQueue.empty()){
+			LeaveCriticalSection(&loader->loadLock);
+			continue;
+		}
+		req = loader->loadQueue.front();
+		loader->loadQueue.pop_front();
+		LeaveCriticalSection(&loader->loadLock);
+
+		if(req->textureId != 0)
+			req->pixels = gltReadTGABits(req->fileName.c_str(), &req->width, &req->height, &req->components, &req->format);
+		else if(req->load != NULL)
+			req->load(req->data);
+
+		EnterCriticalSection(&loader->uploadLock);
+		loader->uploadQueue.push_back(req);
+		LeaveCriticalSection(&loader->uploadLock);
+	}
+	return 0;
+}
+
+/**
+ * @fn	void AssetLoader::cleanup()
+ *
+ * @brief	Stops the worker threads, throws away anything still pending and deletes the pixel buffers.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void AssetLoader::cleanup(){
+	stopThreads();
+
+	while(!loadQueue.empty()){
+		delete loadQueue.front();
+		loadQueue.pop_front();
+	}
+	while(!uploadQueue.empty()){
+		free(uploadQueue.front()->pixels);
+		delete uploadQueue.front();
+		uploadQueue.pop_front();
+	}
+	numPending = 0;
+
+	if(pbos[0] != 0){
+		glDeleteBuffers(NUM_PBOS, pbos);
+		memset(pbos, 0, sizeof(pbos));
+	}
+	nextPbo = 0;
+	usePbos = true;
+}
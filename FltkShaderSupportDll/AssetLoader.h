@@ -0,0 +1,287 @@
+#pragma once
+
+#include <windows.h>
+#include <GLTools.h>	// OpenGL toolkit
+#include <StopWatch.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class	AssetLoader
+ *
+ * @brief	Loads assets in the background so that a scene with hundreds of textures doesn't freeze the
+ * 			window while it starts. File reads and decoding happen on a small pool of worker threads; the
+ * 			GL work (which has to be done on the thread that owns the context) is queued back and done by
+ * 			update(), which the render thread calls once a frame with a time budget.
+ *
+ * 			Textures are given a 1x1 placeholder texel as soon as they are requested, so they can be bound
+ * 			and drawn right away. The decoded pixels are uploaded through a pixel buffer object, so that
+ * 			glTexImage2D() returns without waiting for the copy to the card.
+ *
+ * 			Other assets (e.g. meshes) are loaded with queueTask(): the load function runs on a worker,
+ * 			and the upload function runs on the render thread inside the same budget.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class AssetLoader
+{
+public:
+
+	/**
+	 * @brief	A step of a queued task. Load functions run on a worker thread and must not make GL calls;
+	 * 			upload functions run on the render thread.
+	 */
+	typedef void (*TaskFunction)(void *data);
+
+	/**
+	 * @fn	AssetLoader::AssetLoader(void);
+	 *
+	 * @brief	Constructor. No threads are started until the first request
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	AssetLoader(void);
+
+	/**
+	 * @fn	AssetLoader::~AssetLoader(void);
+	 *
+	 * @brief	Destructor. Stops the worker threads
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~AssetLoader(void);
+
+	/**
+	 * @fn	void AssetLoader::loadTexture(GLuint textureId, const char *fileName, GLenum minFilter,
+	 * 		GLenum magFilter, GLenum wrapMode);
+	 *
+	 * @brief	Gives textureId a placeholder texel now, and queues the tga file to be read and uploaded
+	 * 			into it. Must be called from the render thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	textureId	A texture name from glGenTextures().
+	 * @param	fileName 	Filename of the tga file.
+	 * @param	minFilter	e.g. GL_LINEAR_MIPMAP_LINEAR.
+	 * @param	magFilter	e.g. GL_LINEAR.
+	 * @param	wrapMode 	The wrap mode (e.g. GL_REPEAT).
+	 */
+	void loadTexture(GLuint textureId, const char *fileName, GLenum minFilter, GLenum magFilter, GLenum wrapMode);
+
+	/**
+	 * @fn	void AssetLoader::queueTask(TaskFunction load, TaskFunction upload, void *data);
+	 *
+	 * @brief	Queues a generic asset. 'load' is run on a worker thread, then 'upload' on the render
+	 * 			thread during update(). Either may be NULL. The caller owns data, which must stay valid
+	 * 			until upload has run.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	load		 	The worker thread step.
+	 * @param	upload		 	The render thread step.
+	 * @param [in,out]	data	Passed through to both functions.
+	 */
+	void queueTask(TaskFunction load, TaskFunction upload, void *data);
+
+	/**
+	 * @fn	int AssetLoader::update(float budgetMs);
+	 *
+	 * @brief	Does the GL side of any assets that have finished loading, until the budget is used up.
+	 * 			At least one asset is always done, so that loading can't stall. Must be called from the
+	 * 			render thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	budgetMs	The time to spend, in milliseconds.
+	 *
+	 * @return	The number of assets uploaded.
+	 */
+	int update(float budgetMs);
+
+	/**
+	 * @fn	void AssetLoader::finish();
+	 *
+	 * @brief	Blocks until everything that has been requested is uploaded, ignoring the budget. Must be
+	 * 			called from the render thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void finish();
+
+	/**
+	 * @fn	int AssetLoader::getNumPending();
+	 *
+	 * @brief	Gets the number of requests that have not been uploaded yet.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of pending requests.
+	 */
+	int getNumPending(){	return (int)numPending;	};
+
+	/**
+	 * @fn	int AssetLoader::getNumFailed()
+	 *
+	 * @brief	Gets the number of textures that could not be read, and so kept their placeholder.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of failed loads.
+	 */
+	int getNumFailed(){	return numFailed;	};
+
+	/**
+	 * @fn	void AssetLoader::setNumThreads(int threads)
+	 *
+	 * @brief	Sets the number of worker threads. Only has an effect before the first request
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	threads	The number of threads.
+	 */
+	void setNumThreads(int threads){	numThreads = (threads < 1) ? 1 : threads;	};
+
+	/**
+	 * @fn	void AssetLoader::cleanup();
+	 *
+	 * @brief	Stops the worker threads, throws away anything still pending and deletes the pixel buffers.
+	 * 			Must be called from the render thread while the context is current.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void cleanup();
+
+protected:
+
+	/**
+	 * @struct	Request
+	 *
+	 * @brief	One asset on its way through the loader
+	 */
+	struct Request
+	{
+		// texture requests
+		GLuint			textureId;
+		string			fileName;
+		GLenum			minFilter;
+		GLenum			magFilter;
+		GLenum			wrapMode;
+		GLbyte			*pixels;	// from gltReadTGABits(), NULL if the read failed
+		int				width;
+		int				height;
+		int				components;
+		GLenum			format;
+
+		// generic requests
+		TaskFunction	load;
+		TaskFunction	upload;
+		void			*data;
+	};
+
+	/**
+	 * @fn	void AssetLoader::startThreads();
+	 *
+	 * @brief	Starts the worker threads if they aren't already running
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void startThreads();
+
+	/**
+	 * @fn	void AssetLoader::stopThreads();
+	 *
+	 * @brief	Stops and waits for the worker threads
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void stopThreads();
+
+	/**
+	 * @fn	void AssetLoader::submit(Request *req);
+	 *
+	 * @brief	Hands a request to the workers
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	req	The request.
+	 */
+	void submit(Request *req);
+
+	/**
+	 * @fn	static DWORD WINAPI AssetLoader::workerProc(LPVOID data);
+	 *
+	 * @brief	The worker thread's loop: take a request, load it, pass it to the completed queue
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	data	pointer to the AssetLoader
+	 *
+	 * @return	0 when the thread exits
+	 */
+	static DWORD WINAPI workerProc(LPVOID data);
+
+	/**
+	 * @fn	void AssetLoader::uploadTexture(Request *req);
+	 *
+	 * @brief	Copies the decoded pixels into a pixel buffer and from there into the texture
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	req	The request.
+	 */
+	void uploadTexture(Request *req);
+
+	/**
+	 * @summary	Requests waiting for a worker, guarded by loadLock
+	 */
+	deque<Request*> loadQueue;
+
+	/**
+	 * @summary	Requests waiting for the render thread, guarded by uploadLock
+	 */
+	deque<Request*> uploadQueue;
+
+	CRITICAL_SECTION loadLock;
+	CRITICAL_SECTION uploadLock;
+
+	/**
+	 * @summary	Signalled once for every request queued, to wake a worker
+	 */
+	HANDLE wakeSemaphore;
+
+	vector<HANDLE> threads;
+	int numThreads;
+	volatile LONG quit;
+	volatile LONG numPending;
+	int numFailed;
+
+	/**
+	 * @summary	Pixel unpack buffers, used round robin so that an upload doesn't wait on the last one
+	 */
+	static const int NUM_PBOS = 4;
+	GLuint pbos[NUM_PBOS];
+	int nextPbo;
+	bool usePbos;
+
+	CStopWatch budgetWatch;
+};
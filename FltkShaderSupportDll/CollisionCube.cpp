@@ -7,6 +7,7 @@
 
 CollisionCube::CollisionCube(GLuint activeTexture, float xsize, float ysize, float zsize): CollisionCubeBase(activeTexture, xsize, ysize, zsize)
 {
+	setName("CollisionCube");
 	setup();
 }
 
@@ -114,16 +115,14 @@ void CollisionCube::drawPrimitive(GLBatch &batch, const GLfloat *vColor, const M
 
 void CollisionCube::render(GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager){
 	
-	Dprint::add("CollisionCube position = (%.2f, %.2f, %.2f)", position[0], position[1], position[2]);
-	Dprint::add("CollisionCube orientation = (%.2f, %.2f, %.2f)", orientation[0], orientation[1], orientation[2]);
 	const M3DMatrix44f &mCamera = modelViewStack.GetMatrix(); // need this for reflection vectors to work
 
+	const DrawableState &state = getRenderState();
+	Dprint::add("CollisionCube position = (%.2f, %.2f, %.2f)", state.position[0], state.position[1], state.position[2]);
+	Dprint::add("CollisionCube orientation = (%.2f, %.2f, %.2f)", state.orientation[0], state.orientation[1], state.orientation[2]);
+
 	modelViewStack.PushMatrix();
-		//modelViewStack.Translate(position[0] + size[0]*0.5f, position[1] + size[1]*0.5f, position[2] + size[2]*0.5f);
-		modelViewStack.Translate(position[0], position[1], position[2]);
-		modelViewStack.Rotate(orientation[1], 0.0f, 1.0f, 0.0f);
-		modelViewStack.Rotate(orientation[2], 1.0f, 0.0f, 0.0f);
-		modelViewStack.Scale(size[0], size[1], size[2]);
+		modelViewStack.MultMatrix(getModelMatrix(state));
 		drawPrimitive(cubeBatch, vGray, mCamera, modelViewStack, projectionStack);
 	modelViewStack.PopMatrix();
 }
@@ -1,5 +1,6 @@
 #include "StdAfx.h"
 #include "CollisionCubeBase.h"
+#include "RayCaster.h"
 
 
 CollisionCubeBase::CollisionCubeBase(GLuint activeTexture, float xsize, float ysize, float zsize): DrawableObject(activeTexture)
@@ -16,6 +17,10 @@ CollisionCubeBase::CollisionCubeBase(GLuint activeTexture, float xsize, float ys
 	orientation[1] = 0.0f;
 	orientation[2] = 0.0f;
 
+	setAnimating(true); // spins in environmentCalc()
+	setSnapshotSafe(true); // the subclasses draw from getRenderState()
+	setParallelCalc(true); // environmentCalc() only touches this cube
+
 	// since glut cube draws centered our position is minus size/2
 	boundingSphereRadius = sqrt(SQR(size[0]*0.5f)+SQR(size[1]*0.5f)+SQR(size[2]*0.5f) );
 
@@ -26,6 +31,8 @@ CollisionCubeBase::CollisionCubeBase(GLuint activeTexture, float xsize, float ys
 	maxAARB[0] = position[0] + size[0]*0.5f;
 	maxAARB[1] = position[1] + size[1]*0.5f;
 	maxAARB[2] = position[2] + size[2]*0.5f;
+
+	rigidMatrixValid = false; // built on first use
 }
 
 
@@ -46,25 +53,53 @@ void CollisionCubeBase::environmentCalc(){
 	calcDeltaTime();
 	orientation[1] += deltaTime * scalar;
 	orientation[2] += deltaTime * scalar;
-	Dprint::add("deltatTime = %.2f, scalar = %.2f, cube angle = %.2f", orientation[1]);
+	setTransformDirty();
+	// Dprint is drawn on the render thread, so the angle is printed from render() instead
 }
 
-float CollisionCubeBase::testSphereAABBCollision(){
-	modelStack.LoadIdentity();
-	// build the inverse of the matrix that we used to draw the cube. Don't invert scale, because this has to handle a sphere test
-	// we can do this because the scale is really only used to make the glutCube the size we want to draw.
-	modelStack.Rotate(-orientation[2], 1.0f, 0.0f, 0.0f);
-	modelStack.Rotate(-orientation[1], 0.0f, 1.0f, 0.0f);
-	modelStack.Translate(-position[0], -position[1], -position[2]);
+void CollisionCubeBase::buildModelMatrix(const DrawableState &state, M3DMatrix44f mat){
+	composeTransform(mat, state.position, state.orientation, size[0], size[1], size[2]);
+}
 
+const M3DMatrix44f& CollisionCubeBase::getRigidMatrix(){
+	bool stale = !rigidMatrixValid;
+
+	for(int i = 0; i < 3 && !stale; ++i){
+		stale = position[i] != rigidPosition[i] || orientation[i] != rigidOrientation[i];
+	}
+	if(stale){
+		composeTransform(rigidMatrix, position, orientation, 1.0f, 1.0f, 1.0f);
+
+		// the inverse of a rotation is its transpose, and the translation is undone in the rotated frame
+		for(int col = 0; col < 3; ++col){
+			for(int row = 0; row < 3; ++row){
+				inverseRigidMatrix[col*4 + row] = rigidMatrix[row*4 + col];
+			}
+		}
+		for(int row = 0; row < 3; ++row){
+			inverseRigidMatrix[12 + row] = -(inverseRigidMatrix[row]*position[0] + inverseRigidMatrix[4 + row]*position[1] + inverseRigidMatrix[8 + row]*position[2]);
+		}
+		inverseRigidMatrix[3] = inverseRigidMatrix[7] = inverseRigidMatrix[11] = 0.0f;
+		inverseRigidMatrix[15] = 1.0f;
+
+		for(int i = 0; i < 3; ++i){
+			rigidPosition[i] = position[i];
+			rigidOrientation[i] = orientation[i];
+		}
+		rigidMatrixValid = true;
+	}
+	return rigidMatrix;
+}
 
-	// now translate the test point into this space
-	collisionStack.LoadIdentity();
-	collisionStack.Translate(collisionPoint[0], collisionPoint[1], collisionPoint[2]);		
+const M3DMatrix44f& CollisionCubeBase::getInverseRigidMatrix(){
+	getRigidMatrix(); // brings both up to date
+	return inverseRigidMatrix;
+}
 
-	modelStack.MultMatrix(collisionStack.GetMatrix());
-	modelStack.GetMatrix(matrix);
-	setPosFromMatrix(xformed);
+float CollisionCubeBase::testSphereAABBCollision(){
+	// take the test point into the cube's space with the inverse of the matrix that we used to draw the cube. It has no scale,
+	// because this has to handle a sphere test. We can do this because the scale is really only used to make the glutCube the size we want to draw.
+	m3dTransformVector3(xformed, collisionPoint, getInverseRigidMatrix());
 	
 	float hit = aabbSphereIntersect(minAARB, maxAARB, xformed, collisionRadius);
 
@@ -72,4 +107,59 @@ float CollisionCubeBase::testSphereAABBCollision(){
 	//Dprint::add("sphere: (%.2f, %.2f, %.2f), xformed: (%.2f, %.2f, %.2f)", collisionPoint[0], collisionPoint[1], collisionPoint[2], xformed[0], xformed[1], xformed[2]);
 	//Dprint::add("hit = %.2f", hit);
 	return hit;
-}
\ No newline at end of file
+}
+
+// the same inverse transform as testSphereAABBCollision(), built here rather than taken from
+// getInverseRigidMatrix() so that picks from another thread don't race the simulation rebuilding it. Rotating doesn't change lengths, so the distance
+// along the local ray is the distance along the world one
+bool CollisionCubeBase::rayIntersect(const M3DVector3f origin, const M3DVector3f dir, float &distance){
+	M3DMatrix44f rotX, rotY, inverse;
+	M3DVector4f from, to;
+	M3DVector3f localOrigin, localDir;
+
+	if(!RayCaster::raySphere(origin, dir, position, boundingSphereRadius, distance))
+		return false;
+
+	m3dRotationMatrix44(rotX, degToRad(-orientation[2]), 1.0f, 0.0f, 0.0f);
+	m3dRotationMatrix44(rotY, degToRad(-orientation[1]), 0.0f, 1.0f, 0.0f);
+	m3dMatrixMultiply44(inverse, rotX, rotY);
+
+	from[0] = origin[0] - position[0];
+	from[1] = origin[1] - position[1];
+	from[2] = origin[2] - position[2];
+	from[3] = 1.0f;
+	m3dTransformVector4(to, from, inverse);
+	m3dLoadVector3(localOrigin, to[0], to[1], to[2]);
+
+	from[0] = dir[0];
+	from[1] = dir[1];
+	from[2] = dir[2];
+	from[3] = 0.0f;
+	m3dTransformVector4(to, from, inverse);
+	m3dLoadVector3(localDir, to[0], to[1], to[2]);
+
+	return RayCaster::rayAABB(localOrigin, localDir, minAARB, maxAARB, distance);
+}
+
+// the rotated box, boxed again (Arvo, "Transforming Axis-Aligned Bounding Boxes"). The inverse rotation is built as rayIntersect() builds it,
+// and its transpose is the forward one, so each world axis reaches as far as the local half sizes times the absolute values along that row
+bool CollisionCubeBase::getWorldBounds(float boxMin[3], float boxMax[3]){
+	M3DMatrix44f rotX, rotY, inverse;
+
+	m3dRotationMatrix44(rotX, degToRad(-orientation[2]), 1.0f, 0.0f, 0.0f);
+	m3dRotationMatrix44(rotY, degToRad(-orientation[1]), 0.0f, 1.0f, 0.0f);
+	m3dMatrixMultiply44(inverse, rotX, rotY);
+
+	for(int i = 0; i < 3; ++i){
+		float center = position[i];
+		float extent = 0.0f;
+		for(int j = 0; j < 3; ++j){
+			float half = (maxAARB[j] - minAARB[j])*0.5f;
+			center += inverse[i*4 + j]*(maxAARB[j] + minAARB[j])*0.5f;
+			extent += fabs(inverse[i*4 + j])*half;
+		}
+		boxMin[i] = center - extent;
+		boxMax[i] = center + extent;
+	}
+	return true;
+}
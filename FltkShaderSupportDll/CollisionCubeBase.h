@@ -12,6 +12,8 @@ public:
 	virtual void environmentCalc();
 	virtual void localCleanup()=0;
 	float testSphereAABBCollision();
+	virtual bool rayIntersect(const M3DVector3f origin, const M3DVector3f dir, float &distance);
+	virtual bool getWorldBounds(float boxMin[3], float boxMax[3]);
 
 protected:
 	float size[3];
@@ -21,8 +23,20 @@ protected:
 	float				angle;
 	GLBatch             cubeBatch;
 
-	// collision detection
-	GLMatrixStack		modelStack;
-	GLMatrixStack		collisionStack;
+	// the glut cube is a unit cube, so it is scaled by size rather than the scalar (which is the spin rate)
+	virtual void buildModelMatrix(const DrawableState &state, M3DMatrix44f mat);
+
+	// the position and rotation of the simulation state without any scale, and its inverse, for the
+	// collision tests that work in the cube's own space. Simulation thread only
+	const M3DMatrix44f& getRigidMatrix();
+	const M3DMatrix44f& getInverseRigidMatrix();
+
+private:
+	// the rigid matrices are rebuilt whenever the position or orientation differ from these
+	M3DMatrix44f		rigidMatrix;
+	M3DMatrix44f		inverseRigidMatrix;
+	float				rigidPosition[3];
+	float				rigidOrientation[3];
+	bool				rigidMatrixValid;
 };
 
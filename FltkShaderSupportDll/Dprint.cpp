@@ -2,6 +2,13 @@
 #include "Dprint.h"
 
 vector<string> Dprint::stringVec;    
+CRITICAL_SECTION Dprint::stringLock;
+
+// makes sure the lock exists before anyone can call add()
+struct DprintLockInit{
+	DprintLockInit(){ InitializeCriticalSection(&Dprint::stringLock); };
+};
+static DprintLockInit dprintLockInit;
 
 Dprint::Dprint(void)
 {
@@ -30,11 +37,13 @@ void Dprint::screenPrint(int width, int height){
 	gl_font(FL_HELVETICA, 12);
 	int fontHeight = glutBitmapHeight(GLUT_BITMAP_HELVETICA_12);
 	int yPos = height-fontHeight;
+	EnterCriticalSection(&stringLock);
 	for(unsigned int i = 0; i < stringVec.size(); ++i){
 		sprintf_s(msg, "[%d] %s\n", i, stringVec[i].c_str());
 		gl_draw(msg, 10, yPos);
 		yPos -= fontHeight;
 	}
+	LeaveCriticalSection(&stringLock);
 }
 
 /**
@@ -47,7 +56,9 @@ void Dprint::screenPrint(int width, int height){
  */
 
 void Dprint::reset(){
+	EnterCriticalSection(&stringLock);
 	stringVec.clear();
+	LeaveCriticalSection(&stringLock);
 }
 
 /**
@@ -69,7 +80,9 @@ void Dprint::add(const char * format, ...){
 	va_end(v);
 
 	string str(Data);
+	EnterCriticalSection(&stringLock);
 	stringVec.push_back(str);
+	LeaveCriticalSection(&stringLock);
 }
 
 /**
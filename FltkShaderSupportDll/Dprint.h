@@ -1,5 +1,6 @@
 #pragma once
 
+#include <windows.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <vector>
@@ -93,5 +94,11 @@ protected:
 
 private:
 	static vector<string> stringVec;    
+
+	/**
+	 * @summary	Guards stringVec, since add() may be called from the simulation thread while the window is drawing
+	 */
+	static CRITICAL_SECTION stringLock;
+	friend struct DprintLockInit;
 };
 
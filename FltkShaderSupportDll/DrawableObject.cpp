@@ -1,11 +1,27 @@
 #include "StdAfx.h"
 #include "DrawableObject.h"
+#include "RayCaster.h"
+
+float DrawableObject::frameDeltaTime = 0.0f;
+double DrawableObject::frameTime = 0.0;
+float DrawableObject::interpolationAlpha = 1.0f;
+bool DrawableObject::useSnapshots = false;
+int DrawableObject::viewportHeight = 1;
+
+const GLfloat DrawableObject::vRed[4] =		{1.0f, 0.0f, 0.0f, 1.0f};
+const GLfloat DrawableObject::vGreen[4] =	{0.0f, 1.0f, 0.0f, 1.0f};
+const GLfloat DrawableObject::vBlue[4] =	{0.0f, 0.0f, 1.0f, 1.0f};
+const GLfloat DrawableObject::vWhite[4] =	{1.0f, 1.0f, 1.0f, 1.0f};
+const GLfloat DrawableObject::vGray[4] =	{0.5f, 0.5f, 0.5f, 1.0f};
+const GLfloat DrawableObject::vCyan[4] =	{0.0f, 1.0f, 1.0f, 1.0f};
+const GLfloat DrawableObject::vMagenta[4] =	{1.0f, 0.0f, 1.0f, 1.0f};
+const GLfloat DrawableObject::vYellow[4] =	{1.0f, 1.0f, 0.0f, 1.0f};
 
 /**
  * @fn	DrawableObject::DrawableObject(GLuint activeTexture)
  *
- * @brief	Constructor. Sets up default positions and colors, and
- * 			creates a query object for picking
+ * @brief	Constructor. Sets up default positions and colors. The picking queries are made on
+ * 			the first pickRender()
  *
  * @author	Phil
  * @date	3/14/2012
@@ -16,32 +32,41 @@
 DrawableObject::DrawableObject(GLuint activeTexture)
 {
 	activeTextureID = activeTexture;
-	drawQuery = 0; // if zero, there is no query
+	pickCallback = NULL;
+	pickCallbackData = NULL;
+	pickId = 0;
+	spatialProxy = -1;
 
 	setFloats( position, 3, 0.0, 0.0, 0.0);
 	setFloats( orientation, 3, 0.0, 0.0, 0.0);
 	scalar = 1.0f;
 
+	// no bounds until a subclass sets them, which keeps the object out of ray picks
+	boundingSphereRadius = 0.0f;
+	setFloats( minAARB, 3, 0.0, 0.0, 0.0);
+	setFloats( maxAARB, 3, 0.0, 0.0, 0.0);
 
-	setFloats( vRed, 4, 1.0f, 0.0f, 0.0f, 1.0f);
-	setFloats( vGreen, 4, 0.0f, 1.0f, 0.0f, 1.0f);
-	setFloats( vBlue, 4, 0.0f, 0.0f, 1.0f, 1.0f);
-	setFloats( vWhite, 4, 1.0f, 1.0f, 1.0f, 1.0f);
-	setFloats( vGray, 4, 0.5f, 0.5f, 0.5f, 1.0f);
-	setFloats( vCyan, 4, 0.0f, 1.0f, 1.0f, 1.0f);
-	setFloats( vMagenta, 4, 1.0f, 0.0f, 1.0f, 1.0f);
-	setFloats( vYellow, 4, 1.0f, 1.0f, 0.0f, 1.0f);
+	drawNormals = false;
 
-	curTime = clock();
-	prevTime = clock();
 	deltaTime = 0.0f;
 
-	pickQueryResult = READY;
-	glGenQueries(1, &drawQuery);
-	if(drawQuery == 0){
-		printf("DrawableObject() glGenQueries ERROR: %s\n:", gluErrorString(glGetError()));
-		pickQueryResult = PICK_ERROR;
-	}
+	setFloats( prevPosition, 3, 0.0, 0.0, 0.0);
+	setFloats( prevOrientation, 3, 0.0, 0.0, 0.0);
+	hasPrevState = false;
+
+	setFloats( curColor, 4, 1.0f, 1.0f, 1.0f, 1.0f);
+	setName("DrawableObject");
+	parallelCalc = false; // subclasses opt in once they know their environmentCalc() is thread safe
+	snapshotSafe = false;
+	animating = false;
+	dirty = 1; // so that it gets drawn at least once
+
+	// built on first use
+	m3dLoadIdentity44(modelMatrix);
+	modelMatrixDirty = 1;
+	lodLevel = 0;
+
+	publishState(); // so the render thread has something to draw before the first simulation step
 }
 
 
@@ -49,6 +74,34 @@ DrawableObject::~DrawableObject(void)
 {
 }
 
+/**
+ * @fn	int DrawableObject::getProfileSection(FrameProfiler &profiler, PROFILE_PHASE phase)
+ *
+ * @brief	Gets (and caches) the profiler section for one of this object's phases. The sections are 
+ * 			looked up again if the object is renamed or timed by a different profiler
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	profiler	The profiler.
+ * @param	phase				The phase.
+ *
+ * @return	The profile section.
+ */
+int DrawableObject::getProfileSection(FrameProfiler &profiler, PROFILE_PHASE phase){
+	static const char *phaseNames[PROFILE_NUM_PHASES] = {"render", "environmentCalc", "gpu"};
+	char sectionName[FrameProfiler::MAX_NAME];
+
+	if(profiledBy != &profiler){
+		for(int i = 0; i < PROFILE_NUM_PHASES; ++i){
+			sprintf_s(sectionName, "%s.%s", name, phaseNames[i]);
+			profileSections[i] = profiler.getSection(sectionName);
+		}
+		profiledBy = &profiler;
+	}
+	return profileSections[phase];
+}
+
 /**
  * @fn	void DrawableObject::setFloats(GLfloat *ptr, int size, ...)
  *
@@ -94,6 +147,81 @@ void DrawableObject::placeInGlobalSpace(){
 	/*****/
 }
 
+/**
+ * @fn	const M3DMatrix44f& DrawableObject::getModelMatrix(const DrawableState &state)
+ *
+ * @brief	Gets the model matrix for a render state, rebuilding it only if it is out of date. The
+ * 			compare catches interpolation and snapshots, where what reaches render() moves on after
+ * 			the dirty flag has been taken; the flag catches changes the state doesn't carry
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	state	The render state.
+ *
+ * @return	The model matrix.
+ */
+const M3DMatrix44f& DrawableObject::getModelMatrix(const DrawableState &state){
+	bool stale = InterlockedExchange(&modelMatrixDirty, 0) != 0 || state.scalar != modelMatrixState.scalar;
+
+	for(int i = 0; i < 3 && !stale; ++i){
+		stale = state.position[i] != modelMatrixState.position[i] || state.orientation[i] != modelMatrixState.orientation[i];
+	}
+	if(stale){
+		buildModelMatrix(state, modelMatrix);
+		modelMatrixState = state;
+	}
+	return modelMatrix;
+}
+
+/**
+ * @fn	void DrawableObject::buildModelMatrix(const DrawableState &state, M3DMatrix44f mat)
+ *
+ * @brief	Builds the default model matrix: position, orientation and a uniform scalar
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	state	   	The render state.
+ * @param [out]	mat	The model matrix.
+ */
+void DrawableObject::buildModelMatrix(const DrawableState &state, M3DMatrix44f mat){
+	composeTransform(mat, state.position, state.orientation, state.scalar, state.scalar, state.scalar);
+}
+
+/**
+ * @fn	void DrawableObject::composeTransform(M3DMatrix44f mat, const float *pos,
+ * 		const float *orient, float sx, float sy, float sz)
+ *
+ * @brief	Writes translate * rotateY * rotateX * scale into a matrix. Two rotations and one product,
+ * 			where the matrix stack would take four products
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [out]	mat	The matrix.
+ * @param	pos		   	The position.
+ * @param	orient	   	The orientation in degrees.
+ * @param	sx		   	The x scale.
+ * @param	sy		   	The y scale.
+ * @param	sz		   	The z scale.
+ */
+void DrawableObject::composeTransform(M3DMatrix44f mat, const float *pos, const float *orient, float sx, float sy, float sz){
+	M3DMatrix44f rotY, rotX;
+
+	m3dRotationMatrix44(rotY, degToRad(orient[1]), 0.0f, 1.0f, 0.0f);
+	m3dRotationMatrix44(rotX, degToRad(orient[2]), 1.0f, 0.0f, 0.0f);
+	m3dMatrixMultiply44(mat, rotY, rotX);
+
+	// scaling last scales the columns, and translating first just sets the last one
+	for(int i = 0; i < 3; ++i){
+		mat[i] *= sx;
+		mat[4 + i] *= sy;
+		mat[8 + i] *= sz;
+		mat[12 + i] = pos[i];
+	}
+}
+
 /**
  * @fn	void DrawableObject::orient33fromMat44(M3DMatrix33f &mat33, const M3DMatrix44f mat44)
  *
@@ -191,6 +319,94 @@ float DrawableObject::aabbSphereIntersect(const float Bmin[], const float Bmax[]
 	return 0.0f;
 }
 
+/**
+ * @fn	bool DrawableObject::rayIntersect(const M3DVector3f origin, const M3DVector3f dir,
+ * 		float &distance)
+ *
+ * @brief	Tests a world space ray against the bounding sphere around position, then the bounding box
+ * 			offset by position. The sphere is the cheap rejection; the box gives the distance
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	origin			The start of the ray.
+ * @param	dir				The unit direction of the ray.
+ * @param [out]	distance	How far along the ray the object was hit.
+ *
+ * @return	true if the ray hits the object.
+ */
+bool DrawableObject::rayIntersect(const M3DVector3f origin, const M3DVector3f dir, float &distance){
+	M3DVector3f local;
+
+	if(boundingSphereRadius > 0.0f){
+		if(!RayCaster::raySphere(origin, dir, position, boundingSphereRadius, distance))
+			return false;
+		if(!hasBoundingBox())
+			return true;
+	}else if(!hasBoundingBox()){
+		return false;
+	}
+
+	m3dSubtractVectors3(local, origin, position);
+	return RayCaster::rayAABB(local, dir, minAARB, maxAARB, distance);
+}
+
+/**
+ * @fn	bool DrawableObject::getWorldBounds(float boxMin[3], float boxMax[3])
+ *
+ * @brief	Gets the box around the bounding sphere and the bounding box, both about position
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [out]	boxMin	The minimum corner.
+ * @param [out]	boxMax	The maximum corner.
+ *
+ * @return	false if there are no bounds.
+ */
+bool DrawableObject::getWorldBounds(float boxMin[3], float boxMax[3]){
+	bool hasBox = hasBoundingBox();
+
+	if(boundingSphereRadius <= 0.0f && !hasBox)
+		return false;
+
+	for(int i = 0; i < 3; ++i){
+		boxMin[i] = position[i] - boundingSphereRadius;
+		boxMax[i] = position[i] + boundingSphereRadius;
+		if(hasBox){
+			if(position[i] + minAARB[i] < boxMin[i])
+				boxMin[i] = position[i] + minAARB[i];
+			if(position[i] + maxAARB[i] > boxMax[i])
+				boxMax[i] = position[i] + maxAARB[i];
+		}
+	}
+	return true;
+}
+
+/**
+ * @fn	GLBatchBase* DrawableObject::selectLod(LodChain &chain, const M3DMatrix44f modelView,
+ * 		const M3DMatrix44f projection, float radius)
+ *
+ * @brief	Picks the mesh to draw from a level of detail chain, starting from the level picked last
+ * 			time
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	chain	The chain.
+ * @param	modelView	 	The model view matrix.
+ * @param	projection   	The projection matrix.
+ * @param	radius		 	The radius of the mesh in model units.
+ *
+ * @return	The mesh to draw, or NULL if the chain is empty.
+ */
+GLBatchBase* DrawableObject::selectLod(LodChain &chain, const M3DMatrix44f modelView, const M3DMatrix44f projection, float radius){
+	float pixels = LodChain::projectedSize(radius, modelView, projection, viewportHeight);
+
+	lodLevel = chain.selectLevel(pixels, lodLevel);
+	return chain.getBatch(lodLevel);
+}
+
 /**
  * @fn	bool DrawableObject::LoadTGATexture(const char *szFileName, GLenum minFilter,
  * 		GLenum magFilter, GLenum wrapMode)
@@ -8,11 +8,37 @@
 #include <GL/glut.h>
 #include <GL/GLU.h>
 #include <math.h>
-#include <ctime>
+#include <malloc.h>
+#include <new>
 #include "Dprint.h"
+#include "TripleBuffer.h"
+#include "FrameProfiler.h"
+#include "GpuTimer.h"
+#include "PickQuery.h"
+#include "LodChain.h"
 
 #define M_PI       3.14159265358979323846
 #define SQR(a)		((a)*(a))
+#define CACHE_LINE_SIZE	64
+#define DRAWABLE_CACHE_ALIGN	__declspec(align(CACHE_LINE_SIZE))
+
+/**
+ * @struct	DrawableState
+ *
+ * @brief	The transform and visual state of a DrawableObject that render() needs. When the simulation
+ * 			runs on its own thread, this is the snapshot that gets handed to the render thread.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+struct DrawableState
+{
+	float position[3];
+	float orientation[3];
+	float scalar;
+	float color[4];
+};
 
 /**
  * @class	DrawableObject
@@ -49,6 +75,208 @@ public:
 	 */
 	virtual ~DrawableObject(void);
 
+	/**
+	 * @fn	static void* DrawableObject::operator new(size_t size)
+	 *
+	 * @brief	Allocates objects on a cache line boundary. The hot block is aligned to one, and the
+	 * 			default new only promises 8 or 16 bytes
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	size	The size of the object.
+	 *
+	 * @return	The memory.
+	 */
+	static void* operator new(size_t size){
+		void *ptr = _aligned_malloc(size, CACHE_LINE_SIZE);
+		if(ptr == NULL)
+			throw std::bad_alloc();
+		return ptr;
+	};
+	static void operator delete(void *ptr){	_aligned_free(ptr);	};
+
+	/**
+	 * @enum	PROFILE_PHASE
+	 *
+	 * @brief	The per-object phases that Gl_ShaderWindow can time. PROFILE_GPU_RENDER is the GPU time
+	 * 			of render(), measured with the object's GpuTimer
+	 */
+	enum PROFILE_PHASE{PROFILE_RENDER, PROFILE_ENVIRONMENT_CALC, PROFILE_GPU_RENDER, PROFILE_NUM_PHASES};
+
+	/**
+	 * @fn	void DrawableObject::setName(const char *objName)
+	 *
+	 * @brief	Sets the name that this object reports under in the frame profiler
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	objName	The name.
+	 */
+	void setName(const char *objName){
+		strncpy_s(name, objName, _TRUNCATE);
+		profiledBy = NULL;
+	}
+
+	/**
+	 * @fn	const char* DrawableObject::getName()
+	 *
+	 * @brief	Gets the name.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The name.
+	 */
+	const char* getName(){	return name;	};
+
+	/**
+	 * @fn	int DrawableObject::getProfileSection(FrameProfiler &profiler, PROFILE_PHASE phase);
+	 *
+	 * @brief	Gets (and caches) the profiler section for one of this object's phases. The section is
+	 * 			named "<name>.render", "<name>.environmentCalc" or "<name>.gpu"
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	profiler	The profiler.
+	 * @param	phase				The phase.
+	 *
+	 * @return	The profile section.
+	 */
+	int getProfileSection(FrameProfiler &profiler, PROFILE_PHASE phase);
+
+	/**
+	 * @fn	GpuTimer& DrawableObject::getGpuTimer()
+	 *
+	 * @brief	Gets the timer that measures this object's render() on the GPU
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The GPU timer.
+	 */
+	GpuTimer& getGpuTimer(){	return gpuTimer;	};
+
+	/**
+	 * @fn	void DrawableObject::setParallelCalc(bool parallel)
+	 *
+	 * @brief	Sets whether Gl_ShaderWindow may run this object's environmentCalc() on a worker thread
+	 * 			in parallel-update mode. Only opt in if environmentCalc() makes no GL calls and touches
+	 * 			nothing shared with other objects; the rest are updated on the calling thread after the
+	 * 			parallel pass. Defaults to false.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	parallel	true to opt in.
+	 */
+	void setParallelCalc(bool parallel){	parallelCalc = parallel;	};
+
+	/**
+	 * @fn	bool DrawableObject::isParallelCalc()
+	 *
+	 * @brief	Query if environmentCalc() may run on a worker thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if it may.
+	 */
+	bool isParallelCalc(){	return parallelCalc;	};
+
+	/**
+	 * @fn	void DrawableObject::setSnapshotSafe(bool safe)
+	 *
+	 * @brief	Declares that render() only reads what the simulation thread publishes: getRenderState(),
+	 * 			state of the object's own copied out in publishLocalState(), and members that
+	 * 			environmentCalc() never writes. Gl_ShaderWindow won't run its simulation thread with an
+	 * 			object in the scene that hasn't said so. Defaults to false.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	safe	true if render() can run alongside environmentCalc().
+	 */
+	void setSnapshotSafe(bool safe){	snapshotSafe = safe;	};
+
+	/**
+	 * @fn	bool DrawableObject::isSnapshotSafe()
+	 *
+	 * @brief	Query if render() can run alongside environmentCalc() on the simulation thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if it can.
+	 */
+	bool isSnapshotSafe(){	return snapshotSafe;	};
+
+	/**
+	 * @fn	void DrawableObject::setAnimating(bool anim)
+	 *
+	 * @brief	Marks this object as changing every frame by itself (e.g. it spins in environmentCalc()).
+	 * 			In Gl_ShaderWindow's on-demand redraw mode, frames keep being drawn while any object in
+	 * 			the scene is animating. Defaults to false.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	anim	true if the object animates.
+	 */
+	void setAnimating(bool anim){	animating = anim;	setDirty();	};
+
+	/**
+	 * @fn	bool DrawableObject::isAnimating()
+	 *
+	 * @brief	Query if the object changes every frame by itself.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if animating.
+	 */
+	bool isAnimating(){	return animating;	};
+
+	/**
+	 * @fn	void DrawableObject::setDirty()
+	 *
+	 * @brief	Asks for the next frame to be drawn, for changes that setAnimating() doesn't cover. The
+	 * 			setters call this themselves. Safe to call from any thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void setDirty(){	InterlockedExchange(&dirty, 1);	};
+
+	/**
+	 * @fn	bool DrawableObject::takeDirty()
+	 *
+	 * @brief	Reads and clears the dirty flag. Called by Gl_ShaderWindow once per frame
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if setDirty() has been called since the last time.
+	 */
+	bool takeDirty(){	return InterlockedExchange(&dirty, 0) != 0;	};
+
+	/**
+	 * @fn	void DrawableObject::setTransformDirty()
+	 *
+	 * @brief	Marks the cached model matrix out of date (and asks for a redraw). The position,
+	 * 			orientation and scalar setters call this; subclasses that change those fields, or anything
+	 * 			else their buildModelMatrix() reads, directly must call it themselves
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void setTransformDirty(){
+		InterlockedExchange(&modelMatrixDirty, 1);
+		setDirty();
+	};
+
 	/**
 	 * @fn	void DrawableObject::setColor(float r, float g, float b, float a)
 	 *
@@ -67,6 +295,7 @@ public:
 		curColor[1] = g;
 		curColor[2] = b;
 		curColor[3] = a;
+		setDirty();
 	}
 
 	/**
@@ -85,6 +314,7 @@ public:
 		position[0] = x;
 		position[1] = y;
 		position[2] = z;
+		setTransformDirty();
 	}
 
 	/**
@@ -103,6 +333,7 @@ public:
 		orientation[0] = pitch;
 		orientation[1] = roll;
 		orientation[2] = yaw;
+		setTransformDirty();
 	}
 
 	float getXpos(){
@@ -129,6 +360,7 @@ public:
 	 */
 	void setXpos(float x){
 		position[0] = x;
+		setTransformDirty();
 	}
 
 	/**
@@ -143,6 +375,7 @@ public:
 	 */
 	void setYpos(float y){
 		position[1] = y;
+		setTransformDirty();
 	}
 
 	/**
@@ -157,6 +390,7 @@ public:
 	 */
 	void setZpos(float z){
 		position[2] = z;
+		setTransformDirty();
 	}
 
 	/**
@@ -171,6 +405,7 @@ public:
 	 */
 	void setPitch(float pitch){
 		orientation[0] = pitch;
+		setTransformDirty();
 	}
 
 	/**
@@ -185,6 +420,7 @@ public:
 	 */
 	void setRoll(float roll){
 		orientation[1] = roll;
+		setTransformDirty();
 	}
 
 	/**
@@ -199,6 +435,7 @@ public:
 	 */
 	void setYaw(float yaw){
 		orientation[2] = yaw;
+		setTransformDirty();
 	}
 
 	/**
@@ -213,6 +450,7 @@ public:
 	 */
 	void setScalar(float s){
 		scalar = s;
+		setTransformDirty();
 	}
 
 	float getScalar(){
@@ -222,18 +460,186 @@ public:
 	/**
 	 * @fn	void DrawableObject::calcDeltaTime()
 	 *
-	 * @brief	Calculates the delta time between the current and previous frame
+	 * @brief	Picks up the step for this environmentCalc() from the shared frame clock (see
+	 * 			setFrameTime()), and saves the current state for interpolation
 	 *
 	 * @author	Phil
 	 * @date	3/14/2012
 	 */
 	void calcDeltaTime(){
-		curTime = clock();
-		deltaTime = (float)(curTime-prevTime)/CLOCKS_PER_SEC;
-		prevTime = curTime;
-		//Dprint::add("prev time = %d, cur time = %d, deltaTime = %f", prevTime, curTime, deltaTime);
+		deltaTime = frameDeltaTime;
+
+		// save off where we were so render() can interpolate between steps
+		copyArray(3, position, prevPosition);
+		copyArray(3, orientation, prevOrientation);
+		hasPrevState = true;
+	}
+
+	/**
+	 * @fn	static void DrawableObject::setFrameTime(float dt, double time)
+	 *
+	 * @brief	Sets the step and the absolute time that every object's environmentCalc() sees. Set once
+	 * 			per step by Gl_ShaderWindow from its FrameClock, before any object is updated
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	dt  	The step in seconds.
+	 * @param	time	The time since the clock started, in seconds.
+	 */
+	static void setFrameTime(float dt, double time){	frameDeltaTime = dt;	frameTime = time;	};
+
+	/**
+	 * @fn	static double DrawableObject::getFrameTime()
+	 *
+	 * @brief	Gets the absolute time of the current step, for animations that are a function of time
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The time in seconds.
+	 */
+	static double getFrameTime(){	return frameTime;	};
+
+	/**
+	 * @fn	static void DrawableObject::setInterpolationAlpha(float alpha)
+	 *
+	 * @brief	Sets how far (0.0 - 1.0) the frame being drawn lies between the previous and the current
+	 * 			simulation step. Set by Gl_ShaderWindow before each frame.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	alpha	The interpolation alpha.
+	 */
+	static void setInterpolationAlpha(float alpha){	interpolationAlpha = alpha;	};
+
+	/**
+	 * @fn	static float DrawableObject::getInterpolationAlpha()
+	 *
+	 * @brief	Gets the interpolation alpha for the frame being drawn
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The interpolation alpha.
+	 */
+	static float getInterpolationAlpha(){	return interpolationAlpha;	};
+
+	/**
+	 * @fn	static void DrawableObject::setViewportHeight(int height)
+	 *
+	 * @brief	Sets the height in pixels of the viewport being drawn into, for selectLod(). Set by
+	 * 			Gl_ShaderWindow before each frame
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	height	The height of the viewport.
+	 */
+	static void setViewportHeight(int height){	viewportHeight = height;	};
+
+	/**
+	 * @fn	static int DrawableObject::getViewportHeight()
+	 *
+	 * @brief	Gets the height in pixels of the viewport being drawn into
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The height of the viewport.
+	 */
+	static int getViewportHeight(){	return viewportHeight;	};
+
+	/**
+	 * @fn	static void DrawableObject::setUseSnapshots(bool use)
+	 *
+	 * @brief	Tells every DrawableObject whether render() should read the state published by
+	 * 			publishState() (simulation on another thread) or the live member values. Set by
+	 * 			Gl_ShaderWindow when it starts or stops its simulation thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	use	true to render from published snapshots.
+	 */
+	static void setUseSnapshots(bool use){	useSnapshots = use;	};
+
+	/**
+	 * @fn	static bool DrawableObject::isUsingSnapshots()
+	 *
+	 * @brief	Query if render() should read published state rather than live members. Subclasses that
+	 * 			publish state of their own in publishLocalState() check this the way getRenderState() does
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if the simulation is running on its own thread.
+	 */
+	static bool isUsingSnapshots(){	return useSnapshots;	};
+
+	/**
+	 * @fn	void DrawableObject::publishState()
+	 *
+	 * @brief	Copies the current position, orientation, scalar and color into the triple buffer and
+	 * 			makes it available to the render thread, then calls publishLocalState(). Call from the
+	 * 			simulation thread after environmentCalc()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void publishState(){
+		DrawableState &state = stateBuffer.writeBuffer();
+		copyArray(3, position, state.position);
+		copyArray(3, orientation, state.orientation);
+		state.scalar = scalar;
+		copyArray(4, curColor, state.color);
+		stateBuffer.publish();
+		publishLocalState();
+	}
+
+	/**
+	 * @fn	const DrawableState& DrawableObject::getRenderState()
+	 *
+	 * @brief	Gets the state that render() should draw. If the simulation is running on its own thread
+	 * 			this is the newest published snapshot (never blocks). Otherwise it is the live state, with
+	 * 			position and orientation interpolated between the last two simulation steps.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The render state.
+	 */
+	const DrawableState& getRenderState(){
+		if(useSnapshots){
+			stateBuffer.update();
+			return stateBuffer.readBuffer();
+		}
+		getInterpolatedPosition(liveState.position);
+		getInterpolatedOrientation(liveState.orientation);
+		liveState.scalar = scalar;
+		copyArray(4, curColor, liveState.color);
+		return liveState;
 	}
 
+	/**
+	 * @fn	const M3DMatrix44f& DrawableObject::getModelMatrix(const DrawableState &state);
+	 *
+	 * @brief	Gets the matrix that places this object in the world for a render state, for render() to
+	 * 			multiply onto the model view stack. It is only rebuilt (with buildModelMatrix()) after
+	 * 			setTransformDirty() or when the state differs from the one it was last built from, so a
+	 * 			still object pays for a compare instead of the trig and the matrix products. Call from
+	 * 			the render thread only
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	state	The render state, normally from getRenderState().
+	 *
+	 * @return	The model matrix.
+	 */
+	const M3DMatrix44f& getModelMatrix(const DrawableState &state);
+
 	/**
 	 * @fn	void DrawableObject::draw3dString(float x, float y, float z, char *string, void* font)
 	 *
@@ -384,7 +790,8 @@ public:
 	 * @fn	void DrawableObject::pickRender(GLMatrixStack &modelViewStack,
 	 * 		GLMatrixStack &projectionStack, GLShaderManager &shaderManager)
 	 *
-	 * @brief	Set up rendering of this object for picking
+	 * @brief	Renders this object inside an occlusion query for picking. The result arrives a frame
+	 * 			or two later through pickResult() and the pick callback
 	 *
 	 * @author	Phil
 	 * @date	3/14/2012
@@ -394,13 +801,9 @@ public:
 	 * @param [in,out]	shaderManager  	OpenGlSuperBible (5th ed) GLShaderManager
 	 */
 	void pickRender(GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager){
-		if(pickQueryResult == READY)
-			glBeginQuery(GL_ANY_SAMPLES_PASSED, drawQuery);
-
+		pickQuery.begin();
 		render(modelViewStack, projectionStack, shaderManager);
-
-		if(pickQueryResult == READY)
-			glEndQuery(GL_ANY_SAMPLES_PASSED);
+		pickQuery.end();
 	};
 
 	/**
@@ -410,37 +813,201 @@ public:
 	 */
 	static enum PICK_RESULT{UNAVAILABLE, HIT, MISS, READY, PICK_ERROR};
 
+	/**
+	 * @brief	Called with the result of each pickRender() once the GPU has it
+	 */
+	typedef void (*PickCallback)(DrawableObject *obj, bool hit, void *data);
+
+	/**
+	 * @fn	void DrawableObject::setPickCallback(PickCallback callback, void *data)
+	 *
+	 * @brief	Sets the function that pickResult() hands each finished pick to
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	callback	The callback, or NULL for none.
+	 * @param [in,out]	data	Passed through to the callback.
+	 */
+	void setPickCallback(PickCallback callback, void *data){	pickCallback = callback;	pickCallbackData = data;	};
+
 	/**
 	 * @fn	PICK_RESULT DrawableObject::pickResult()
 	 *
-	 * @brief	Determine the result of the pick request
+	 * @brief	Collects the oldest finished pick, without waiting for the GPU, and passes it to the pick
+	 * 			callback. Gl_ShaderWindow calls this every frame for every object in the scene that has a
+	 * 			pick on its way
 	 *
 	 * @author	Phil
 	 * @date	3/14/2012
 	 *
-	 * @return	.
+	 * @return	HIT or MISS if a pick finished, UNAVAILABLE if one is still in flight, READY if there
+	 * 			are none, and PICK_ERROR if the queries couldn't be created.
 	 */
 	PICK_RESULT pickResult(){
-		GLint result;
+		bool hit;
 
-		if(pickQueryResult == PICK_ERROR){
-			return UNAVAILABLE;
-		}
+		if(!pickQuery.isValid())
+			return PICK_ERROR;
+		if(!pickQuery.getResult(hit))
+			return pickQuery.isPending() ? UNAVAILABLE : READY;
 
-		/** use this if we don't want to wait for the result. Doesn't seem to be working though
-		glGetQueryObjectiv(drawQuery, GL_QUERY_RESULT_AVAILABLE, &result);
-		if(result == 0){		
-			pickQueryResult = UNAVAILABLE;
-			return UNAVAILABLE;
-		}
-		pickQueryResult = READY;
-		/***/
-
-		glGetQueryObjectiv(drawQuery, GL_QUERY_RESULT, &result); // seems to slow down the rendering
-		if(result)
-			return HIT;
-		else
-			return MISS; 
+		if(pickCallback != NULL)
+			pickCallback(this, hit, pickCallbackData);
+		return hit ? HIT : MISS;
+	};
+
+	/**
+	 * @fn	bool DrawableObject::isPickPending()
+	 *
+	 * @brief	Query if a pick is on its way.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if pickResult() has something to collect, now or soon.
+	 */
+	bool isPickPending(){	return pickQuery.isPending();	};
+
+	/**
+	 * @fn	GLuint DrawableObject::getPickId()
+	 *
+	 * @brief	Gets the ID this object writes into the window's IdBuffer. Gl_ShaderWindow hands out a
+	 * 			different one to each object as it joins the scene
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The pick ID, zero if the object isn't in a scene.
+	 */
+	GLuint getPickId(){	return pickId;	};
+	void setPickId(GLuint id){	pickId = id;	};
+
+	/**
+	 * @fn	void DrawableObject::notifyPick(bool hit)
+	 *
+	 * @brief	Passes a pick that was worked out somewhere other than pickResult() (e.g. from the
+	 * 			IdBuffer) to the pick callback
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	hit	true if the object was picked.
+	 */
+	void notifyPick(bool hit){
+		if(pickCallback != NULL)
+			pickCallback(this, hit, pickCallbackData);
+	};
+
+	/**
+	 * @fn	virtual bool DrawableObject::rayIntersect(const M3DVector3f origin, const M3DVector3f dir,
+	 * 		float &distance);
+	 *
+	 * @brief	Tests a world space ray against this object for RayCaster. The default tests the bounding
+	 * 			sphere around position first, then the bounding box offset by position. Override this if
+	 * 			the object rotates its box (as CollisionCubeBase does) or wants a triangle-exact test.
+	 * 			Only reads the simulation state, so it is safe to call from the simulation thread
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	origin			The start of the ray.
+	 * @param	dir				The unit direction of the ray.
+	 * @param [out]	distance	How far along the ray the object was hit.
+	 *
+	 * @return	true if the ray hits the object. Objects with neither a sphere nor a box are never hit.
+	 */
+	virtual bool rayIntersect(const M3DVector3f origin, const M3DVector3f dir, float &distance);
+
+	/**
+	 * @fn	virtual bool DrawableObject::getWorldBounds(float boxMin[3], float boxMax[3]);
+	 *
+	 * @brief	Gets a world space box around the simulation state, for the window's DynamicBVH. The
+	 * 			default covers the bounding sphere around position and the bounding box offset by
+	 * 			position, the same volumes rayIntersect() tests. Override this along with rayIntersect()
+	 * 			(as CollisionCubeBase does)
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	boxMin	The minimum corner.
+	 * @param [out]	boxMax	The maximum corner.
+	 *
+	 * @return	false if the object has neither a sphere nor a box, which keeps it out of the tree.
+	 */
+	virtual bool getWorldBounds(float boxMin[3], float boxMax[3]);
+
+	/**
+	 * @fn	int DrawableObject::getSpatialProxy()
+	 *
+	 * @brief	Gets the handle of this object in the window's DynamicBVH.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The proxy, or -1 if the object isn't in the tree.
+	 */
+	int getSpatialProxy(){	return spatialProxy;	};
+	void setSpatialProxy(int proxy){	spatialProxy = proxy;	};
+
+	/**
+	 * @fn	float DrawableObject::getBoundingSphereRadius()
+	 *
+	 * @brief	Gets the radius of the bounding sphere around position. Zero until a subclass sets it,
+	 * 			which means the object has no bounds, so it is never culled or ray picked by its sphere
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The bounding sphere radius.
+	 */
+	float getBoundingSphereRadius(){	return boundingSphereRadius;	};
+
+	/**
+	 * @fn	GLBatchBase* DrawableObject::selectLod(LodChain &chain, const M3DMatrix44f modelView,
+	 * 		const M3DMatrix44f projection, float radius);
+	 *
+	 * @brief	Picks the mesh to draw from a level of detail chain, by how big a sphere of 'radius'
+	 * 			around the model's origin is on screen. Call from render() with the object's transform
+	 * 			already on modelView. The level is remembered for next time, which is what lets the
+	 * 			chain's hysteresis work
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	chain	The chain.
+	 * @param	modelView	 	The model view matrix.
+	 * @param	projection   	The projection matrix.
+	 * @param	radius		 	The radius of the mesh in model units.
+	 *
+	 * @return	The mesh to draw, or NULL if the chain is empty.
+	 */
+	GLBatchBase* selectLod(LodChain &chain, const M3DMatrix44f modelView, const M3DMatrix44f projection, float radius);
+
+	/**
+	 * @fn	int DrawableObject::getLodLevel()
+	 *
+	 * @brief	Gets the level that selectLod() picked last.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The level, 0 being the finest.
+	 */
+	int getLodLevel(){	return lodLevel;	};
+
+	/**
+	 * @fn	bool DrawableObject::hasBoundingBox()
+	 *
+	 * @brief	Query if minAARB and maxAARB have been set to a box with some volume.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if there is a bounding box.
+	 */
+	bool hasBoundingBox(){
+		return minAARB[0] < maxAARB[0] || minAARB[1] < maxAARB[1] || minAARB[2] < maxAARB[2];
 	};
 
 	/**
@@ -472,8 +1039,8 @@ public:
 	 * @date	3/14/2012
 	 */
 	void cleanup(){
-		if(drawQuery != 0)
-			glDeleteQueries(1, &drawQuery);
+		pickQuery.cleanup();
+		gpuTimer.cleanup();
 		localCleanup();
 	};
 
@@ -505,6 +1072,25 @@ public:
 	 */
 	static inline float radToDeg(float radAngle){	return (float)(radAngle * 180.f/M_PI);	};
 
+	/**
+	 * @fn	static void DrawableObject::composeTransform(M3DMatrix44f mat, const float *pos,
+	 * 		const float *orient, float sx, float sy, float sz);
+	 *
+	 * @brief	Writes translate(pos) * rotateY(orient[1]) * rotateX(orient[2]) * scale(sx, sy, sz) into a
+	 * 			matrix directly, the same transform as that sequence of GLMatrixStack calls
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	mat	The matrix.
+	 * @param	pos		   	The position.
+	 * @param	orient	   	The orientation in degrees.
+	 * @param	sx		   	The x scale.
+	 * @param	sy		   	The y scale.
+	 * @param	sz		   	The z scale.
+	 */
+	static void composeTransform(M3DMatrix44f mat, const float *pos, const float *orient, float sx, float sy, float sz);
+
 	static inline double frand(double fMin, double fMax)
 	{
 		double f = (double)rand() / RAND_MAX;
@@ -533,17 +1119,52 @@ protected:
 	}
 
 	/**
-	 * @fn	void DrawableObject::setPosFromMatrix(float *vec)
+	 * @fn	void DrawableObject::getInterpolatedPosition(float *vec)
 	 *
-	 * @brief	Copies the xyz position from an openGL 4x4 matrix i.e. matrix[12], matrix[13], matrix[14]
+	 * @brief	Gets the position blended between the last two simulation steps by the interpolation alpha.
+	 * 			Objects that don't call calcDeltaTime() just get their current position
 	 *
-	 * @author	Phil
-	 * @date	3/25/2012
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
-	 * @param [in,out]	the vector to be set with the postion
+	 * @param [in,out]	vec	the vector to be set with the position
 	 */
+	void getInterpolatedPosition(float *vec){lerpArray(3, prevPosition, position, vec);};
 
-	void setPosFromMatrix(float *vec){copyArray(3, &matrix[12], vec);};
+	/**
+	 * @fn	void DrawableObject::getInterpolatedOrientation(float *vec)
+	 *
+	 * @brief	Gets the orientation blended between the last two simulation steps by the interpolation alpha
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	vec	the vector to be set with the orientation
+	 */
+	void getInterpolatedOrientation(float *vec){lerpArray(3, prevOrientation, orientation, vec);};
+
+	/**
+	 * @fn	void DrawableObject::lerpArray(int num, const float *prev, const float *cur, float *target)
+	 *
+	 * @brief	Blends two arrays by the interpolation alpha. Copies 'cur' if there is no previous state
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	num			  	Number of elements in the array
+	 * @param	prev			the state at the previous step
+	 * @param	cur				the state at the current step
+	 * @param [in,out]	target	target array
+	 */
+	void lerpArray(int num, const float *prev, const float *cur, float *target){
+		if(!hasPrevState){
+			copyArray(num, cur, target);
+			return;
+		}
+		for(int i = 0; i < num; ++i){
+			target[i] = prev[i] + (cur[i] - prev[i])*interpolationAlpha;
+		}
+	}
 
 	/**
 	 * @fn	void DrawableObject::setFloats(GLfloat *ptr, int amount, ...);
@@ -611,34 +1232,48 @@ protected:
 	void placeInGlobalSpace();
 
 	/**
-	 * @summary	The current color.
-	 */
-	GLfloat curColor[4];
-
-	/**
-	 * @summary	The position and orientation matrix.
+	 * @fn	virtual void DrawableObject::buildModelMatrix(const DrawableState &state, M3DMatrix44f mat);
+	 *
+	 * @brief	Builds the model matrix for getModelMatrix(). The default translates to the position,
+	 * 			rotates by orientation[1] around y and orientation[2] around x, and scales by the scalar.
+	 * 			Override for objects that are sized or turned some other way
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	state	   	The render state.
+	 * @param [out]	mat	The model matrix.
 	 */
-	GLfloat matrix[16];
+	virtual void buildModelMatrix(const DrawableState &state, M3DMatrix44f mat);
 
 	/**
-	 * @summary	true to draw normals.
+	 * @fn	virtual void DrawableObject::publishLocalState()
+	 *
+	 * @brief	Called by publishState() on the simulation thread. Override to copy whatever else render()
+	 * 			reads into a TripleBuffer of the subclass's own, and read it back in render() when
+	 * 			isUsingSnapshots() is true. Not called from the base class constructor, so subclasses
+	 * 			should call publishState() once they are set up. The default does nothing
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
 	 */
-	bool drawNormals;
+	virtual void publishLocalState(){};
 
 	/**
-	 * @summary	true to show, false to hide the data.
+	 * @summary	The hot block: the fields that update, culling and render read for every object every
+	 * 			frame. position starts a cache line and the rest are declared right after it, so that
+	 * 			walking the scene touches one line per object for them instead of several. Keep anything
+	 * 			added here small enough to stay inside the line
 	 */
-	bool showData;
 
 	/**
 	 * @summary	The XYZ position.
 	 */
-	float position[3];
+	DRAWABLE_CACHE_ALIGN float position[3];
 
 	/**
 	 * @summary	The orientation (pitch Roll Yaw)
 	 */
-
 	float orientation[3];
 
 	/**
@@ -661,6 +1296,83 @@ protected:
 	 */
 	float maxAARB[3];
 
+	/**
+	 * @summary	Non-zero if the object has changed since Gl_ShaderWindow last looked
+	 */
+	volatile LONG dirty;
+
+	/**
+	 * @summary	true if the object changes every frame by itself
+	 */
+	bool animating;
+
+	/**
+	 * @summary	true if environmentCalc() may run on a worker thread
+	 */
+	bool parallelCalc;
+
+	/**
+	 * @summary	true if render() only reads published state
+	 */
+	bool snapshotSafe;
+
+	/**
+	 * @summary	true once calcDeltaTime() has saved a previous state
+	 */
+	bool hasPrevState;
+
+	/**
+	 * @summary	delta time between frames
+	 */
+	float deltaTime;
+
+	/**
+	 * @summary	The position at the previous simulation step
+	 */
+	float prevPosition[3];
+
+	/**
+	 * @summary	The orientation at the previous simulation step
+	 */
+	float prevOrientation[3];
+
+	/**
+	 * @summary	The current color.
+	 */
+	GLfloat curColor[4];
+
+	/**
+	 * @summary	Identifier for the active texture.
+	 */
+	GLuint activeTextureID;
+
+	/**
+	 * @summary	The ID written into the IdBuffer for this object
+	 */
+	GLuint pickId;
+
+	/**
+	 * @summary	The handle of this object in the window's DynamicBVH
+	 */
+	int spatialProxy;
+
+	/**
+	 * @summary	The cached model matrix, the state it was built from, and non-zero once
+	 * 			setTransformDirty() has been called since
+	 */
+	M3DMatrix44f modelMatrix;
+	DrawableState modelMatrixState;
+	volatile LONG modelMatrixDirty;
+
+	/**
+	 * @summary	The level of detail that selectLod() picked last
+	 */
+	int lodLevel;
+
+	/**
+	 * @summary	Everything below is only touched now and then
+	 */
+
 	/**
 	 * @summary	The position of the point that we'll test collisions against
 	 */
@@ -677,45 +1389,82 @@ protected:
 	float xformed[3];
 
 	/**
-	 * @summary	The current time.
+	 * @summary	true to draw normals.
 	 */
-	clock_t curTime;
+	bool drawNormals;
 
 	/**
-	 * @summary	Time of the previous frame.
+	 * @summary	The name this object reports under in the frame profiler
 	 */
-	clock_t prevTime;
+	char name[32];
 
 	/**
-	 * @summary	delta time between frames
+	 * @summary	The profiler that profileSections belong to
 	 */
-	float deltaTime;
+	FrameProfiler *profiledBy;
 
 	/**
-	* @summary color vectors 
-	*/
-	float vRed[4];
-	float vGreen[4];
-	float vBlue[4];
-	float vWhite[4];
-	float vGray[4];
-	float vCyan[4];
-	float vMagenta[4];
-	float vYellow[4];
+	 * @summary	Cached profiler sections for each PROFILE_PHASE
+	 */
+	int profileSections[PROFILE_NUM_PHASES];
 
 	/**
-	 * @summary	Identifier for the active texture.
+	 * @summary	Times render() on the GPU
 	 */
-	GLuint activeTextureID;
+	GpuTimer gpuTimer;
+
+	/**
+	 * @summary	The occlusion queries for pickRender()
+	 */
+	PickQuery pickQuery;
+
+	/**
+	 * @summary	Called with each finished pick
+	 */
+	PickCallback pickCallback;
+	void *pickCallbackData;
+
+	/**
+	 * @summary	Snapshots handed from the simulation thread to the render thread
+	 */
+	TripleBuffer<DrawableState> stateBuffer;
 
 	/**
-	 * @summary	The draw query ID.
+	 * @summary	The render state when there is no simulation thread
 	 */
-	GLuint drawQuery;
+	DrawableState liveState;
 
 	/**
-	 * @summary	The pick query result.
+	 * @summary	The step and the absolute time of the current frame, shared by every object
 	 */
-	PICK_RESULT pickQueryResult;
+	static float frameDeltaTime;
+	static double frameTime;
+
+	/**
+	 * @summary	Fraction of a simulation step that the frame being drawn represents
+	 */
+	static float interpolationAlpha;
+
+	/**
+	 * @summary	true if render() should use the snapshots published by the simulation thread
+	 */
+	static bool useSnapshots;
+
+	/**
+	 * @summary	The height in pixels of the viewport being drawn into
+	 */
+	static int viewportHeight;
+
+	/**
+	* @summary color vectors, shared by every object
+	*/
+	static const GLfloat vRed[4];
+	static const GLfloat vGreen[4];
+	static const GLfloat vBlue[4];
+	static const GLfloat vWhite[4];
+	static const GLfloat vGray[4];
+	static const GLfloat vCyan[4];
+	static const GLfloat vMagenta[4];
+	static const GLfloat vYellow[4];
 };
 
@@ -0,0 +1,783 @@
+#include "StdAfx.h"
+#include "DynamicBVH.h"
+#include "DrawableObject.h"
+#include <algorithm>
+#include <float.h>
+
+// the number of buckets rebuild() sorts centers into along the split axis
+static const int NUM_BINS = 12;
+
+/**
+ * @fn	static void unionBox(float *outMin, float *outMax, const float *aMin, const float *aMax,
+ * 		const float *bMin, const float *bMax)
+ *
+ * @brief	Makes the box around two boxes. The output may be one of the inputs
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+static void unionBox(float *outMin, float *outMax, const float *aMin, const float *aMax, const float *bMin, const float *bMax){
+	for(int i = 0; i < 3; ++i){
+		outMin[i] = aMin[i] < bMin[i] ? aMin[i] : bMin[i];
+		outMax[i] = aMax[i] > bMax[i] ? aMax[i] : bMax[i];
+	}
+}
+
+/**
+ * @fn	static bool overlaps(const float *aMin, const float *aMax, const float *bMin,
+ * 		const float *bMax)
+ *
+ * @brief	Query if two boxes overlap, touching included
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+static bool overlaps(const float *aMin, const float *aMax, const float *bMin, const float *bMax){
+	return aMin[0] <= bMax[0] && aMax[0] >= bMin[0] &&
+		aMin[1] <= bMax[1] && aMax[1] >= bMin[1] &&
+		aMin[2] <= bMax[2] && aMax[2] >= bMin[2];
+}
+
+/**
+ * @fn	static bool touchesSphere(const float *boxMin, const float *boxMax, const float *center,
+ * 		float radiusSq)
+ *
+ * @brief	Query if a box comes within a radius of a point, by the distance to its closest point
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+static bool touchesSphere(const float *boxMin, const float *boxMax, const float *center, float radiusSq){
+	float distSq = 0.0f;
+
+	for(int i = 0; i < 3; ++i){
+		if(center[i] < boxMin[i])
+			distSq += (boxMin[i] - center[i])*(boxMin[i] - center[i]);
+		else if(center[i] > boxMax[i])
+			distSq += (center[i] - boxMax[i])*(center[i] - boxMax[i]);
+	}
+	return distSq <= radiusSq;
+}
+
+/**
+ * @struct	InLowerBins
+ *
+ * @brief	Partition predicate for rebuild(): true for leaves whose center falls in a bin at or below
+ * 			the split
+ */
+struct InLowerBins
+{
+	const float *centers;	// three per node
+	int axis;
+	float origin;
+	float scale;
+	int split;
+
+	bool operator()(int leaf) const {
+		int bin = (int)((centers[leaf*3 + axis] - origin)*scale);
+		return (bin < NUM_BINS ? bin : NUM_BINS - 1) <= split;
+	}
+};
+
+/**
+ * @fn	DynamicBVH::DynamicBVH(float margin)
+ *
+ * @brief	Constructor.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	margin	The padding around each leaf's box.
+ */
+DynamicBVH::DynamicBVH(float margin)
+{
+	this->margin = margin;
+	rebuildRatio = 1.5f;
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+	numLeaves = 0;
+	branchArea = 0.0f;
+	builtArea = 0.0f;
+}
+
+DynamicBVH::~DynamicBVH(void)
+{
+}
+
+/**
+ * @fn	float DynamicBVH::area(const float boxMin[3], const float boxMax[3])
+ *
+ * @brief	Gets half the surface area of a box, which is all the surface area heuristic needs, as only
+ * 			the ratios matter
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	boxMin	The minimum corner.
+ * @param	boxMax	The maximum corner.
+ *
+ * @return	The half area.
+ */
+float DynamicBVH::area(const float boxMin[3], const float boxMax[3]){
+	float dx = boxMax[0] - boxMin[0];
+	float dy = boxMax[1] - boxMin[1];
+	float dz = boxMax[2] - boxMin[2];
+	return dx*dy + dy*dz + dz*dx;
+}
+
+/**
+ * @fn	int DynamicBVH::allocateNode()
+ *
+ * @brief	Takes a node off the free list, or adds one. Indexes stay good, but references into
+ * 			'nodes' don't survive this
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The node.
+ */
+int DynamicBVH::allocateNode(){
+	int node;
+
+	if(freeList == NULL_NODE){
+		node = (int)nodes.size();
+		nodes.push_back(Node());
+	}else{
+		node = freeList;
+		freeList = nodes[node].parent;
+	}
+
+	Node &n = nodes[node];
+	n.parent = NULL_NODE;
+	n.child[0] = NULL_NODE;
+	n.child[1] = NULL_NODE;
+	n.obj = NULL;
+	return node;
+}
+
+/**
+ * @fn	void DynamicBVH::freeNode(int node)
+ *
+ * @brief	Puts a node on the free list
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node	The node.
+ */
+void DynamicBVH::freeNode(int node){
+	nodes[node].obj = NULL;
+	nodes[node].child[0] = NULL_NODE;
+	nodes[node].parent = freeList;
+	freeList = node;
+}
+
+/**
+ * @fn	void DynamicBVH::setChild(int parent, int slot, int child)
+ *
+ * @brief	Hangs a node under a parent, or makes it the root
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	parent	The parent, or NULL_NODE.
+ * @param	slot  	Which of the parent's children it becomes.
+ * @param	child 	The node.
+ */
+void DynamicBVH::setChild(int parent, int slot, int child){
+	nodes[child].parent = parent;
+	if(parent == NULL_NODE)
+		root = child;
+	else
+		nodes[parent].child[slot] = child;
+}
+
+/**
+ * @fn	int DynamicBVH::insert(DrawableObject *obj, const float boxMin[3], const float boxMax[3])
+ *
+ * @brief	Adds an object.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	obj	The object.
+ * @param	boxMin	   	The minimum corner of its world box.
+ * @param	boxMax	   	The maximum corner of its world box.
+ *
+ * @return	The proxy.
+ */
+int DynamicBVH::insert(DrawableObject *obj, const float boxMin[3], const float boxMax[3]){
+	int leaf = allocateNode();
+	Node &n = nodes[leaf];
+
+	n.obj = obj;
+	for(int i = 0; i < 3; ++i){
+		n.objMin[i] = boxMin[i];
+		n.objMax[i] = boxMax[i];
+		n.boxMin[i] = boxMin[i] - margin;
+		n.boxMax[i] = boxMax[i] + margin;
+	}
+	insertLeaf(leaf);
+	++numLeaves;
+	return leaf;
+}
+
+/**
+ * @fn	void DynamicBVH::insertLeaf(int leaf)
+ *
+ * @brief	Walks down from the root towards the cheapest place for a leaf, as Box2D's b2DynamicTree
+ * 			does. At each branch the choice is between pairing the leaf with the branch itself or going
+ * 			on into one of its children, where every branch on the way down has to grow to take the
+ * 			leaf too
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	leaf	The leaf.
+ */
+void DynamicBVH::insertLeaf(int leaf){
+	if(root == NULL_NODE){
+		setChild(NULL_NODE, 0, leaf);
+		return;
+	}
+
+	float combinedMin[3], combinedMax[3];
+	int sibling = root;
+
+	while(!nodes[sibling].isLeaf()){
+		const Node &node = nodes[sibling];
+		unionBox(combinedMin, combinedMax, node.boxMin, node.boxMax, nodes[leaf].boxMin, nodes[leaf].boxMax);
+
+		float combinedArea = area(combinedMin, combinedMax);
+		float cost = 2.0f*combinedArea;
+		float inheritance = 2.0f*(combinedArea - area(node.boxMin, node.boxMax));
+		float childCost[2];
+
+		for(int c = 0; c < 2; ++c){
+			const Node &child = nodes[node.child[c]];
+			unionBox(combinedMin, combinedMax, child.boxMin, child.boxMax, nodes[leaf].boxMin, nodes[leaf].boxMax);
+			childCost[c] = area(combinedMin, combinedMax) + inheritance;
+			if(!child.isLeaf())
+				childCost[c] -= area(child.boxMin, child.boxMax);
+		}
+
+		if(cost < childCost[0] && cost < childCost[1])
+			break;
+		sibling = childCost[0] < childCost[1] ? node.child[0] : node.child[1];
+	}
+
+	int oldParent = nodes[sibling].parent;
+	int slot = (oldParent != NULL_NODE && nodes[oldParent].child[1] == sibling) ? 1 : 0;
+	int branch = allocateNode();
+
+	unionBox(nodes[branch].boxMin, nodes[branch].boxMax, nodes[sibling].boxMin, nodes[sibling].boxMax, nodes[leaf].boxMin, nodes[leaf].boxMax);
+	branchArea += area(nodes[branch].boxMin, nodes[branch].boxMax);
+	setChild(oldParent, slot, branch);
+	setChild(branch, 0, sibling);
+	setChild(branch, 1, leaf);
+	refit(oldParent);
+}
+
+/**
+ * @fn	void DynamicBVH::remove(int proxy)
+ *
+ * @brief	Removes an object.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	proxy	The proxy.
+ */
+void DynamicBVH::remove(int proxy){
+	if(proxy < 0 || proxy >= (int)nodes.size() || nodes[proxy].obj == NULL){
+		fprintf(stderr, "DynamicBVH::remove() no proxy %d\n", proxy);
+		return;
+	}
+	removeLeaf(proxy);
+	freeNode(proxy);
+	--numLeaves;
+}
+
+/**
+ * @fn	void DynamicBVH::removeLeaf(int leaf)
+ *
+ * @brief	Takes a leaf out of the tree. Its parent goes too, and the sibling moves up into its place
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	leaf	The leaf.
+ */
+void DynamicBVH::removeLeaf(int leaf){
+	if(leaf == root){
+		root = NULL_NODE;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child[0] == leaf ? nodes[parent].child[1] : nodes[parent].child[0];
+	int slot = (grandParent != NULL_NODE && nodes[grandParent].child[1] == parent) ? 1 : 0;
+
+	branchArea -= area(nodes[parent].boxMin, nodes[parent].boxMax);
+	setChild(grandParent, slot, sibling);
+	freeNode(parent);
+	refit(grandParent);
+
+	// the running sum drifts, so start it again from nothing once there are no branches
+	if(nodes[root].isLeaf())
+		branchArea = 0.0f;
+}
+
+/**
+ * @fn	bool DynamicBVH::update(int proxy, const float boxMin[3], const float boxMax[3])
+ *
+ * @brief	Moves an object's box.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	proxy 	The proxy.
+ * @param	boxMin	The minimum corner of the new world box.
+ * @param	boxMax	The maximum corner of the new world box.
+ *
+ * @return	true if the leaf had to be refit.
+ */
+bool DynamicBVH::update(int proxy, const float boxMin[3], const float boxMax[3]){
+	Node &n = nodes[proxy];
+	bool inside = true;
+
+	for(int i = 0; i < 3; ++i){
+		n.objMin[i] = boxMin[i];
+		n.objMax[i] = boxMax[i];
+		if(boxMin[i] < n.boxMin[i] || boxMax[i] > n.boxMax[i])
+			inside = false;
+	}
+	if(inside)
+		return false;
+
+	for(int i = 0; i < 3; ++i){
+		n.boxMin[i] = boxMin[i] - margin;
+		n.boxMax[i] = boxMax[i] + margin;
+	}
+	refit(n.parent);
+	return true;
+}
+
+/**
+ * @fn	void DynamicBVH::refit(int node)
+ *
+ * @brief	Fits each branch from 'node' up to the root around its children again, stopping early at
+ * 			one that hasn't changed, since nothing above it will have either
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node	The lowest branch to refit, or NULL_NODE.
+ */
+void DynamicBVH::refit(int node){
+	while(node != NULL_NODE){
+		Node &n = nodes[node];
+		const Node &c0 = nodes[n.child[0]];
+		const Node &c1 = nodes[n.child[1]];
+		float newMin[3], newMax[3];
+
+		unionBox(newMin, newMax, c0.boxMin, c0.boxMax, c1.boxMin, c1.boxMax);
+		if(newMin[0] == n.boxMin[0] && newMin[1] == n.boxMin[1] && newMin[2] == n.boxMin[2] &&
+			newMax[0] == n.boxMax[0] && newMax[1] == n.boxMax[1] && newMax[2] == n.boxMax[2])
+			break;
+
+		branchArea -= area(n.boxMin, n.boxMax);
+		for(int i = 0; i < 3; ++i){
+			n.boxMin[i] = newMin[i];
+			n.boxMax[i] = newMax[i];
+		}
+		branchArea += area(n.boxMin, n.boxMax);
+		node = n.parent;
+	}
+}
+
+/**
+ * @fn	void DynamicBVH::rebuild()
+ *
+ * @brief	Builds the branches top down. Each range of leaves is split along the longest axis of
+ * 			their centers: the centers are dropped into NUM_BINS buckets, and the split between buckets
+ * 			that gives the smallest area times count on the two sides wins (Wald, "On fast Construction
+ * 			of SAH-based Bounding Volume Hierarchies"). Uses a stack of tasks rather than recursion, so
+ * 			a lopsided scene can't run out of stack
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void DynamicBVH::rebuild(){
+	buildLeaves.clear();
+	buildCenters.resize(nodes.size()*3);
+
+	// keep the leaves where they are, so proxies stay good, and free everything else
+	freeList = NULL_NODE;
+	for(int i = (int)nodes.size() - 1; i >= 0; --i){
+		if(nodes[i].obj == NULL){
+			freeNode(i);
+			continue;
+		}
+		buildLeaves.push_back(i);
+		for(int k = 0; k < 3; ++k)
+			buildCenters[i*3 + k] = (nodes[i].boxMin[k] + nodes[i].boxMax[k])*0.5f;
+	}
+
+	root = NULL_NODE;
+	branchArea = 0.0f;
+
+	vector<BuildTask> tasks;
+	BuildTask first = {0, (int)buildLeaves.size(), NULL_NODE, -1};
+	if(!buildLeaves.empty())
+		tasks.push_back(first);
+
+	while(!tasks.empty()){
+		BuildTask task = tasks.back();
+		tasks.pop_back();
+
+		if(task.end - task.begin == 1){
+			setChild(task.parent, task.slot, buildLeaves[task.begin]);
+			continue;
+		}
+
+		// the box around the range, and around its centers
+		float boxMin[3], boxMax[3], centerMin[3], centerMax[3];
+		const Node &firstLeaf = nodes[buildLeaves[task.begin]];
+		for(int k = 0; k < 3; ++k){
+			boxMin[k] = firstLeaf.boxMin[k];
+			boxMax[k] = firstLeaf.boxMax[k];
+			centerMin[k] = centerMax[k] = buildCenters[buildLeaves[task.begin]*3 + k];
+		}
+		for(int i = task.begin + 1; i < task.end; ++i){
+			const Node &n = nodes[buildLeaves[i]];
+			const float *c = &buildCenters[buildLeaves[i]*3];
+			unionBox(boxMin, boxMax, boxMin, boxMax, n.boxMin, n.boxMax);
+			unionBox(centerMin, centerMax, centerMin, centerMax, c, c);
+		}
+
+		int axis = 0;
+		for(int k = 1; k < 3; ++k){
+			if(centerMax[k] - centerMin[k] > centerMax[axis] - centerMin[axis])
+				axis = k;
+		}
+
+		int mid = (task.begin + task.end)/2;
+		float extent = centerMax[axis] - centerMin[axis];
+		if(extent > 0.0f){
+			int binCount[NUM_BINS];
+			float binMin[NUM_BINS][3], binMax[NUM_BINS][3];
+			InLowerBins lower = {&buildCenters[0], axis, centerMin[axis], NUM_BINS/extent, 0};
+
+			for(int b = 0; b < NUM_BINS; ++b){
+				binCount[b] = 0;
+				for(int k = 0; k < 3; ++k){
+					binMin[b][k] = FLT_MAX;
+					binMax[b][k] = -FLT_MAX;
+				}
+			}
+			for(int i = task.begin; i < task.end; ++i){
+				const Node &n = nodes[buildLeaves[i]];
+				int b = (int)((buildCenters[buildLeaves[i]*3 + axis] - lower.origin)*lower.scale);
+				if(b >= NUM_BINS)
+					b = NUM_BINS - 1;
+				++binCount[b];
+				unionBox(binMin[b], binMax[b], binMin[b], binMax[b], n.boxMin, n.boxMax);
+			}
+
+			// sweep from the right for the cost of everything above each split, then from the left
+			float rightCost[NUM_BINS];
+			float sweepMin[3], sweepMax[3];
+			int count = 0;
+			for(int k = 0; k < 3; ++k){
+				sweepMin[k] = FLT_MAX;
+				sweepMax[k] = -FLT_MAX;
+			}
+			for(int b = NUM_BINS - 1; b > 0; --b){
+				count += binCount[b];
+				unionBox(sweepMin, sweepMax, sweepMin, sweepMax, binMin[b], binMax[b]);
+				rightCost[b] = count > 0 ? count*area(sweepMin, sweepMax) : 0.0f;
+			}
+
+			float bestCost = FLT_MAX;
+			int leftCount = 0;
+			for(int k = 0; k < 3; ++k){
+				sweepMin[k] = FLT_MAX;
+				sweepMax[k] = -FLT_MAX;
+			}
+			for(int b = 0; b < NUM_BINS - 1; ++b){
+				leftCount += binCount[b];
+				unionBox(sweepMin, sweepMax, sweepMin, sweepMax, binMin[b], binMax[b]);
+				if(leftCount == 0 || leftCount == task.end - task.begin)
+					continue;
+
+				float cost = leftCount*area(sweepMin, sweepMax) + rightCost[b + 1];
+				if(cost < bestCost){
+					bestCost = cost;
+					lower.split = b;
+				}
+			}
+			if(bestCost < FLT_MAX)
+				mid = (int)(partition(buildLeaves.begin() + task.begin, buildLeaves.begin() + task.end, lower) - buildLeaves.begin());
+		}
+
+		int branch = allocateNode();
+		for(int k = 0; k < 3; ++k){
+			nodes[branch].boxMin[k] = boxMin[k];
+			nodes[branch].boxMax[k] = boxMax[k];
+		}
+		branchArea += area(boxMin, boxMax);
+		setChild(task.parent, task.slot, branch);
+
+		BuildTask left = {task.begin, mid, branch, 0};
+		BuildTask right = {mid, task.end, branch, 1};
+		tasks.push_back(left);
+		tasks.push_back(right);
+	}
+	builtArea = branchArea;
+}
+
+/**
+ * @fn	void DynamicBVH::clear()
+ *
+ * @brief	Removes every object.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void DynamicBVH::clear(){
+	nodes.clear();
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+	numLeaves = 0;
+	branchArea = 0.0f;
+	builtArea = 0.0f;
+}
+
+/**
+ * @fn	int DynamicBVH::getHeight()
+ *
+ * @brief	Gets the height of the tree.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The height.
+ */
+int DynamicBVH::getHeight(){
+	vector<int> stack;
+	vector<int> depths;
+	int height = 0;
+
+	if(root != NULL_NODE){
+		stack.push_back(root);
+		depths.push_back(1);
+	}
+	while(!stack.empty()){
+		int node = stack.back();
+		int depth = depths.back();
+		stack.pop_back();
+		depths.pop_back();
+
+		if(depth > height)
+			height = depth;
+		if(!nodes[node].isLeaf()){
+			for(int c = 0; c < 2; ++c){
+				stack.push_back(nodes[node].child[c]);
+				depths.push_back(depth + 1);
+			}
+		}
+	}
+	return height;
+}
+
+/**
+ * @fn	int DynamicBVH::queryBox(const float boxMin[3], const float boxMax[3],
+ * 		vector<DrawableObject*> &results)
+ *
+ * @brief	Finds the objects whose world boxes overlap a box.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	boxMin		   	The minimum corner.
+ * @param	boxMax		   	The maximum corner.
+ * @param [out]	results	The objects.
+ *
+ * @return	The number of objects found.
+ */
+int DynamicBVH::queryBox(const float boxMin[3], const float boxMax[3], vector<DrawableObject*> &results){
+	vector<int> stack;
+
+	results.clear();
+	if(root != NULL_NODE)
+		stack.push_back(root);
+	while(!stack.empty()){
+		const Node &n = nodes[stack.back()];
+		stack.pop_back();
+
+		if(!overlaps(n.boxMin, n.boxMax, boxMin, boxMax))
+			continue;
+		if(!n.isLeaf()){
+			stack.push_back(n.child[0]);
+			stack.push_back(n.child[1]);
+		}else if(overlaps(n.objMin, n.objMax, boxMin, boxMax)){
+			results.push_back(n.obj);
+		}
+	}
+	return (int)results.size();
+}
+
+/**
+ * @fn	int DynamicBVH::querySphere(const float center[3], float radius,
+ * 		vector<DrawableObject*> &results)
+ *
+ * @brief	Finds the objects whose world boxes come within 'radius' of a point.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	center		   	The center of the sphere.
+ * @param	radius		   	The radius.
+ * @param [out]	results	The objects.
+ *
+ * @return	The number of objects found.
+ */
+int DynamicBVH::querySphere(const float center[3], float radius, vector<DrawableObject*> &results){
+	vector<int> stack;
+	float radiusSq = radius*radius;
+
+	results.clear();
+	if(root != NULL_NODE)
+		stack.push_back(root);
+	while(!stack.empty()){
+		const Node &n = nodes[stack.back()];
+		stack.pop_back();
+
+		if(!touchesSphere(n.boxMin, n.boxMax, center, radiusSq))
+			continue;
+		if(!n.isLeaf()){
+			stack.push_back(n.child[0]);
+			stack.push_back(n.child[1]);
+		}else if(touchesSphere(n.objMin, n.objMax, center, radiusSq)){
+			results.push_back(n.obj);
+		}
+	}
+	return (int)results.size();
+}
+
+/**
+ * @fn	int DynamicBVH::queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results)
+ *
+ * @brief	Finds the objects whose world boxes might be inside a frustum. The stack holds a node
+ * 			and whether it is already known to be inside
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	frustum	The frustum.
+ * @param [out]	results	   	The objects.
+ *
+ * @return	The number of objects found.
+ */
+int DynamicBVH::queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results){
+	vector<int> stack;
+	vector<unsigned char> inside;
+
+	results.clear();
+	if(root != NULL_NODE){
+		stack.push_back(root);
+		inside.push_back(0);
+	}
+	while(!stack.empty()){
+		const Node &n = nodes[stack.back()];
+		bool known = inside.back() != 0;
+		stack.pop_back();
+		inside.pop_back();
+
+		if(n.isLeaf()){
+			if(known || frustum.classifyBox(n.objMin, n.objMax) != FrustumCuller::BOX_OUTSIDE)
+				results.push_back(n.obj);
+			continue;
+		}
+		if(!known){
+			FrustumCuller::BOX_CLASS c = frustum.classifyBox(n.boxMin, n.boxMax);
+			if(c == FrustumCuller::BOX_OUTSIDE)
+				continue;
+			known = (c == FrustumCuller::BOX_INSIDE);
+		}
+		for(int c = 0; c < 2; ++c){
+			stack.push_back(n.child[c]);
+			inside.push_back(known ? 1 : 0);
+		}
+	}
+	return (int)results.size();
+}
+
+/**
+ * @fn	int DynamicBVH::queryRay(const M3DVector3f origin, const M3DVector3f dir, float maxDistance,
+ * 		vector<DrawableObject*> &results)
+ *
+ * @brief	Finds the objects whose world boxes a ray passes through before 'maxDistance'.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	origin		   	The start of the ray.
+ * @param	dir			   	The unit direction of the ray.
+ * @param	maxDistance	   	How far along the ray to look.
+ * @param [out]	results	The objects.
+ *
+ * @return	The number of objects found.
+ */
+int DynamicBVH::queryRay(const M3DVector3f origin, const M3DVector3f dir, float maxDistance, vector<DrawableObject*> &results){
+	vector<int> stack;
+	float distance;
+
+	results.clear();
+	if(root != NULL_NODE)
+		stack.push_back(root);
+	while(!stack.empty()){
+		const Node &n = nodes[stack.back()];
+		stack.pop_back();
+
+		if(!RayCaster::rayAABB(origin, dir, n.boxMin, n.boxMax, distance) || distance > maxDistance)
+			continue;
+		if(!n.isLeaf()){
+			stack.push_back(n.child[0]);
+			stack.push_back(n.child[1]);
+		}else if(RayCaster::rayAABB(origin, dir, n.objMin, n.objMax, distance) && distance <= maxDistance){
+			results.push_back(n.obj);
+		}
+	}
+	return (int)results.size();
+}
+
+/**
+ * @fn	void DynamicBVH::castRay(const M3DVector3f origin, const M3DVector3f dir,
+ * 		vector<RayCaster::Hit> &hits)
+ *
+ * @brief	Tests the objects along a ray with DrawableObject::rayIntersect().
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	origin			The start of the ray.
+ * @param	dir				The unit direction of the ray.
+ * @param [out]	hits		The objects hit, nearest first.
+ */
+void DynamicBVH::castRay(const M3DVector3f origin, const M3DVector3f dir, vector<RayCaster::Hit> &hits){
+	vector<DrawableObject*> candidates;
+	RayCaster::Hit hit;
+
+	hits.clear();
+	queryRay(origin, dir, FLT_MAX, candidates);
+	for(unsigned int i = 0; i < candidates.size(); ++i){
+		if(candidates[i]->rayIntersect(origin, dir, hit.distance)){
+			hit.obj = candidates[i];
+			hits.push_back(hit);
+		}
+	}
+	sort(hits.begin(), hits.end());
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <math3d.h>
+#include <vector>
+#include "RayCaster.h"
+#include "FrustumCuller.h"
+
+using namespace std;
+
+class DrawableObject;
+
+/**
+ * @class	DynamicBVH
+ *
+ * @brief	A bounding volume hierarchy over the world boxes of DrawableObjects, so that a frustum,
+ * 			ray, sphere or box query only visits the branches it overlaps instead of every object.
+ *
+ * 			Each object is a leaf, found again by the proxy that insert() returns. A leaf's box is
+ * 			padded by a margin, so an object that moves a little stays inside it and update() has
+ * 			nothing to do. When it does move out, the leaf is refit and so is each parent above it,
+ * 			but the shape of the tree stays as it is. Enough refits leave the tree loose, so
+ * 			needsRebuild() compares the total area of the branches with what it was after the last
+ * 			rebuild(), which builds the whole tree again top down by the surface area heuristic.
+ *
+ * 			Nodes live in one array and are linked by index, and a proxy is the index of its leaf, so
+ * 			proxies stay good across rebuild().
+ *
+ * 			Not thread safe; Gl_ShaderWindow only touches its tree while holding its scene lock.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class DynamicBVH
+{
+public:
+
+	/**
+	 * @summary	The index that means no node
+	 */
+	static const int NULL_NODE = -1;
+
+	/**
+	 * @fn	DynamicBVH::DynamicBVH(float margin = 0.1f);
+	 *
+	 * @brief	Constructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	margin	How far each leaf's box is padded on every side.
+	 */
+	DynamicBVH(float margin = 0.1f);
+
+	/**
+	 * @fn	DynamicBVH::~DynamicBVH(void);
+	 *
+	 * @brief	Destructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~DynamicBVH(void);
+
+	/**
+	 * @fn	int DynamicBVH::insert(DrawableObject *obj, const float boxMin[3], const float boxMax[3]);
+	 *
+	 * @brief	Adds an object. The leaf goes next to whichever node grows the tree's area the least
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	obj	The object.
+	 * @param	boxMin	   	The minimum corner of its world box.
+	 * @param	boxMax	   	The maximum corner of its world box.
+	 *
+	 * @return	The proxy for update() and remove().
+	 */
+	int insert(DrawableObject *obj, const float boxMin[3], const float boxMax[3]);
+
+	/**
+	 * @fn	void DynamicBVH::remove(int proxy);
+	 *
+	 * @brief	Removes an object. Its sibling takes its parent's place
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	proxy	The proxy from insert().
+	 */
+	void remove(int proxy);
+
+	/**
+	 * @fn	bool DynamicBVH::update(int proxy, const float boxMin[3], const float boxMax[3]);
+	 *
+	 * @brief	Moves an object's box. Nothing happens while the box stays inside the padded one
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	proxy 	The proxy from insert().
+	 * @param	boxMin	The minimum corner of the new world box.
+	 * @param	boxMax	The maximum corner of the new world box.
+	 *
+	 * @return	true if the leaf had to be refit.
+	 */
+	bool update(int proxy, const float boxMin[3], const float boxMax[3]);
+
+	/**
+	 * @fn	void DynamicBVH::rebuild();
+	 *
+	 * @brief	Throws the branches away and builds them again by the surface area heuristic, from the
+	 * 			leaves as they are now. The proxies don't change
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void rebuild();
+
+	/**
+	 * @fn	bool DynamicBVH::needsRebuild()
+	 *
+	 * @brief	Query if refits and inserts have grown the total area of the branches past the rebuild
+	 * 			ratio times what it was after the last rebuild()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if rebuild() would be worth it.
+	 */
+	bool needsRebuild(){	return numLeaves > 2 && branchArea > builtArea*rebuildRatio;	};
+
+	/**
+	 * @fn	void DynamicBVH::setRebuildRatio(float ratio)
+	 *
+	 * @brief	Sets how much the branches' area can grow before needsRebuild() says so. The default
+	 * 			is 1.5
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	ratio	The ratio.
+	 */
+	void setRebuildRatio(float ratio){	rebuildRatio = ratio;	};
+
+	/**
+	 * @fn	void DynamicBVH::clear();
+	 *
+	 * @brief	Removes every object
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void clear();
+
+	/**
+	 * @fn	int DynamicBVH::getNumObjects()
+	 *
+	 * @brief	Gets the number of objects.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of objects.
+	 */
+	int getNumObjects(){	return numLeaves;	};
+
+	/**
+	 * @fn	int DynamicBVH::getHeight();
+	 *
+	 * @brief	Gets the number of levels from the root to the deepest leaf.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The height, 0 when empty.
+	 */
+	int getHeight();
+
+	/**
+	 * @fn	DrawableObject* DynamicBVH::getObject(int proxy)
+	 *
+	 * @brief	Gets the object a proxy was inserted with.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	proxy	The proxy.
+	 *
+	 * @return	The object.
+	 */
+	DrawableObject* getObject(int proxy){	return nodes[proxy].obj;	};
+
+	/**
+	 * @fn	int DynamicBVH::queryBox(const float boxMin[3], const float boxMax[3],
+	 * 		vector<DrawableObject*> &results);
+	 *
+	 * @brief	Finds the objects whose world boxes overlap a box
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	boxMin		   	The minimum corner.
+	 * @param	boxMax		   	The maximum corner.
+	 * @param [out]	results	The objects.
+	 *
+	 * @return	The number of objects found.
+	 */
+	int queryBox(const float boxMin[3], const float boxMax[3], vector<DrawableObject*> &results);
+
+	/**
+	 * @fn	int DynamicBVH::querySphere(const float center[3], float radius,
+	 * 		vector<DrawableObject*> &results);
+	 *
+	 * @brief	Finds the objects whose world boxes come within 'radius' of a point
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	center		   	The center of the sphere.
+	 * @param	radius		   	The radius.
+	 * @param [out]	results	The objects.
+	 *
+	 * @return	The number of objects found.
+	 */
+	int querySphere(const float center[3], float radius, vector<DrawableObject*> &results);
+
+	/**
+	 * @fn	int DynamicBVH::queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results);
+	 *
+	 * @brief	Finds the objects whose world boxes might be inside a frustum. Once a branch is wholly
+	 * 			inside, everything under it is taken without further tests
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	frustum	The frustum, with planes in the same space as the boxes.
+	 * @param [out]	results	   	The objects.
+	 *
+	 * @return	The number of objects found.
+	 */
+	int queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results);
+
+	/**
+	 * @fn	int DynamicBVH::queryRay(const M3DVector3f origin, const M3DVector3f dir, float maxDistance,
+	 * 		vector<DrawableObject*> &results);
+	 *
+	 * @brief	Finds the objects whose world boxes a ray passes through before 'maxDistance'
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	origin		   	The start of the ray.
+	 * @param	dir			   	The unit direction of the ray.
+	 * @param	maxDistance	   	How far along the ray to look.
+	 * @param [out]	results	The objects.
+	 *
+	 * @return	The number of objects found.
+	 */
+	int queryRay(const M3DVector3f origin, const M3DVector3f dir, float maxDistance, vector<DrawableObject*> &results);
+
+	/**
+	 * @fn	void DynamicBVH::castRay(const M3DVector3f origin, const M3DVector3f dir,
+	 * 		vector<RayCaster::Hit> &hits);
+	 *
+	 * @brief	RayCaster::castRay() over the tree: the objects whose boxes the ray passes through are
+	 * 			tested with DrawableObject::rayIntersect()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	origin			The start of the ray.
+	 * @param	dir				The unit direction of the ray.
+	 * @param [out]	hits		The objects hit, nearest first.
+	 */
+	void castRay(const M3DVector3f origin, const M3DVector3f dir, vector<RayCaster::Hit> &hits);
+
+protected:
+
+	/**
+	 * @struct	Node
+	 *
+	 * @brief	A branch, with two children, or a leaf, with an object. A leaf keeps the object's own
+	 * 			box as well as the padded one, so queries can be exact. Free nodes are chained through
+	 * 			'parent'
+	 */
+	struct Node
+	{
+		float boxMin[3];
+		float boxMax[3];
+		float objMin[3];
+		float objMax[3];
+		int parent;
+		int child[2];
+		DrawableObject *obj;
+
+		bool isLeaf() const {	return child[0] == NULL_NODE;	};
+	};
+
+	/**
+	 * @struct	BuildTask
+	 *
+	 * @brief	A range of leaves for rebuild() to put under one node
+	 */
+	struct BuildTask
+	{
+		int begin;
+		int end;
+		int parent;
+		int slot;	// which child of parent, or -1 for the root
+	};
+
+	int allocateNode();
+	void freeNode(int node);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	void refit(int node);
+	void setChild(int parent, int slot, int child);
+
+	static float area(const float boxMin[3], const float boxMax[3]);
+
+	/**
+	 * @summary	Every node, used or free
+	 */
+	vector<Node> nodes;
+	int root;
+	int freeList;
+	int numLeaves;
+
+	/**
+	 * @summary	How far each leaf's box is padded
+	 */
+	float margin;
+
+	/**
+	 * @summary	The summed area of every branch now and after the last rebuild(), and how far the one
+	 * 			may outgrow the other
+	 */
+	float branchArea;
+	float builtArea;
+	float rebuildRatio;
+
+	/**
+	 * @summary	Scratch for rebuild(): the leaves and their centers
+	 */
+	vector<int> buildLeaves;
+	vector<float> buildCenters;
+};
@@ -0,0 +1,107 @@
+#include "StdAfx.h"
+#include "FrameClock.h"
+
+/**
+ * @fn	FrameClock::FrameClock(void)
+ *
+ * @brief	Constructor. Starts at time zero
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+FrameClock::FrameClock(void)
+{
+	LARGE_INTEGER freq;
+
+	QueryPerformanceFrequency(&freq);
+	frequency = freq.QuadPart;
+	fixedStep = 0.0;
+	maxStep = 0.25;
+	reset();
+}
+
+/**
+ * @fn	void FrameClock::reset()
+ *
+ * @brief	Goes back to time zero and frame zero, and measures the next step from now
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void FrameClock::reset(){
+	lastCount = now();
+	time = 0.0;
+	deltaTime = 0.0f;
+	frame = 0;
+}
+
+/**
+ * @fn	void FrameClock::tick()
+ *
+ * @brief	Stamps a frame with the wall time since the last stamp, or the fixed step if one is set
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void FrameClock::tick(){
+	LONGLONG count = now();
+	double step;
+
+	if(fixedStep > 0.0){
+		step = fixedStep;
+	}else{
+		step = (double)(count - lastCount)/frequency;
+		if(step > maxStep)
+			step = maxStep;
+	}
+	stamp(step, count);
+}
+
+/**
+ * @fn	void FrameClock::advance(double seconds)
+ *
+ * @brief	Stamps a frame that is exactly 'seconds' long
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	seconds	The step.
+ */
+void FrameClock::advance(double seconds){
+	stamp(seconds, now());
+}
+
+/**
+ * @fn	void FrameClock::stamp(double step, LONGLONG count)
+ *
+ * @brief	Records a step ending at performance counter value 'count'. Every kind of stamp moves
+ * 			lastCount on, so switching from fixed steps back to tick() doesn't produce one huge step
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	step 	The step in seconds.
+ * @param	count	The counter value at the end of the step.
+ */
+void FrameClock::stamp(double step, LONGLONG count){
+	deltaTime = (float)step;
+	time += step;
+	lastCount = count;
+	++frame;
+}
+
+/**
+ * @fn	LONGLONG FrameClock::now()
+ *
+ * @brief	Reads the performance counter
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The current count.
+ */
+LONGLONG FrameClock::now(){
+	LARGE_INTEGER t;
+	QueryPerformanceCounter(&t);
+	return t.QuadPart;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <windows.h>
+
+/**
+ * @class	FrameClock
+ *
+ * @brief	The one clock that the whole scene runs on. Gl_ShaderWindow stamps it once per
+ * 			environmentCalc() and hands the step and the absolute time to every DrawableObject, so all
+ * 			objects see the same numbers no matter which thread updates them. It reads the performance
+ * 			counter, which is wall time and monotonic, unlike clock() (process CPU time on most
+ * 			platforms, and coarse on Windows).
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class FrameClock
+{
+public:
+
+	/**
+	 * @fn	FrameClock::FrameClock(void);
+	 *
+	 * @brief	Constructor. Starts at time zero
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	FrameClock(void);
+
+	/**
+	 * @fn	void FrameClock::reset();
+	 *
+	 * @brief	Goes back to time zero and frame zero, and measures the next step from now
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void reset();
+
+	/**
+	 * @fn	void FrameClock::tick();
+	 *
+	 * @brief	Stamps a frame. The step is the wall time since the last stamp (limited to the maximum
+	 * 			step), or the fixed step if one is set
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void tick();
+
+	/**
+	 * @fn	void FrameClock::advance(double seconds);
+	 *
+	 * @brief	Stamps a frame that is exactly 'seconds' long, e.g. one fixed simulation step
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	seconds	The step.
+	 */
+	void advance(double seconds);
+
+	/**
+	 * @fn	void FrameClock::setFixedStep(double seconds)
+	 *
+	 * @brief	Makes tick() advance by a constant step instead of the measured time. Used for headless
+	 * 			runs and replays so that they are repeatable
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	seconds	The step, or 0 to go back to measuring wall time.
+	 */
+	void setFixedStep(double seconds){	fixedStep = seconds;	};
+
+	/**
+	 * @fn	void FrameClock::setMaxStep(double seconds)
+	 *
+	 * @brief	Limits the step that tick() measures, so that a stall (a debugger break, a dragged
+	 * 			window) doesn't make everything jump. Defaults to 0.25 seconds
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	seconds	The largest step.
+	 */
+	void setMaxStep(double seconds){	maxStep = seconds;	};
+
+	float getDeltaTime(){	return deltaTime;	};
+	double getTime(){	return time;	};
+	unsigned int getFrame(){	return frame;	};
+
+protected:
+
+	/**
+	 * @fn	void FrameClock::stamp(double step, LONGLONG count);
+	 *
+	 * @brief	Records a step ending at performance counter value 'count'
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	step 	The step in seconds.
+	 * @param	count	The counter value at the end of the step.
+	 */
+	void stamp(double step, LONGLONG count);
+
+	/**
+	 * @fn	LONGLONG FrameClock::now();
+	 *
+	 * @brief	Reads the performance counter
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The current count.
+	 */
+	LONGLONG now();
+
+	LONGLONG frequency;
+	LONGLONG lastCount;
+	double time;
+	float deltaTime;
+	double fixedStep;
+	double maxStep;
+	unsigned int frame;
+};
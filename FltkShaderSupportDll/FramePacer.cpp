@@ -0,0 +1,168 @@
+#include "StdAfx.h"
+#include "FramePacer.h"
+#include <GLTools.h>	// OpenGL toolkit
+
+typedef BOOL (WINAPI *SwapIntervalProc)(int interval);
+
+static const double earlySeconds = 0.002; // comfortably more than the 1 ms timer period
+static const double spinSeconds = 0.001; // a Sleep(1) could overshoot from here on
+
+/**
+ * @fn	FramePacer::FramePacer(void)
+ *
+ * @brief	Constructor. Defaults to a 1/100 second interval
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+FramePacer::FramePacer(void)
+{
+	LARGE_INTEGER freq;
+
+	QueryPerformanceFrequency(&freq);
+	frequency = freq.QuadPart;
+	earlyCounts = (LONGLONG)(earlySeconds*frequency);
+	spinCounts = (LONGLONG)(spinSeconds*frequency);
+
+	// FLTK's timeouts are only as fine as the system timer, which defaults to about 15 ms
+	timeBeginPeriod(1);
+
+	frameCostMs = 0.0f;
+	latenessMs = 0.0f;
+	numFrames = 0;
+	missedDeadlines = 0;
+	inFrame = false;
+	frameStart = 0;
+	setTargetInterval(0.01);
+}
+
+FramePacer::~FramePacer(void)
+{
+	timeEndPeriod(1);
+}
+
+/**
+ * @fn	void FramePacer::setTargetInterval(double seconds)
+ *
+ * @brief	Sets the time between frames, and restarts the schedule
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	seconds	The interval in seconds.
+ */
+void FramePacer::setTargetInterval(double seconds){
+	targetInterval = seconds;
+	intervalCounts = (LONGLONG)(seconds*frequency);
+	deadline = 0; // the next beginFrame() starts a new schedule
+}
+
+/**
+ * @fn	bool FramePacer::setSwapInterval(int interval)
+ *
+ * @brief	Sets how many vertical blanks a buffer swap waits for with wglSwapIntervalEXT.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	interval	The swap interval.
+ *
+ * @return	false if the driver doesn't have WGL_EXT_swap_control.
+ */
+bool FramePacer::setSwapInterval(int interval){
+	SwapIntervalProc swapInterval = (SwapIntervalProc)wglGetProcAddress("wglSwapIntervalEXT");
+
+	if(swapInterval == NULL){
+		fprintf(stderr, "FramePacer::setSwapInterval() WGL_EXT_swap_control is not supported\n");
+		return false;
+	}
+	return swapInterval(interval) != FALSE;
+}
+
+/**
+ * @fn	void FramePacer::beginFrame()
+ *
+ * @brief	Called at the start of a frame. Sleeps, then spins, out whatever is left before the
+ * 			deadline, then checks whether the deadline was missed and moves it on by one interval
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void FramePacer::beginFrame(){
+	LONGLONG t = now();
+
+	if(deadline == 0)
+		deadline = t;
+
+	// the timer was aimed early, so this is normally a sleep or two. Only the last fraction of a
+	// millisecond, which the 1 ms timer period can't resolve, is spun
+	while(deadline - t > spinCounts){
+		Sleep(1);
+		t = now();
+	}
+	while(t < deadline){
+		YieldProcessor();
+		t = now();
+	}
+
+	latenessMs = (float)((t - deadline)*1000.0/frequency);
+	if(t - deadline > intervalCounts/10){
+		++missedDeadlines;
+		deadline = t; // start again from here instead of bunching up frames to catch up
+	}
+	deadline += intervalCounts;
+
+	frameStart = t;
+	inFrame = true;
+	++numFrames;
+}
+
+/**
+ * @fn	void FramePacer::endFrame()
+ *
+ * @brief	Called when the frame's work is done, to measure its cost
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void FramePacer::endFrame(){
+	if(!inFrame)
+		return;
+
+	frameCostMs = (float)((now() - frameStart)*1000.0/frequency);
+	inFrame = false;
+}
+
+/**
+ * @fn	double FramePacer::getDelay()
+ *
+ * @brief	Gets the time to hand to Fl::add_timeout() for the next frame
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The delay in seconds, never negative.
+ */
+double FramePacer::getDelay(){
+	LONGLONG remaining = deadline - now() - earlyCounts;
+
+	if(deadline == 0 || remaining <= 0)
+		return 0.0;
+	return (double)remaining/frequency;
+}
+
+/**
+ * @fn	LONGLONG FramePacer::now()
+ *
+ * @brief	Reads the performance counter
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The current count.
+ */
+LONGLONG FramePacer::now(){
+	LARGE_INTEGER t;
+	QueryPerformanceCounter(&t);
+	return t.QuadPart;
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <windows.h>
+
+/**
+ * @class	FramePacer
+ *
+ * @brief	Schedules frames against a fixed interval. Deadlines are absolute (each one is the last
+ * 			plus the interval), so the schedule doesn't drift the way chaining Fl::repeat_timeout()
+ * 			calls does, and the time the frame itself took is taken out of the wait. The wait is split
+ * 			into a coarse timer (FLTK's timeout, with the system timer period raised to 1 ms) that is
+ * 			aimed a little early, then 1 ms sleeps in beginFrame(), and a spin over the last fraction
+ * 			of a millisecond that lands on the deadline.
+ *
+ * 			A frame that starts more than a tenth of an interval after its deadline counts as a missed
+ * 			deadline. The schedule then restarts from the late frame rather than rushing to catch up.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class FramePacer
+{
+public:
+
+	/**
+	 * @fn	FramePacer::FramePacer(void);
+	 *
+	 * @brief	Constructor. Defaults to a 1/100 second interval
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	FramePacer(void);
+
+	/**
+	 * @fn	FramePacer::~FramePacer(void);
+	 *
+	 * @brief	Destructor. Puts the system timer period back
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~FramePacer(void);
+
+	/**
+	 * @fn	void FramePacer::setTargetInterval(double seconds);
+	 *
+	 * @brief	Sets the time between frames, and restarts the schedule
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	seconds	The interval in seconds.
+	 */
+	void setTargetInterval(double seconds);
+
+	/**
+	 * @fn	double FramePacer::getTargetInterval()
+	 *
+	 * @brief	Gets the time between frames.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The interval in seconds.
+	 */
+	double getTargetInterval(){	return targetInterval;	};
+
+	/**
+	 * @fn	static bool FramePacer::setSwapInterval(int interval);
+	 *
+	 * @brief	Sets how many vertical blanks a buffer swap waits for (0 is off, 1 is vsync) with
+	 * 			wglSwapIntervalEXT. Must be called with the GL context current.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	interval	The swap interval.
+	 *
+	 * @return	false if the driver doesn't have WGL_EXT_swap_control.
+	 */
+	static bool setSwapInterval(int interval);
+
+	/**
+	 * @fn	void FramePacer::beginFrame();
+	 *
+	 * @brief	Called at the start of a frame. Sleeps, then spins, out whatever is left before the
+	 * 			deadline, then checks whether the deadline was missed and moves it on by one interval
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void beginFrame();
+
+	/**
+	 * @fn	void FramePacer::endFrame();
+	 *
+	 * @brief	Called when the frame's work (including the draw and the swap) is done, to measure its
+	 * 			cost. Does nothing if there is no frame in progress
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void endFrame();
+
+	/**
+	 * @fn	double FramePacer::getDelay();
+	 *
+	 * @brief	Gets the time to hand to Fl::add_timeout() for the next frame: the time left until the
+	 * 			deadline, less the early margin
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The delay in seconds, never negative.
+	 */
+	double getDelay();
+
+	/**
+	 * @fn	bool FramePacer::isInFrame()
+	 *
+	 * @brief	Query if beginFrame() has been called without a matching endFrame().
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if a frame is in progress.
+	 */
+	bool isInFrame(){	return inFrame;	};
+
+	/**
+	 * @fn	float FramePacer::getFrameCostMs()
+	 *
+	 * @brief	Gets the cost of the last frame, from beginFrame() to endFrame()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The cost in milliseconds.
+	 */
+	float getFrameCostMs(){	return frameCostMs;	};
+
+	/**
+	 * @fn	float FramePacer::getLatenessMs()
+	 *
+	 * @brief	Gets how far after its deadline the last frame started
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The lateness in milliseconds, zero if it was on time.
+	 */
+	float getLatenessMs(){	return latenessMs;	};
+
+	int getNumFrames(){	return numFrames;	};
+	int getMissedDeadlines(){	return missedDeadlines;	};
+
+	/**
+	 * @fn	void FramePacer::resetStats()
+	 *
+	 * @brief	Zeroes the frame and missed deadline counts
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void resetStats(){	numFrames = missedDeadlines = 0;	};
+
+protected:
+
+	/**
+	 * @fn	LONGLONG FramePacer::now();
+	 *
+	 * @brief	Reads the performance counter
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The current count.
+	 */
+	LONGLONG now();
+
+	/**
+	 * @summary	Counts per second of the performance counter
+	 */
+	LONGLONG frequency;
+
+	/**
+	 * @summary	The target interval, in seconds and in counts
+	 */
+	double targetInterval;
+	LONGLONG intervalCounts;
+
+	/**
+	 * @summary	How early the timer is aimed, in counts, so that beginFrame() can wait out the rest
+	 */
+	LONGLONG earlyCounts;
+
+	/**
+	 * @summary	How close to the deadline beginFrame() stops sleeping and spins, in counts
+	 */
+	LONGLONG spinCounts;
+
+	/**
+	 * @summary	When the next frame should start, and when the current one did
+	 */
+	LONGLONG deadline;
+	LONGLONG frameStart;
+	bool inFrame;
+
+	float frameCostMs;
+	float latenessMs;
+	int numFrames;
+	int missedDeadlines;
+};
@@ -0,0 +1,307 @@
+#include "StdAfx.h"
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <string.h>
+
+/**
+ * @fn	FrameProfiler::FrameProfiler(void)
+ *
+ * @brief	Constructor. Reads the performance counter frequency. The profiler starts disabled
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+FrameProfiler::FrameProfiler(void)
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	msPerTick = 1000.0/(double)frequency.QuadPart;
+
+	numSections = 0;
+	enabled = false;
+	InitializeCriticalSection(&sectionLock);
+	InitializeCriticalSection(&sampleLock);
+}
+
+FrameProfiler::~FrameProfiler(void)
+{
+	DeleteCriticalSection(&sampleLock);
+	DeleteCriticalSection(&sectionLock);
+}
+
+/**
+ * @fn	static void writeJSONString(FILE *fp, const char *str)
+ *
+ * @brief	Writes a string as a quoted JSON string, escaping quotes, backslashes and control characters.
+ * 			Section names come from DrawableObject::setName(), so they can hold anything
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	fp	The file.
+ * @param	str		  	The string.
+ */
+static void writeJSONString(FILE *fp, const char *str){
+	fputc('"', fp);
+	for(const unsigned char *c = (const unsigned char*)str; *c != 0; ++c){
+		if(*c == '"' || *c == '\\')
+			fprintf(fp, "\\%c", *c);
+		else if(*c < 0x20)
+			fprintf(fp, "\\u%04x", *c);
+		else
+			fputc(*c, fp);
+	}
+	fputc('"', fp);
+}
+
+/**
+ * @fn	int FrameProfiler::getSection(const char *name)
+ *
+ * @brief	Finds the section with this name, creating it if it doesn't exist.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	name	The section name.
+ *
+ * @return	The section index, or -1 if there is no room for another section.
+ */
+int FrameProfiler::getSection(const char *name){
+	int i;
+	int found = -1;
+
+	EnterCriticalSection(&sectionLock);
+	for(i = 0; i < numSections; ++i){
+		if(strcmp(sections[i].name, name) == 0){
+			found = i;
+			break;
+		}
+	}
+
+	if(found < 0 && numSections < MAX_SECTIONS){
+		Section &s = sections[numSections];
+		strncpy_s(s.name, name, _TRUNCATE);
+		s.startTick = 0;
+		s.next = 0;
+		s.count = 0;
+		found = numSections;
+		InterlockedIncrement(&numSections); // publish only once the section is filled in
+	}
+	LeaveCriticalSection(&sectionLock);
+
+	return found;
+}
+
+/**
+ * @fn	void FrameProfiler::begin(int section)
+ *
+ * @brief	Starts timing a section.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	section	The section index.
+ */
+void FrameProfiler::begin(int section){
+	LARGE_INTEGER now;
+
+	if(!enabled || section < 0)
+		return;
+
+	QueryPerformanceCounter(&now);
+	sections[section].startTick = now.QuadPart;
+}
+
+/**
+ * @fn	void FrameProfiler::end(int section)
+ *
+ * @brief	Stops timing a section and records the elapsed time as a sample
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	section	The section index.
+ */
+void FrameProfiler::end(int section){
+	LARGE_INTEGER now;
+
+	if(!enabled || section < 0 || sections[section].startTick == 0)
+		return;
+
+	QueryPerformanceCounter(&now);
+	addSample(section, (float)((now.QuadPart - sections[section].startTick)*msPerTick));
+	sections[section].startTick = 0;
+}
+
+/**
+ * @fn	void FrameProfiler::addSample(int section, float ms)
+ *
+ * @brief	Records a sample in the section's ring buffer, overwriting the oldest one when it is full
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	section	The section index.
+ * @param	ms	   	The sample in milliseconds.
+ */
+void FrameProfiler::addSample(int section, float ms){
+	if(!enabled || section < 0 || section >= numSections)
+		return;
+
+	Section &s = sections[section];
+	EnterCriticalSection(&sampleLock);
+	s.samples[s.next] = ms;
+	s.next = (s.next + 1) % HISTORY_SIZE;
+	if(s.count < HISTORY_SIZE)
+		++s.count;
+	LeaveCriticalSection(&sampleLock);
+}
+
+/**
+ * @fn	bool FrameProfiler::getStats(int section, Stats &stats)
+ *
+ * @brief	Calculates the statistics for a section over its sample history
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	section		 	The section index.
+ * @param [in,out]	stats	The statistics.
+ *
+ * @return	false if the section doesn't exist or has no samples.
+ */
+bool FrameProfiler::getStats(int section, Stats &stats){
+	float sorted[HISTORY_SIZE];
+	float sum = 0.0f;
+	int i;
+
+	if(section < 0 || section >= numSections)
+		return false;
+
+	// copy the history out under the lock, and do the sorting without it
+	Section &s = sections[section];
+	EnterCriticalSection(&sampleLock);
+	int count = s.count;
+	for(i = 0; i < count; ++i)
+		sorted[i] = s.samples[i];
+	stats.lastMs = s.samples[(s.next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+	LeaveCriticalSection(&sampleLock);
+
+	if(count == 0)
+		return false;
+
+	for(i = 0; i < count; ++i)
+		sum += sorted[i];
+	std::sort(sorted, sorted+count);
+
+	stats.count = count;
+	stats.minMs = sorted[0];
+	stats.maxMs = sorted[count-1];
+	stats.avgMs = sum/(float)count;
+	stats.p95Ms = sorted[(int)((count-1)*0.95f)];
+	stats.p99Ms = sorted[(int)((count-1)*0.99f)];
+	return true;
+}
+
+/**
+ * @fn	const char* FrameProfiler::getSectionName(int section)
+ *
+ * @brief	Gets a section's name.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	section	The section index.
+ *
+ * @return	The name, or NULL if the section doesn't exist.
+ */
+const char* FrameProfiler::getSectionName(int section){
+	if(section < 0 || section >= numSections)
+		return NULL;
+	return sections[section].name;
+}
+
+/**
+ * @fn	void FrameProfiler::reset()
+ *
+ * @brief	Throws away all the samples, but keeps the sections
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void FrameProfiler::reset(){
+	EnterCriticalSection(&sampleLock);
+	for(int i = 0; i < numSections; ++i){
+		sections[i].next = 0;
+		sections[i].count = 0;
+	}
+	LeaveCriticalSection(&sampleLock);
+}
+
+/**
+ * @fn	bool FrameProfiler::dumpCSV(const char *fileName)
+ *
+ * @brief	Writes the statistics for every section to a CSV file
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	fileName	Filename of the file.
+ *
+ * @return	true if it succeeds, false if it fails.
+ */
+bool FrameProfiler::dumpCSV(const char *fileName){
+	FILE *fp;
+	Stats stats;
+
+	if(fopen_s(&fp, fileName, "w") != 0){
+		fprintf(stderr, "FrameProfiler::dumpCSV() unable to open '%s'\n", fileName);
+		return false;
+	}
+
+	fprintf(fp, "section,count,min_ms,avg_ms,max_ms,p95_ms,p99_ms\n");
+	for(int i = 0; i < numSections; ++i){
+		if(getStats(i, stats))
+			fprintf(fp, "%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f\n", sections[i].name, stats.count,
+				stats.minMs, stats.avgMs, stats.maxMs, stats.p95Ms, stats.p99Ms);
+	}
+	fclose(fp);
+	return true;
+}
+
+/**
+ * @fn	bool FrameProfiler::dumpJSON(const char *fileName)
+ *
+ * @brief	Writes the statistics for every section to a JSON file
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	fileName	Filename of the file.
+ *
+ * @return	true if it succeeds, false if it fails.
+ */
+bool FrameProfiler::dumpJSON(const char *fileName){
+	FILE *fp;
+	Stats stats;
+	bool first = true;
+
+	if(fopen_s(&fp, fileName, "w") != 0){
+		fprintf(stderr, "FrameProfiler::dumpJSON() unable to open '%s'\n", fileName);
+		return false;
+	}
+
+	fprintf(fp, "{\n  \"sections\": [");
+	for(int i = 0; i < numSections; ++i){
+		if(!getStats(i, stats))
+			continue;
+		fprintf(fp, "%s\n    {\"name\": ", first ? "" : ",");
+		writeJSONString(fp, sections[i].name);
+		fprintf(fp, ", \"count\": %d, \"min_ms\": %.4f, \"avg_ms\": %.4f, \"max_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f}",
+			stats.count, stats.minMs, stats.avgMs, stats.maxMs, stats.p95Ms, stats.p99Ms);
+		first = false;
+	}
+	fprintf(fp, "\n  ]\n}\n");
+	fclose(fp);
+	return true;
+}
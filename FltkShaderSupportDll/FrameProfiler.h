@@ -0,0 +1,288 @@
+#pragma once
+
+#include <windows.h>
+#include <stdio.h>
+
+/**
+ * @class	FrameProfiler
+ *
+ * @brief	Lightweight CPU profiler for timing the phases of a frame. Each named section keeps the last
+ * 			HISTORY_SIZE samples in a fixed-size ring buffer, and statistics (min/avg/max/p95/p99) are
+ * 			calculated from that history on request. Nothing is allocated after a section is created, so
+ * 			begin()/end() are cheap enough to leave in the frame. Sections may be timed from different
+ * 			threads as long as any one section is only timed from one thread at a time, and the
+ * 			statistics and dumps may be read from any thread, since the histories are guarded.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class FrameProfiler
+{
+public:
+
+	/**
+	 * @brief	Maximum number of sections and number of samples kept per section
+	 */
+	enum {MAX_SECTIONS = 256, HISTORY_SIZE = 256, MAX_NAME = 64};
+
+	/**
+	 * @struct	Stats
+	 *
+	 * @brief	Statistics for one section, in milliseconds
+	 */
+	struct Stats
+	{
+		int		count;
+		float	minMs;
+		float	avgMs;
+		float	maxMs;
+		float	p95Ms;
+		float	p99Ms;
+		float	lastMs;
+	};
+
+	/**
+	 * @fn	FrameProfiler::FrameProfiler(void);
+	 *
+	 * @brief	Constructor. The profiler starts disabled
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	FrameProfiler(void);
+
+	/**
+	 * @fn	FrameProfiler::~FrameProfiler(void);
+	 *
+	 * @brief	Destructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~FrameProfiler(void);
+
+	/**
+	 * @fn	void FrameProfiler::setEnabled(bool enable)
+	 *
+	 * @brief	Turns timing on or off. When off, begin(), end() and addSample() return immediately
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	enable	true to enable.
+	 */
+	void setEnabled(bool enable){	enabled = enable;	};
+
+	/**
+	 * @fn	bool FrameProfiler::isEnabled()
+	 *
+	 * @brief	Query if this profiler is timing.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if enabled.
+	 */
+	bool isEnabled(){	return enabled;	};
+
+	/**
+	 * @fn	int FrameProfiler::getSection(const char *name);
+	 *
+	 * @brief	Finds the section with this name, creating it if it doesn't exist. Look sections up once
+	 * 			and keep the index rather than calling this every frame.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	name	The section name.
+	 *
+	 * @return	The section index, or -1 if there is no room for another section.
+	 */
+	int getSection(const char *name);
+
+	/**
+	 * @fn	void FrameProfiler::begin(int section);
+	 *
+	 * @brief	Starts timing a section.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	section	The section index.
+	 */
+	void begin(int section);
+
+	/**
+	 * @fn	void FrameProfiler::end(int section);
+	 *
+	 * @brief	Stops timing a section and records the elapsed time as a sample
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	section	The section index.
+	 */
+	void end(int section);
+
+	/**
+	 * @fn	void FrameProfiler::addSample(int section, float ms);
+	 *
+	 * @brief	Records a sample that was measured somewhere else (e.g. on the GPU)
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	section	The section index.
+	 * @param	ms	   	The sample in milliseconds.
+	 */
+	void addSample(int section, float ms);
+
+	/**
+	 * @fn	bool FrameProfiler::getStats(int section, Stats &stats);
+	 *
+	 * @brief	Calculates the statistics for a section over its sample history
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	section		 	The section index.
+	 * @param [in,out]	stats	The statistics.
+	 *
+	 * @return	false if the section doesn't exist or has no samples.
+	 */
+	bool getStats(int section, Stats &stats);
+
+	/**
+	 * @fn	int FrameProfiler::getNumSections()
+	 *
+	 * @brief	Gets the number of sections.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of sections.
+	 */
+	int getNumSections(){	return numSections;	};
+
+	/**
+	 * @fn	const char* FrameProfiler::getSectionName(int section);
+	 *
+	 * @brief	Gets a section's name.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	section	The section index.
+	 *
+	 * @return	The name, or NULL if the section doesn't exist.
+	 */
+	const char* getSectionName(int section);
+
+	/**
+	 * @fn	void FrameProfiler::reset();
+	 *
+	 * @brief	Throws away all the samples, but keeps the sections
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void reset();
+
+	/**
+	 * @fn	bool FrameProfiler::dumpCSV(const char *fileName);
+	 *
+	 * @brief	Writes the statistics for every section to a CSV file
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName	Filename of the file.
+	 *
+	 * @return	true if it succeeds, false if it fails.
+	 */
+	bool dumpCSV(const char *fileName);
+
+	/**
+	 * @fn	bool FrameProfiler::dumpJSON(const char *fileName);
+	 *
+	 * @brief	Writes the statistics for every section to a JSON file
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName	Filename of the file.
+	 *
+	 * @return	true if it succeeds, false if it fails.
+	 */
+	bool dumpJSON(const char *fileName);
+
+protected:
+
+	/**
+	 * @struct	Section
+	 *
+	 * @brief	One timed section and its sample history
+	 */
+	struct Section
+	{
+		char		name[MAX_NAME];
+		LONGLONG	startTick;
+		float		samples[HISTORY_SIZE];
+		int			next;
+		int			count;
+	};
+
+	/**
+	 * @summary	The sections. Fixed size so that indices stay valid while other threads add sections
+	 */
+	Section sections[MAX_SECTIONS];
+
+	/**
+	 * @summary	Number of sections in use
+	 */
+	volatile LONG numSections;
+
+	/**
+	 * @summary	Guards creating sections
+	 */
+	CRITICAL_SECTION sectionLock;
+
+	/**
+	 * @summary	Guards the sample histories, which the simulation thread writes while the FLTK thread
+	 * 			reads them
+	 */
+	CRITICAL_SECTION sampleLock;
+
+	/**
+	 * @summary	Milliseconds per performance counter tick
+	 */
+	double msPerTick;
+
+	/**
+	 * @summary	true to enable timing
+	 */
+	bool enabled;
+};
+
+/**
+ * @class	ProfileScope
+ *
+ * @brief	Times a FrameProfiler section for as long as this object is in scope
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class ProfileScope
+{
+public:
+	ProfileScope(FrameProfiler &p, int s) : profiler(p), section(s) {	profiler.begin(section);	};
+	~ProfileScope(){	profiler.end(section);	};
+
+private:
+	ProfileScope& operator= (const ProfileScope&);
+
+	FrameProfiler	&profiler;
+	int				section;
+};
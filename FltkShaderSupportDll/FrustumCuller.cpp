@@ -0,0 +1,350 @@
+#include "StdAfx.h"
+#include "FrustumCuller.h"
+#include <string.h>
+
+// SSE intrinsics build without /arch:SSE on x86, so that kernel is picked at run time. The AVX one
+// is only built when the whole project targets AVX
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#define FRUSTUM_CULLER_SSE
+#include <xmmintrin.h>
+#endif
+#if defined(__AVX__)
+#define FRUSTUM_CULLER_AVX
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @fn	FrustumCuller::FrustumCuller(void)
+ *
+ * @brief	Constructor.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+FrustumCuller::FrustumCuller(void)
+{
+	valid = false;
+}
+
+FrustumCuller::~FrustumCuller(void)
+{
+}
+
+/**
+ * @fn	void FrustumCuller::setViewProjection(const M3DMatrix44f modelView,
+ * 		const M3DMatrix44f projection)
+ *
+ * @brief	Extracts the planes. A point p is inside when -w <= x, y, z <= w after clipping, and each of
+ * 			those six inequalities is a plane made by adding or subtracting a row of the matrix from
+ * 			the last row
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	modelView 	The model view matrix.
+ * @param	projection	The projection matrix.
+ */
+void FrustumCuller::setViewProjection(const M3DMatrix44f modelView, const M3DMatrix44f projection){
+	M3DMatrix44f mvp;
+
+	m3dMatrixMultiply44(mvp, projection, modelView);
+
+	// the matrices are column major, so row r is mvp[r], mvp[4 + r], mvp[8 + r], mvp[12 + r]
+	for(int i = 0; i < 4; ++i){
+		float w = mvp[i*4 + 3];
+		planes[PLANE_LEFT][i] = w + mvp[i*4];
+		planes[PLANE_RIGHT][i] = w - mvp[i*4];
+		planes[PLANE_BOTTOM][i] = w + mvp[i*4 + 1];
+		planes[PLANE_TOP][i] = w - mvp[i*4 + 1];
+		planes[PLANE_NEAR][i] = w + mvp[i*4 + 2];
+		planes[PLANE_FAR][i] = w - mvp[i*4 + 2];
+	}
+
+	for(int p = 0; p < NUM_PLANES; ++p){
+		float len = sqrt(planes[p][0]*planes[p][0] + planes[p][1]*planes[p][1] + planes[p][2]*planes[p][2]);
+		if(len > 0.0f){
+			for(int i = 0; i < 4; ++i)
+				planes[p][i] /= len;
+		}
+	}
+	valid = true;
+}
+
+/**
+ * @fn	bool FrustumCuller::isSphereVisible(const float *center, float radius)
+ *
+ * @brief	Tests a sphere against each plane in turn, stopping at the first one it is entirely behind
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	center	The center of the sphere.
+ * @param	radius	The radius.
+ *
+ * @return	false if the sphere is outside the frustum.
+ */
+bool FrustumCuller::isSphereVisible(const float *center, float radius){
+	for(int p = 0; p < NUM_PLANES; ++p){
+		if(planes[p][0]*center[0] + planes[p][1]*center[1] + planes[p][2]*center[2] + planes[p][3] < -radius)
+			return false;
+	}
+	return true;
+}
+
+/**
+ * @fn	FrustumCuller::KERNEL FrustumCuller::getKernel()
+ *
+ * @brief	Works out the kernel the first time it is asked. CPUID bit 25 of EDX is SSE
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The kernel.
+ */
+FrustumCuller::KERNEL FrustumCuller::getKernel(){
+#if defined(FRUSTUM_CULLER_AVX)
+	return KERNEL_AVX;
+#elif defined(FRUSTUM_CULLER_SSE) && defined(_MSC_VER)
+	static int hasSSE = -1;
+	if(hasSSE < 0){
+		int info[4];
+		__cpuid(info, 1);
+		hasSSE = (info[3] & (1 << 25)) != 0 ? 1 : 0;
+	}
+	return hasSSE ? KERNEL_SSE : KERNEL_SCALAR;
+#elif defined(FRUSTUM_CULLER_SSE)
+	return KERNEL_SSE;
+#else
+	return KERNEL_SCALAR;
+#endif
+}
+
+/**
+ * @fn	FrustumCuller::BOX_CLASS FrustumCuller::classifyBox(const float boxMin[3],
+ * 		const float boxMax[3])
+ *
+ * @brief	Tests an axis-aligned box against the frustum.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	boxMin	The minimum corner.
+ * @param	boxMax	The maximum corner.
+ *
+ * @return	Where the box lies.
+ */
+FrustumCuller::BOX_CLASS FrustumCuller::classifyBox(const float boxMin[3], const float boxMax[3]){
+	BOX_CLASS result = BOX_INSIDE;
+
+	if(!valid)
+		return BOX_INSIDE;
+
+	for(int p = 0; p < NUM_PLANES; ++p){
+		const float *plane = planes[p];
+		float farthest = plane[3];	// the corner most inside this plane
+		float nearest = plane[3];	// the corner least inside it
+
+		for(int i = 0; i < 3; ++i){
+			if(plane[i] >= 0.0f){
+				farthest += plane[i]*boxMax[i];
+				nearest += plane[i]*boxMin[i];
+			}else{
+				farthest += plane[i]*boxMin[i];
+				nearest += plane[i]*boxMax[i];
+			}
+		}
+		if(farthest < 0.0f)
+			return BOX_OUTSIDE;
+		if(nearest < 0.0f)
+			result = BOX_INTERSECTS;
+	}
+	return result;
+}
+
+/**
+ * @fn	int FrustumCuller::cullSpheres(const float *x, const float *y, const float *z,
+ * 		const float *radius, int count, unsigned int *visible)
+ *
+ * @brief	Runs the fastest kernel over as many whole groups as there are, then finishes the rest
+ * 			one at a time
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	x			  	The x coordinates of the centers.
+ * @param	y			  	The y coordinates of the centers.
+ * @param	z			  	The z coordinates of the centers.
+ * @param	radius		  	The radii.
+ * @param	count		  	The number of spheres.
+ * @param [out]	visible	The visibility mask.
+ *
+ * @return	The number of visible spheres.
+ */
+int FrustumCuller::cullSpheres(const float *x, const float *y, const float *z, const float *radius, int count, unsigned int *visible){
+	int numVisible = 0;
+	int done = 0;
+
+	memset(visible, 0, maskWords(count)*sizeof(unsigned int));
+	switch(getKernel()){
+		case KERNEL_AVX:
+			numVisible = cullAVX(x, y, z, radius, count, visible, done);
+			break;
+		case KERNEL_SSE:
+			numVisible = cullSSE(x, y, z, radius, count, visible, done);
+			break;
+		default:
+			break;
+	}
+	return numVisible + cullScalar(x, y, z, radius, done, count, visible);
+}
+
+/**
+ * @fn	int FrustumCuller::cullScalar(const float *x, const float *y, const float *z,
+ * 		const float *radius, int begin, int end, unsigned int *visible)
+ *
+ * @brief	Tests spheres one at a time
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	x			  	The x coordinates of the centers.
+ * @param	y			  	The y coordinates of the centers.
+ * @param	z			  	The z coordinates of the centers.
+ * @param	radius		  	The radii.
+ * @param	begin		  	The first sphere.
+ * @param	end			  	One past the last sphere.
+ * @param [in,out]	visible	The visibility mask.
+ *
+ * @return	The number of visible spheres.
+ */
+int FrustumCuller::cullScalar(const float *x, const float *y, const float *z, const float *radius, int begin, int end, unsigned int *visible){
+	int numVisible = 0;
+
+	for(int i = begin; i < end; ++i){
+		float center[3] = {x[i], y[i], z[i]};
+		if(radius[i] <= 0.0f || isSphereVisible(center, radius[i])){
+			visible[i >> 5] |= 1u << (i & 31);
+			++numVisible;
+		}
+	}
+	return numVisible;
+}
+
+/**
+ * @fn	int FrustumCuller::cullSSE(const float *x, const float *y, const float *z,
+ * 		const float *radius, int count, unsigned int *visible, int &done)
+ *
+ * @brief	Tests four spheres per pass. Every plane is tested for all four (there is no early out, but
+ * 			no branches either), and the sign bits of the result go straight into the mask. Groups start
+ * 			on multiples of four, so a group never straddles two words of the mask
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	x			  	The x coordinates of the centers.
+ * @param	y			  	The y coordinates of the centers.
+ * @param	z			  	The z coordinates of the centers.
+ * @param	radius		  	The radii.
+ * @param	count		  	The number of spheres.
+ * @param [in,out]	visible	The visibility mask.
+ * @param [out]	done   	The number of spheres tested.
+ *
+ * @return	The number of visible spheres.
+ */
+int FrustumCuller::cullSSE(const float *x, const float *y, const float *z, const float *radius, int count, unsigned int *visible, int &done){
+	int numVisible = 0;
+	done = 0;
+
+#if defined(FRUSTUM_CULLER_SSE)
+	static const int bitCount[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+	__m128 a[NUM_PLANES], b[NUM_PLANES], c[NUM_PLANES], d[NUM_PLANES];
+	const __m128 zero = _mm_setzero_ps();
+
+	for(int p = 0; p < NUM_PLANES; ++p){
+		a[p] = _mm_set1_ps(planes[p][0]);
+		b[p] = _mm_set1_ps(planes[p][1]);
+		c[p] = _mm_set1_ps(planes[p][2]);
+		d[p] = _mm_set1_ps(planes[p][3]);
+	}
+
+	for(done = 0; done + 4 <= count; done += 4){
+		__m128 px = _mm_loadu_ps(x + done);
+		__m128 py = _mm_loadu_ps(y + done);
+		__m128 pz = _mm_loadu_ps(z + done);
+		__m128 r = _mm_loadu_ps(radius + done);
+		__m128 negR = _mm_sub_ps(zero, r);
+		__m128 inside = _mm_cmple_ps(r, zero); // no bounds
+
+		__m128 inFront = _mm_cmpge_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], px), _mm_mul_ps(b[0], py)), _mm_add_ps(_mm_mul_ps(c[0], pz), d[0])), negR);
+		for(int p = 1; p < NUM_PLANES; ++p){
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[p], px), _mm_mul_ps(b[p], py)), _mm_add_ps(_mm_mul_ps(c[p], pz), d[p]));
+			inFront = _mm_and_ps(inFront, _mm_cmpge_ps(dist, negR));
+		}
+
+		int bits = _mm_movemask_ps(_mm_or_ps(inside, inFront));
+		visible[done >> 5] |= (unsigned int)bits << (done & 31);
+		numVisible += bitCount[bits];
+	}
+#endif
+	return numVisible;
+}
+
+/**
+ * @fn	int FrustumCuller::cullAVX(const float *x, const float *y, const float *z,
+ * 		const float *radius, int count, unsigned int *visible, int &done)
+ *
+ * @brief	Tests eight spheres per pass, the same way as cullSSE()
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	x			  	The x coordinates of the centers.
+ * @param	y			  	The y coordinates of the centers.
+ * @param	z			  	The z coordinates of the centers.
+ * @param	radius		  	The radii.
+ * @param	count		  	The number of spheres.
+ * @param [in,out]	visible	The visibility mask.
+ * @param [out]	done   	The number of spheres tested.
+ *
+ * @return	The number of visible spheres.
+ */
+int FrustumCuller::cullAVX(const float *x, const float *y, const float *z, const float *radius, int count, unsigned int *visible, int &done){
+	int numVisible = 0;
+	done = 0;
+
+#if defined(FRUSTUM_CULLER_AVX)
+	__m256 a[NUM_PLANES], b[NUM_PLANES], c[NUM_PLANES], d[NUM_PLANES];
+	const __m256 zero = _mm256_setzero_ps();
+
+	for(int p = 0; p < NUM_PLANES; ++p){
+		a[p] = _mm256_set1_ps(planes[p][0]);
+		b[p] = _mm256_set1_ps(planes[p][1]);
+		c[p] = _mm256_set1_ps(planes[p][2]);
+		d[p] = _mm256_set1_ps(planes[p][3]);
+	}
+
+	for(done = 0; done + 8 <= count; done += 8){
+		__m256 px = _mm256_loadu_ps(x + done);
+		__m256 py = _mm256_loadu_ps(y + done);
+		__m256 pz = _mm256_loadu_ps(z + done);
+		__m256 r = _mm256_loadu_ps(radius + done);
+		__m256 negR = _mm256_sub_ps(zero, r);
+		__m256 inside = _mm256_cmp_ps(r, zero, _CMP_LE_OQ); // no bounds
+		__m256 inFront = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ); // all ones
+
+		for(int p = 0; p < NUM_PLANES; ++p){
+			__m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a[p], px), _mm256_mul_ps(b[p], py)), _mm256_add_ps(_mm256_mul_ps(c[p], pz), d[p]));
+			inFront = _mm256_and_ps(inFront, _mm256_cmp_ps(dist, negR, _CMP_GE_OQ));
+		}
+
+		unsigned int bits = (unsigned int)_mm256_movemask_ps(_mm256_or_ps(inside, inFront));
+		visible[done >> 5] |= bits << (done & 31);
+		for(; bits != 0; bits &= bits - 1)
+			++numVisible;
+	}
+#endif
+	return numVisible;
+}
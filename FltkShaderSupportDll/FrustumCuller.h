@@ -0,0 +1,274 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <math3d.h>
+
+/**
+ * @class	FrustumCuller
+ *
+ * @brief	Tests bounding spheres against the view frustum. GLFrustum::TestSphere() needs the camera as a
+ * 			GLFrame, but Gl_ShaderWindow builds its view on the matrix stacks, so the six planes are pulled
+ * 			straight out of projection * modelView instead (Gribb and Hartmann, "Fast Extraction of
+ * 			Viewing Frustum Planes from the World-View-Projection Matrix"). That gives planes in whatever
+ * 			space modelView starts from, which for Gl_ShaderWindow is the space the objects are placed in.
+ *
+ * 			cullSpheres() tests a whole scene at once. The spheres are passed as separate x, y, z and
+ * 			radius arrays, so SSE can load four of each with one instruction each (eight with AVX when
+ * 			built with /arch:AVX), and the answers come back packed into a bitmask.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class FrustumCuller
+{
+public:
+
+	/**
+	 * @fn	FrustumCuller::FrustumCuller(void);
+	 *
+	 * @brief	Constructor. Nothing is culled until setViewProjection() is called
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	FrustumCuller(void);
+
+	/**
+	 * @fn	FrustumCuller::~FrustumCuller(void);
+	 *
+	 * @brief	Destructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~FrustumCuller(void);
+
+	/**
+	 * @fn	void FrustumCuller::setViewProjection(const M3DMatrix44f modelView,
+	 * 		const M3DMatrix44f projection);
+	 *
+	 * @brief	Extracts and normalizes the six planes of the frustum. Call once per frame
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	modelView 	The model view matrix.
+	 * @param	projection	The projection matrix.
+	 */
+	void setViewProjection(const M3DMatrix44f modelView, const M3DMatrix44f projection);
+
+	/**
+	 * @fn	bool FrustumCuller::isSphereVisible(const float *center, float radius);
+	 *
+	 * @brief	Query if any of a sphere might be inside the frustum. Spheres near a corner can pass
+	 * 			when they are just outside, which only costs a wasted draw.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	center	The center of the sphere.
+	 * @param	radius	The radius.
+	 *
+	 * @return	false if the sphere is entirely outside one of the planes.
+	 */
+	bool isSphereVisible(const float *center, float radius);
+
+	/**
+	 * @enum	BOX_CLASS
+	 *
+	 * @brief	Where a box lies with respect to the frustum
+	 */
+	enum BOX_CLASS{BOX_OUTSIDE, BOX_INTERSECTS, BOX_INSIDE};
+
+	/**
+	 * @fn	BOX_CLASS FrustumCuller::classifyBox(const float boxMin[3], const float boxMax[3]);
+	 *
+	 * @brief	Tests an axis-aligned box against the frustum. Against each plane only the corner
+	 * 			furthest along the plane's normal, and the one furthest against it, need testing. Like
+	 * 			isSphereVisible(), boxes near a corner can count as intersecting when they are just
+	 * 			outside. A box that is inside needs none of its contents tested
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	boxMin	The minimum corner.
+	 * @param	boxMax	The maximum corner.
+	 *
+	 * @return	BOX_OUTSIDE, BOX_INTERSECTS or BOX_INSIDE. BOX_INSIDE when there are no planes.
+	 */
+	BOX_CLASS classifyBox(const float boxMin[3], const float boxMax[3]);
+
+	/**
+	 * @fn	int FrustumCuller::cullSpheres(const float *x, const float *y, const float *z,
+	 * 		const float *radius, int count, unsigned int *visible);
+	 *
+	 * @brief	Tests a batch of spheres held as structure-of-arrays. A sphere with a radius of zero or
+	 * 			less has no bounds and counts as visible.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x			  	The x coordinates of the centers.
+	 * @param	y			  	The y coordinates of the centers.
+	 * @param	z			  	The z coordinates of the centers.
+	 * @param	radius		  	The radii.
+	 * @param	count		  	The number of spheres.
+	 * @param [out]	visible	maskWords(count) words. Bit (i % 32) of word (i / 32) is set if sphere i
+	 * 							is visible.
+	 *
+	 * @return	The number of visible spheres.
+	 */
+	int cullSpheres(const float *x, const float *y, const float *z, const float *radius, int count, unsigned int *visible);
+
+	/**
+	 * @fn	static int FrustumCuller::maskWords(int count)
+	 *
+	 * @brief	Gets the number of words of bitmask that cullSpheres() writes for 'count' spheres
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	count	The number of spheres.
+	 *
+	 * @return	The number of words.
+	 */
+	static int maskWords(int count){	return (count + 31)/32;	};
+
+	/**
+	 * @fn	static bool FrustumCuller::isVisible(const unsigned int *visible, int i)
+	 *
+	 * @brief	Reads one sphere's bit out of the mask from cullSpheres()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	visible	The mask.
+	 * @param	i	   	The index of the sphere.
+	 *
+	 * @return	true if the sphere is visible.
+	 */
+	static bool isVisible(const unsigned int *visible, int i){	return ((visible[i >> 5] >> (i & 31)) & 1) != 0;	};
+
+	/**
+	 * @enum	KERNEL
+	 *
+	 * @brief	The ways cullSpheres() can run, slowest first
+	 */
+	enum KERNEL{KERNEL_SCALAR, KERNEL_SSE, KERNEL_AVX};
+
+	/**
+	 * @fn	static KERNEL FrustumCuller::getKernel();
+	 *
+	 * @brief	Gets the fastest kernel that this build and this CPU can run, which is the one
+	 * 			cullSpheres() uses
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The kernel.
+	 */
+	static KERNEL getKernel();
+
+	/**
+	 * @fn	bool FrustumCuller::isValid()
+	 *
+	 * @brief	Query if there are planes to test against.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true between setViewProjection() and invalidate().
+	 */
+	bool isValid(){	return valid;	};
+
+	/**
+	 * @fn	void FrustumCuller::invalidate()
+	 *
+	 * @brief	Forgets the planes, so that nothing is culled until the next setViewProjection()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void invalidate(){	valid = false;	};
+
+	/**
+	 * @enum	PLANE
+	 *
+	 * @brief	The planes, in the order they are stored
+	 */
+	enum PLANE{PLANE_LEFT, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, NUM_PLANES};
+
+protected:
+
+	/**
+	 * @fn	int FrustumCuller::cullScalar(const float *x, const float *y, const float *z,
+	 * 		const float *radius, int begin, int end, unsigned int *visible);
+	 *
+	 * @brief	Tests spheres [begin, end) one at a time. Used without SSE, and for the ones left over
+	 * 			after the last full group of four or eight
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x			  	The x coordinates of the centers.
+	 * @param	y			  	The y coordinates of the centers.
+	 * @param	z			  	The z coordinates of the centers.
+	 * @param	radius		  	The radii.
+	 * @param	begin		  	The first sphere.
+	 * @param	end			  	One past the last sphere.
+	 * @param [in,out]	visible	The mask, which must already be cleared.
+	 *
+	 * @return	The number of visible spheres.
+	 */
+	int cullScalar(const float *x, const float *y, const float *z, const float *radius, int begin, int end, unsigned int *visible);
+
+	/**
+	 * @fn	int FrustumCuller::cullSSE(const float *x, const float *y, const float *z,
+	 * 		const float *radius, int count, unsigned int *visible, int &done);
+	 *
+	 * @brief	Tests spheres four at a time. Returns how many it tested as well as how many passed
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x			  	The x coordinates of the centers.
+	 * @param	y			  	The y coordinates of the centers.
+	 * @param	z			  	The z coordinates of the centers.
+	 * @param	radius		  	The radii.
+	 * @param	count		  	The number of spheres.
+	 * @param [in,out]	visible	The mask, which must already be cleared.
+	 * @param [out]	done   	The number of spheres tested, a multiple of four.
+	 *
+	 * @return	The number of visible spheres.
+	 */
+	int cullSSE(const float *x, const float *y, const float *z, const float *radius, int count, unsigned int *visible, int &done);
+
+	/**
+	 * @fn	int FrustumCuller::cullAVX(const float *x, const float *y, const float *z,
+	 * 		const float *radius, int count, unsigned int *visible, int &done);
+	 *
+	 * @brief	Tests spheres eight at a time, as cullSSE() does four
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x			  	The x coordinates of the centers.
+	 * @param	y			  	The y coordinates of the centers.
+	 * @param	z			  	The z coordinates of the centers.
+	 * @param	radius		  	The radii.
+	 * @param	count		  	The number of spheres.
+	 * @param [in,out]	visible	The mask, which must already be cleared.
+	 * @param [out]	done   	The number of spheres tested, a multiple of eight.
+	 *
+	 * @return	The number of visible spheres.
+	 */
+	int cullAVX(const float *x, const float *y, const float *z, const float *radius, int count, unsigned int *visible, int &done);
+
+	/**
+	 * @summary	Each plane as (a, b, c, d) with a unit normal pointing into the frustum, so
+	 * 			a*x + b*y + c*z + d is the signed distance of a point from it
+	 */
+	float planes[NUM_PLANES][4];
+	bool valid;
+};
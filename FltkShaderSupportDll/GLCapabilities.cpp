@@ -0,0 +1,167 @@
+#include "StdAfx.h"
+#include "GLCapabilities.h"
+#include <string.h>
+
+bool GLCapabilities::loaded = false;
+bool GLCapabilities::verboseLoad = false;
+unordered_set<string> GLCapabilities::extensions;
+string GLCapabilities::vendor;
+string GLCapabilities::renderer;
+string GLCapabilities::version;
+string GLCapabilities::glslVersion;
+int GLCapabilities::majorVersion = 0;
+int GLCapabilities::minorVersion = 0;
+int GLCapabilities::maxTextureSize = 0;
+int GLCapabilities::maxTextureUnits = 0;
+int GLCapabilities::maxRenderbufferSize = 0;
+int GLCapabilities::maxColorAttachments = 0;
+int GLCapabilities::maxDrawBuffers = 0;
+int GLCapabilities::maxSamples = 0;
+int GLCapabilities::maxVertexAttribs = 0;
+int GLCapabilities::maxUniformBlocks = 0;
+int GLCapabilities::maxUniformBlockSize = 0;
+
+// glGetString() returns NULL if there is no context, and std::string can't take NULL
+static const char* safeString(const GLubyte *str){
+	return (str != NULL) ? (const char*)str : "";
+}
+
+/**
+ * @fn	bool GLCapabilities::hasExtension(const char *name)
+ *
+ * @brief	Query if the context supports an extension
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	name	The extension name, e.g. "GL_ARB_timer_query".
+ *
+ * @return	true if supported.
+ */
+bool GLCapabilities::hasExtension(const char *name){
+	load();
+	return extensions.find(name) != extensions.end();
+}
+
+/**
+ * @fn	bool GLCapabilities::isVersion(int major, int minor)
+ *
+ * @brief	Query if the context is at least a given GL version
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	major	The major version.
+ * @param	minor	The minor version.
+ *
+ * @return	true if the context version is major.minor or later.
+ */
+bool GLCapabilities::isVersion(int major, int minor){
+	load();
+	return (majorVersion > major) || (majorVersion == major && minorVersion >= minor);
+}
+
+/**
+ * @fn	void GLCapabilities::loadFromDriver()
+ *
+ * @brief	Reads everything from the driver. GL 3.0+ contexts list their extensions one at a time
+ * 			with glGetStringi(); older ones only have the single GL_EXTENSIONS string, which is split
+ * 			up once here.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void GLCapabilities::loadFromDriver(){
+	GLint numExtensions = 0;
+
+	vendor = safeString(glGetString(GL_VENDOR));
+	renderer = safeString(glGetString(GL_RENDERER));
+	version = safeString(glGetString(GL_VERSION));
+	glslVersion = safeString(glGetString(GL_SHADING_LANGUAGE_VERSION));
+
+	majorVersion = minorVersion = 0;
+	sscanf_s(version.c_str(), "%d.%d", &majorVersion, &minorVersion);
+
+	extensions.clear();
+	if(majorVersion >= 3 && glGetStringi != NULL){
+		glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+		extensions.rehash(numExtensions);
+		for(GLint i = 0; i < numExtensions; ++i)
+			extensions.insert(safeString(glGetStringi(GL_EXTENSIONS, i)));
+	}else{
+		const char *ext = safeString(glGetString(GL_EXTENSIONS));
+		while(*ext != '\0'){
+			const char *end = strchr(ext, ' ');
+			if(end == NULL)
+				end = ext + strlen(ext);
+			if(end > ext)
+				extensions.insert(string(ext, end));
+			ext = (*end == ' ') ? end + 1 : end;
+		}
+	}
+
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+	glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbufferSize);
+	glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &maxColorAttachments);
+	glGetIntegerv(GL_MAX_DRAW_BUFFERS, &maxDrawBuffers);
+	glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertexAttribs);
+	// not isVersion(), which would call load() and come straight back here, since loaded isn't set yet
+	bool hasUniformBlocks = majorVersion > 3 || (majorVersion == 3 && minorVersion >= 1);
+	if(hasUniformBlocks || extensions.count("GL_ARB_uniform_buffer_object") > 0){
+		glGetIntegerv(GL_MAX_COMBINED_UNIFORM_BLOCKS, &maxUniformBlocks);
+		glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &maxUniformBlockSize);
+	}else{
+		maxUniformBlocks = maxUniformBlockSize = 0;
+	}
+
+	loaded = true;
+	if(verboseLoad)
+		dump(stdout);
+}
+
+/**
+ * @fn	void GLCapabilities::dump(FILE *fp)
+ *
+ * @brief	Prints the version strings, the limits and every extension
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	fp	The file to print to.
+ */
+void GLCapabilities::dump(FILE *fp){
+	unordered_set<string>::const_iterator it;
+
+	load();
+	fprintf(fp, "GL_VENDOR: %s\n", vendor.c_str());
+	fprintf(fp, "GL_RENDERER: %s\n", renderer.c_str());
+	fprintf(fp, "GL_VERSION: %s\n", version.c_str());
+	fprintf(fp, "GL_SHADING_LANGUAGE_VERSION: %s\n", glslVersion.c_str());
+	fprintf(fp, "max texture size: %d\n", maxTextureSize);
+	fprintf(fp, "max texture units: %d\n", maxTextureUnits);
+	fprintf(fp, "max renderbuffer size: %d\n", maxRenderbufferSize);
+	fprintf(fp, "max color attachments: %d\n", maxColorAttachments);
+	fprintf(fp, "max draw buffers: %d\n", maxDrawBuffers);
+	fprintf(fp, "max samples: %d\n", maxSamples);
+	fprintf(fp, "max vertex attribs: %d\n", maxVertexAttribs);
+	fprintf(fp, "max uniform blocks: %d\n", maxUniformBlocks);
+	fprintf(fp, "max uniform block size: %d\n", maxUniformBlockSize);
+	fprintf(fp, "%d extensions:\n", (int)extensions.size());
+	for(it = extensions.begin(); it != extensions.end(); ++it)
+		fprintf(fp, "%s\n", it->c_str());
+}
+
+/**
+ * @fn	void GLCapabilities::reset()
+ *
+ * @brief	Throws the cache away, so that it is read again from the current context on the next query
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void GLCapabilities::reset(){
+	extensions.clear();
+	loaded = false;
+}
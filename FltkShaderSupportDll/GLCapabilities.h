@@ -0,0 +1,147 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <stdio.h>
+#include <string>
+#include <unordered_set>
+
+using namespace std;
+
+/**
+ * @class	GLCapabilities
+ *
+ * @brief	Cache of what the current GL context can do. Everything is read from the driver the first
+ * 			time any query is made (extensions with glGetStringi into a hashed set, limits with
+ * 			glGetIntegerv), so later queries cost a hash lookup or a load. Like Dprint, everything is
+ * 			static. Queries must be made from the thread that owns the GL context; call reset() if the
+ * 			context is replaced.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class GLCapabilities
+{
+public:
+
+	/**
+	 * @fn	static bool GLCapabilities::hasExtension(const char *name);
+	 *
+	 * @brief	Query if the context supports an extension
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	name	The extension name, e.g. "GL_ARB_timer_query".
+	 *
+	 * @return	true if supported.
+	 */
+	static bool hasExtension(const char *name);
+
+	/**
+	 * @fn	static bool GLCapabilities::isVersion(int major, int minor);
+	 *
+	 * @brief	Query if the context is at least a given GL version
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	major	The major version.
+	 * @param	minor	The minor version.
+	 *
+	 * @return	true if the context version is major.minor or later.
+	 */
+	static bool isVersion(int major, int minor);
+
+	static int getMajorVersion()			{	load();	return majorVersion;		};
+	static int getMinorVersion()			{	load();	return minorVersion;		};
+	static int getMaxTextureSize()			{	load();	return maxTextureSize;		};
+	static int getMaxTextureUnits()			{	load();	return maxTextureUnits;		};
+	static int getMaxRenderbufferSize()		{	load();	return maxRenderbufferSize;	};
+	static int getMaxColorAttachments()		{	load();	return maxColorAttachments;	};
+	static int getMaxDrawBuffers()			{	load();	return maxDrawBuffers;		};
+	static int getMaxSamples()				{	load();	return maxSamples;			};
+	static int getMaxVertexAttribs()		{	load();	return maxVertexAttribs;	};
+	static int getMaxUniformBlocks()		{	load();	return maxUniformBlocks;	};
+	static int getMaxUniformBlockSize()		{	load();	return maxUniformBlockSize;	};
+	static int getNumExtensions()			{	load();	return (int)extensions.size();	};
+	static const char* getVendor()			{	load();	return vendor.c_str();		};
+	static const char* getRenderer()		{	load();	return renderer.c_str();	};
+	static const char* getVersion()			{	load();	return version.c_str();		};
+	static const char* getGLSLVersion()		{	load();	return glslVersion.c_str();	};
+
+	/**
+	 * @fn	static void GLCapabilities::setVerbose(bool verbose)
+	 *
+	 * @brief	If set before the cache is built, dump() is called as soon as it has been
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	verbose	true to dump the capabilities when they are read.
+	 */
+	static void setVerbose(bool verbose){	verboseLoad = verbose;	};
+
+	/**
+	 * @fn	static void GLCapabilities::dump(FILE *fp = stdout);
+	 *
+	 * @brief	Prints the version strings, the limits and every extension
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	fp	The file to print to.
+	 */
+	static void dump(FILE *fp = stdout);
+
+	/**
+	 * @fn	static void GLCapabilities::reset();
+	 *
+	 * @brief	Throws the cache away, so that it is read again from the current context on the next query
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	static void reset();
+
+private:
+
+	/**
+	 * @fn	static void GLCapabilities::load();
+	 *
+	 * @brief	Reads everything from the driver, if that hasn't already been done
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	static void load(){	if(!loaded) loadFromDriver();	};
+
+	/**
+	 * @fn	static void GLCapabilities::loadFromDriver();
+	 *
+	 * @brief	Reads everything from the driver.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	static void loadFromDriver();
+
+	static bool loaded;
+	static bool verboseLoad;
+	static unordered_set<string> extensions;
+	static string vendor;
+	static string renderer;
+	static string version;
+	static string glslVersion;
+	static int majorVersion;
+	static int minorVersion;
+	static int maxTextureSize;
+	static int maxTextureUnits;
+	static int maxRenderbufferSize;
+	static int maxColorAttachments;
+	static int maxDrawBuffers;
+	static int maxSamples;
+	static int maxVertexAttribs;
+	static int maxUniformBlocks;
+	static int maxUniformBlockSize;
+};
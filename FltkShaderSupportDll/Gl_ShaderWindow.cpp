@@ -54,6 +54,54 @@ Gl_ShaderWindow::Gl_ShaderWindow(int x,int y,int w,int h,const char *l)
 	setWorldOrient(0, 0, 0);
 
 	modelPos[0] = modelPos[1] = modelPos[2] = 0;
+
+	simulationStep = 0.0f; // default to one environmentCalc() per timer tick
+	simAccumulator = 0.0f;
+	maxSimSteps = 10;
+	interpolationAlpha = 1.0f;
+
+	simThread = NULL;
+	simThreadQuit = 0;
+
+	preDraw3DSection = profiler.getSection("preDraw3D");
+	postDraw3DSection = profiler.getSection("postDraw3D");
+	draw2DSection = profiler.getSection("draw2D");
+	environmentCalcSection = profiler.getSection("environmentCalc");
+	spatialIndexSection = profiler.getSection("spatialIndex");
+	gpuTiming = true;
+
+	InitializeCriticalSection(&sceneLock);
+	InitializeCriticalSection(&sceneChangeLock);
+	jobSystem = NULL;
+
+	offscreen = NULL;
+	headlessContext = NULL;
+	headlessFrameSection = profiler.getSection("headlessFrame");
+
+	assetBudgetMs = 2.0f;
+	assetUploadSection = profiler.getSection("assetUpload");
+
+	frameCount = 0;
+	frameSection = profiler.getSection("frame");
+
+	onDemandRedraw = false;
+	redrawRequested = 1;
+
+	pacer.setTargetInterval(refreshSeconds);
+	frameCostSection = profiler.getSection("frameCost");
+	swapInterval = 0;
+	swapIntervalPending = false;
+
+	frustumCulling = true;
+	visibleCount = culledCount = 0;
+
+	pickMode = PICK_OCCLUSION;
+	idPickPending = false;
+	pickStartX = pickStartY = 0;
+	nextPickId = 1; // zero is "nothing" in the IdBuffer
+	idPassSection = profiler.getSection("idPass");
+	hasPickView = false;
+	InitializeCriticalSection(&pickViewLock);
 	
 	Fl::add_timeout(refreshSeconds, timerCallback, this);
 }
@@ -88,7 +136,9 @@ void Gl_ShaderWindow::setFloats(GLfloat *ptr, int size, ...)
 /**
 * @fn	static void Gl_ShaderWindow::timerCallback(void* data);
 *
-* @brief	Drawing callback, triggered by the timer
+* @brief	Drawing callback, triggered by the timer. The FramePacer lines the tick up with its
+* 			deadline, and the next tick is scheduled for the following deadline, so the time this frame
+* 			takes comes out of the wait instead of being added to it
 *
 * @author	Phil
 * @date	3/15/2012
@@ -97,9 +147,954 @@ void Gl_ShaderWindow::setFloats(GLfloat *ptr, int size, ...)
 */
 void Gl_ShaderWindow::timerCallback(void* data){
 	Gl_ShaderWindow *gvw = (Gl_ShaderWindow*)data;
-	gvw->redraw();
-	gvw->environmentCalc();
-	Fl::repeat_timeout(gvw->refreshSeconds, timerCallback, data);
+	gvw->pacer.beginFrame();
+	gvw->profiler.addSample(gvw->frameSection, (float)(gvw->frameStopWatch.GetElapsedSeconds()*1000.0f));
+	gvw->frameStopWatch.Reset();
+
+	gvw->applySceneChanges();
+	gvw->replayInput();
+	gvw->coalesceInput();
+	if(gvw->simThread != NULL)
+		; // the simulation thread is calling environmentCalc()
+	else if(gvw->simulationStep > 0.0f && gvw->inputRecorder.isReplaying())
+		gvw->advanceSimulation(gvw->refreshSeconds); // replays step by exactly one tick
+	else if(gvw->simulationStep > 0.0f)
+		gvw->stepSimulation();
+	else
+		gvw->timedEnvironmentCalc();
+
+	// decided after the input and the calc, so that this tick's changes are drawn
+	if(!gvw->onDemandRedraw || gvw->needsRedraw())
+		gvw->redraw(); // flush() ends the frame once it has been drawn
+	else
+		gvw->endPacedFrame();
+	++gvw->frameCount;
+	Fl::add_timeout(gvw->pacer.getDelay(), timerCallback, data);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::flush();
+*
+* @brief	Fl_Gl_Window::flush() override: draws and swaps, then ends the paced frame, so that the
+* 			frame cost includes the draw and the swap
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::flush(){
+	Fl_Gl_Window::flush();
+	endPacedFrame();
+}
+
+/**
+* @fn	void Gl_ShaderWindow::endPacedFrame();
+*
+* @brief	Ends the frame started by the timer tick and records its cost in the "frameCost" section.
+* 			Expose redraws between ticks aren't part of a paced frame, and are ignored
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::endPacedFrame(){
+	if(!pacer.isInFrame())
+		return;
+
+	pacer.endFrame();
+	profiler.addSample(frameCostSection, pacer.getFrameCostMs());
+}
+
+/**
+* @fn	void Gl_ShaderWindow::setSimulationRate(float hz);
+*
+* @brief	Switches the window to a fixed-timestep simulation loop. environmentCalc() is then called
+* 			as many times as needed to advance the simulation at 'hz' steps per second, independent
+* 			of how fast frames are drawn. Passing 0 restores one environmentCalc() per timer tick.
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	hz	The simulation rate in steps per second (e.g. 240 or 1000), or 0 to disable
+*/
+void Gl_ShaderWindow::setSimulationRate(float hz){
+	if(hz > 0.0f)
+		simulationStep = 1.0f/hz;
+	else
+		simulationStep = 0.0f;
+
+	simAccumulator = 0.0f;
+	interpolationAlpha = 1.0f;
+	simStopWatch.Reset();
+
+	DrawableObject::setInterpolationAlpha(interpolationAlpha);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::stepSimulation();
+*
+* @brief	Runs the fixed-timestep accumulator: adds the wall time since the last call and calls
+* 			environmentCalc() once for every whole simulation step that has accumulated. Whatever is
+* 			left over becomes the interpolation alpha that render() uses to blend between the last
+* 			two steps.
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::stepSimulation(){
+	float elapsed = simStopWatch.GetElapsedSeconds();
+	simStopWatch.Reset();
+	advanceSimulation(elapsed);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::advanceSimulation(float seconds);
+*
+* @brief	Adds 'seconds' to the accumulator and calls environmentCalc() once for every whole
+* 			simulation step that it now holds, up to maxSimSteps
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	seconds	The time to advance by.
+*/
+void Gl_ShaderWindow::advanceSimulation(float seconds){
+	int steps = 0;
+
+	simAccumulator += seconds;
+
+	while(simAccumulator >= simulationStep && steps < maxSimSteps){
+		timedEnvironmentCalc();
+		simAccumulator -= simulationStep;
+		++steps;
+	}
+
+	// if we still can't keep up, drop the backlog so that we don't spiral
+	if(simAccumulator >= simulationStep)
+		simAccumulator = fmod(simAccumulator, simulationStep);
+
+	interpolationAlpha = simAccumulator/simulationStep;
+	DrawableObject::setInterpolationAlpha(interpolationAlpha);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::timedEnvironmentCalc();
+*
+* @brief	Stamps the frame clock, hands its step and time to the DrawableObjects, and calls
+* 			environmentCalc(), timing it in the profiler. In fixed-timestep mode each call is exactly
+* 			one simulation step
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::timedEnvironmentCalc(){
+	ProfileScope scope(profiler, environmentCalcSection);
+
+	if(simulationStep > 0.0f)
+		frameClock.advance(simulationStep);
+	else
+		frameClock.tick();
+	DrawableObject::setFrameTime(frameClock.getDeltaTime(), frameClock.getTime());
+
+	environmentCalc();
+	updateSpatialIndex();
+}
+
+/**
+* @fn	void Gl_ShaderWindow::updateSpatialIndex();
+*
+* @brief	Updates the leaf of every world object in sceneBVH from its bounds, adding the objects that
+* 			have gained bounds since they joined the scene and dropping any that have lost them
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::updateSpatialIndex(){
+	ProfileScope scope(profiler, spatialIndexSection);
+	vector<DrawableObject*> &objects = sceneObjects[LAYER_WORLD];
+	float boxMin[3], boxMax[3];
+
+	// already held on the simulation thread, but not when the FLTK thread runs the simulation
+	EnterCriticalSection(&sceneLock);
+	for(unsigned int i = 0; i < objects.size(); ++i){
+		DrawableObject *obj = objects[i];
+		int proxy = obj->getSpatialProxy();
+
+		if(!obj->getWorldBounds(boxMin, boxMax)){
+			if(proxy != DynamicBVH::NULL_NODE){
+				sceneBVH.remove(proxy);
+				obj->setSpatialProxy(DynamicBVH::NULL_NODE);
+			}
+		}else if(proxy == DynamicBVH::NULL_NODE){
+			obj->setSpatialProxy(sceneBVH.insert(obj, boxMin, boxMax));
+		}else{
+			sceneBVH.update(proxy, boxMin, boxMax);
+		}
+	}
+	if(sceneBVH.needsRebuild())
+		sceneBVH.rebuild();
+	LeaveCriticalSection(&sceneLock);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::renderObject(DrawableObject *obj);
+*
+* @brief	Calls obj->render() with this window's matrix stacks and shader manager, timing it
+* 			in the profiler under the object's name. Any GPU timings that have finished since the
+* 			last frame are collected first, so this never waits on the GPU
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	obj	the object to draw.
+*/
+void Gl_ShaderWindow::renderObject(DrawableObject *obj){
+	float gpuMs;
+
+	if(!profiler.isEnabled()){
+		obj->render(modelViewMatrix, projectionMatrix, shaderManager);
+		return;
+	}
+
+	ProfileScope scope(profiler, obj->getProfileSection(profiler, DrawableObject::PROFILE_RENDER));
+	if(!gpuTiming){
+		obj->render(modelViewMatrix, projectionMatrix, shaderManager);
+		return;
+	}
+
+	GpuTimer &timer = obj->getGpuTimer();
+	int gpuSection = obj->getProfileSection(profiler, DrawableObject::PROFILE_GPU_RENDER);
+	while(timer.getResult(gpuMs))
+		profiler.addSample(gpuSection, gpuMs);
+
+	timer.begin();
+	obj->render(modelViewMatrix, projectionMatrix, shaderManager);
+	timer.end();
+}
+
+/**
+* @fn	void Gl_ShaderWindow::calcObject(DrawableObject *obj);
+*
+* @brief	Calls obj->environmentCalc(), timing it in the profiler under the object's name
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	obj	the object to update.
+*/
+void Gl_ShaderWindow::calcObject(DrawableObject *obj){
+	if(!profiler.isEnabled()){
+		obj->environmentCalc();
+		return;
+	}
+
+	ProfileScope scope(profiler, obj->getProfileSection(profiler, DrawableObject::PROFILE_ENVIRONMENT_CALC));
+	obj->environmentCalc();
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::runHeadless(int frames, int width, int height, const char *profileFile,
+* 		const char *imageFile);
+*
+* @brief	Renders a fixed number of frames into an offscreen framebuffer and returns. The frames are
+* 			drawn with a window-less HeadlessContext where possible, falling back on the window's
+* 			context with the window created iconized. Each frame advances the simulation by exactly
+* 			refreshSeconds so that runs are repeatable.
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	frames	   	The number of frames to draw.
+* @param	width	   	The width of the offscreen framebuffer.
+* @param	height	   	The height of the offscreen framebuffer.
+* @param	profileFile	If not NULL, the profiler statistics are written here (.json for JSON, otherwise CSV)
+* @param	imageFile  	If not NULL, the last frame is written here as a TGA file
+*
+* @return	false if the GL context or the offscreen framebuffer could not be created.
+*/
+bool Gl_ShaderWindow::runHeadless(int frames, int width, int height, const char *profileFile, const char *imageFile){
+	FrameProfiler::Stats stats;
+	bool wasProfiling = profiler.isEnabled();
+
+	// the frames are driven from here, not from the timer. It goes before Fl::check(), or it could
+	// fire there and run a frame of input and simulation before init()
+	Fl::remove_timeout(timerCallback, this);
+
+	// the scene's GL objects belong to whichever context init() first ran in, so once the window
+	// has been drawn its context has to be kept. Otherwise try one that needs no window at all
+	if(headlessContext == NULL && !initialized){
+		headlessContext = new HeadlessContext();
+		if(!headlessContext->create() || !headlessContext->makeCurrent()){
+			fprintf(stderr, "Gl_ShaderWindow::runHeadless() falling back on a hidden window\n");
+			delete headlessContext;
+			headlessContext = NULL;
+		}
+	}else if(headlessContext != NULL){
+		headlessContext->makeCurrent();
+	}
+
+	if(headlessContext == NULL){
+		// FLTK only makes a GL context for a window that exists, so create it without showing it
+		Fl_Window *top = window();
+		while(top != NULL && top->window() != NULL)
+			top = top->window();
+		if(top != NULL && !top->shown())
+			top->iconize();
+		show();
+		Fl::check();
+		if(!shown()){
+			fprintf(stderr, "Gl_ShaderWindow::runHeadless() unable to create a GL context\n");
+			Fl::add_timeout(refreshSeconds, timerCallback, this);
+			return false;
+		}
+		make_current();
+	}
+
+	init(width, height);
+	valid(1);
+	assetLoader.finish(); // so that every frame is drawn with the real textures
+
+	offscreen = new OffscreenTarget();
+	if(!offscreen->create(screenWidth, screenHeight)){
+		delete offscreen;
+		offscreen = NULL;
+		Fl::add_timeout(refreshSeconds, timerCallback, this);
+		return false;
+	}
+
+	if(simulationStep <= 0.0f)
+		frameClock.setFixedStep(refreshSeconds);
+	profiler.setEnabled(true);
+
+	for(int i = 0; i < frames; ++i){
+		applySceneChanges();
+		replayInput();
+		coalesceInput();
+		if(simThread != NULL)
+			; // the simulation thread is calling environmentCalc()
+		else if(simulationStep > 0.0f)
+			advanceSimulation(refreshSeconds);
+		else
+			timedEnvironmentCalc();
+
+		profiler.begin(headlessFrameSection);
+		draw();
+		glFinish();
+		profiler.end(headlessFrameSection);
+		++frameCount;
+	}
+	if(inputRecorder.isReplaying())
+		finishReplay();
+
+	if(profiler.getStats(headlessFrameSection, stats))
+		printf("headless: %d frames at %dx%d, avg %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+			frames, screenWidth, screenHeight, stats.avgMs, stats.p95Ms, stats.p99Ms, stats.maxMs);
+
+	if(imageFile != NULL)
+		offscreen->saveTGA(imageFile);
+
+	if(profileFile != NULL)
+		writeProfile(profileFile);
+
+	offscreen->cleanup();
+	delete offscreen;
+	offscreen = NULL;
+
+	profiler.setEnabled(wasProfiling);
+	if(simulationStep <= 0.0f)
+		frameClock.setFixedStep(0.0); // back to measuring wall time
+	frameStopWatch.Reset();
+	Fl::add_timeout(refreshSeconds, timerCallback, this);
+	return true;
+}
+
+/**
+* @fn	void Gl_ShaderWindow::startRecording(const char *fileName);
+*
+* @brief	Starts recording every mouse event that handle() processes, along with the view it
+* 			started from
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	fileName	Filename of the log that stopRecording() writes.
+*/
+void Gl_ShaderWindow::startRecording(const char *fileName){
+	InputRecorder::ViewState view;
+
+	for(int i = 0; i < 3; ++i){
+		view.eyePos[i] = eyePos[i];
+		view.eyeOrient[i] = eyeOrient[i];
+		view.worldPos[i] = worldPos[i];
+		view.worldOrient[i] = worldOrient[i];
+		view.modelPos[i] = modelPos[i];
+	}
+	view.refreshSeconds = refreshSeconds;
+	view.mode = tmode;
+
+	recordFile = fileName;
+	inputRecorder.startRecording(view, frameCount);
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::stopRecording();
+*
+* @brief	Stops recording and writes the log
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @return	true if it succeeds, false if it fails or nothing was being recorded.
+*/
+bool Gl_ShaderWindow::stopRecording(){
+	if(!inputRecorder.isRecording())
+		return false;
+
+	inputRecorder.stopRecording(frameCount);
+	return inputRecorder.save(recordFile.c_str());
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::startReplay(const char *fileName, const char *profileFile);
+*
+* @brief	Loads a log written by stopRecording(), puts the view back where the recording started
+* 			and feeds the events back in on the same frames they were recorded in. Live mouse
+* 			events are ignored until the replay finishes. Each frame advances the simulation by
+* 			exactly refreshSeconds, and the profiler is reset and enabled so that the statistics
+* 			cover just the replay.
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	fileName   	Filename of the log.
+* @param	profileFile	If not NULL, the profiler statistics are written here when the replay finishes
+*
+* @return	false if the log can't be read.
+*/
+bool Gl_ShaderWindow::startReplay(const char *fileName, const char *profileFile){
+	if(!inputRecorder.load(fileName))
+		return false;
+
+	const InputRecorder::ViewState &view = inputRecorder.getViewState();
+	for(int i = 0; i < 3; ++i){
+		eyePos[i] = view.eyePos[i];
+		eyeOrient[i] = view.eyeOrient[i];
+		worldPos[i] = view.worldPos[i];
+		worldOrient[i] = view.worldOrient[i];
+		modelPos[i] = view.modelPos[i];
+	}
+	calcEyeVec();
+	tmode = (TRANSFORM_MODE)view.mode;
+	mouseX = mouseY = 0;
+	isPicking = false;
+	idPickPending = false;
+
+	if(view.refreshSeconds != refreshSeconds)
+		fprintf(stderr, "Gl_ShaderWindow::startReplay() log was recorded at %.4f seconds per frame, replaying at %.4f\n", 
+			view.refreshSeconds, refreshSeconds);
+
+	replayProfileFile = (profileFile != NULL) ? profileFile : "";
+	if(simulationStep <= 0.0f)
+		frameClock.setFixedStep(refreshSeconds);
+	simAccumulator = 0.0f;
+
+	profiler.reset();
+	pacer.resetStats();
+	profiler.setEnabled(true);
+	frameCount = 0;
+	frameStopWatch.Reset();
+	inputRecorder.startReplay();
+	return true;
+}
+
+/**
+* @fn	void Gl_ShaderWindow::replayInput();
+*
+* @brief	Feeds in the recorded events for the current frame, and finishes the replay once the
+* 			frame count reaches the end of the recording
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::replayInput(){
+	InputEvent e;
+
+	if(!inputRecorder.isReplaying())
+		return;
+
+	while(inputRecorder.nextEvent(frameCount, e)){
+		tmode = (TRANSFORM_MODE)e.mode;
+		processInput(e);
+	}
+
+	if(frameCount >= inputRecorder.getNumFrames() && offscreen == NULL)
+		finishReplay(); // runHeadless() finishes its own replays after the last frame is timed
+}
+
+/**
+* @fn	void Gl_ShaderWindow::finishReplay();
+*
+* @brief	Stops the replay and reports the frame time statistics
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::finishReplay(){
+	FrameProfiler::Stats stats;
+
+	inputRecorder.stopReplay();
+	if(simulationStep <= 0.0f)
+		frameClock.setFixedStep(0.0); // back to measuring wall time
+
+	printf("replay: %d frames, %d missed deadlines\n", frameCount, pacer.getMissedDeadlines());
+	for(int i = 0; i < profiler.getNumSections(); ++i){
+		if(profiler.getStats(i, stats))
+			printf("  %-32s avg %8.3f ms  p95 %8.3f ms  p99 %8.3f ms  max %8.3f ms\n", profiler.getSectionName(i), 
+				stats.avgMs, stats.p95Ms, stats.p99Ms, stats.maxMs);
+	}
+
+	if(!replayProfileFile.empty())
+		writeProfile(replayProfileFile.c_str());
+}
+
+/**
+* @fn	void Gl_ShaderWindow::writeProfile(const char *fileName);
+*
+* @brief	Writes the profiler statistics as JSON if the file name ends in .json, otherwise as CSV
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	fileName	Filename of the file.
+*/
+void Gl_ShaderWindow::writeProfile(const char *fileName){
+	const char *ext = strrchr(fileName, '.');
+	if(ext != NULL && _stricmp(ext, ".json") == 0)
+		profiler.dumpJSON(fileName);
+	else
+		profiler.dumpCSV(fileName);
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::addObject(DrawableObject *obj, SCENE_LAYER layer);
+*
+* @brief	Queues an object to be added to the scene at the start of the next frame. The window owns
+* 			it from then on
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	obj	the object.
+* @param	layer		The pass to draw it in.
+*
+* @return	false if the object was refused, in which case the caller still owns it.
+*/
+bool Gl_ShaderWindow::addObject(DrawableObject *obj, SCENE_LAYER layer){
+	SceneChange change = {obj, layer, true};
+
+	if(simThread != NULL && !obj->isSnapshotSafe()){
+		// render() would race the simulation thread
+		fprintf(stderr, "Gl_ShaderWindow::addObject() '%s' renders from live state\n", obj->getName());
+		return false;
+	}
+
+	EnterCriticalSection(&sceneChangeLock);
+	sceneChanges.push_back(change);
+	LeaveCriticalSection(&sceneChangeLock);
+	return true;
+}
+
+/**
+* @fn	void Gl_ShaderWindow::removeObject(DrawableObject *obj);
+*
+* @brief	Queues an object to be removed from the scene, cleaned up and deleted at the start of the
+* 			next frame
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	obj	the object.
+*/
+void Gl_ShaderWindow::removeObject(DrawableObject *obj){
+	SceneChange change = {obj, LAYER_WORLD, false};
+
+	EnterCriticalSection(&sceneChangeLock);
+	sceneChanges.push_back(change);
+	LeaveCriticalSection(&sceneChangeLock);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::applySceneChanges();
+*
+* @brief	Carries out the adds and removes queued since the last frame. Removing swaps the last
+* 			object in the layer into the gap, so draw order within a layer is not kept across removes
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::applySceneChanges(){
+	vector<SceneChange> changes;
+	float boxMin[3], boxMax[3];
+
+	EnterCriticalSection(&sceneChangeLock);
+	changes.swap(sceneChanges);
+	LeaveCriticalSection(&sceneChangeLock);
+
+	if(changes.empty())
+		return;
+
+	requestRedraw();
+	EnterCriticalSection(&sceneLock);
+	for(unsigned int i = 0; i < changes.size(); ++i){
+		SceneChange &c = changes[i];
+		if(c.add){
+			sceneObjects[c.layer].push_back(c.obj);
+			c.obj->setPickId(nextPickId++);
+			pickIds[c.obj->getPickId()] = c.obj;
+			if(c.layer == LAYER_WORLD && c.obj->getWorldBounds(boxMin, boxMax))
+				c.obj->setSpatialProxy(sceneBVH.insert(c.obj, boxMin, boxMax));
+			// the snapshot the constructor published is from before the subclass placed the object.
+			// The simulation thread publishes under sceneLock too, so this doesn't race it
+			if(simThread != NULL)
+				c.obj->publishState();
+			continue;
+		}
+
+		for(int layer = 0; layer < NUM_LAYERS; ++layer){
+			vector<DrawableObject*> &objects = sceneObjects[layer];
+			for(unsigned int j = 0; j < objects.size(); ++j){
+				if(objects[j] == c.obj){
+					objects[j] = objects.back();
+					objects.pop_back();
+					pickIds.erase(c.obj->getPickId());
+					if(c.obj->getSpatialProxy() != DynamicBVH::NULL_NODE)
+						sceneBVH.remove(c.obj->getSpatialProxy());
+					retiredObjects.push_back(c.obj);
+					layer = NUM_LAYERS; // done
+					break;
+				}
+			}
+		}
+	}
+	LeaveCriticalSection(&sceneLock);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::deleteRetiredObjects();
+*
+* @brief	Cleans up and deletes the objects that applySceneChanges() took out of the scene, taking
+* 			them out of the pick selection first
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::deleteRetiredObjects(){
+	for(unsigned int i = 0; i < retiredObjects.size(); ++i){
+		// pickSelection is filled on this thread, and ray picks keep it sorted by distance
+		for(unsigned int j = 0; j < pickSelection.size(); ){
+			if(pickSelection[j] == retiredObjects[i])
+				pickSelection.erase(pickSelection.begin() + j);
+			else
+				++j;
+		}
+		retiredObjects[i]->cleanup();
+		delete retiredObjects[i];
+	}
+	retiredObjects.clear();
+}
+
+/**
+* @fn	void Gl_ShaderWindow::calcScene();
+*
+* @brief	Calls environmentCalc() on every object in the scene
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::calcScene(){
+	for(int layer = 0; layer < NUM_LAYERS; ++layer){
+		vector<DrawableObject*> &objects = sceneObjects[layer];
+
+		if(jobSystem == NULL){
+			for(unsigned int i = 0; i < objects.size(); ++i)
+				calcObject(objects[i]);
+			continue;
+		}
+
+		CalcSceneJob job = {this, &objects};
+		jobSystem->parallelFor((int)objects.size(), 8, calcSceneRange, &job);
+
+		// the objects that can't leave this thread
+		for(unsigned int i = 0; i < objects.size(); ++i){
+			if(!objects[i]->isParallelCalc())
+				calcObject(objects[i]);
+		}
+	}
+}
+
+/**
+* @fn	void Gl_ShaderWindow::calcSceneRange(void *data, int begin, int end);
+*
+* @brief	JobSystem callback that updates objects [begin, end) of a layer, skipping any that haven't
+* 			opted in to parallel update
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	data	The CalcSceneJob.
+* @param	begin			The first object.
+* @param	end				One past the last object.
+*/
+void Gl_ShaderWindow::calcSceneRange(void *data, int begin, int end){
+	CalcSceneJob *job = (CalcSceneJob*)data;
+	vector<DrawableObject*> &objects = *job->objects;
+
+	for(int i = begin; i < end; ++i){
+		if(objects[i]->isParallelCalc())
+			job->window->calcObject(objects[i]);
+	}
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::setParallelUpdate(bool enable, int numThreads);
+*
+* @brief	Turns parallel-update mode on or off.
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	enable	  	true to enable.
+* @param	numThreads	The number of worker threads. Zero uses one per core, less one
+*
+* @return	true if parallel update is on.
+*/
+bool Gl_ShaderWindow::setParallelUpdate(bool enable, int numThreads){
+	// the simulation thread may be in the middle of calcScene()
+	EnterCriticalSection(&sceneLock);
+	if(enable && jobSystem == NULL){
+		jobSystem = new JobSystem(numThreads);
+	}else if(!enable && jobSystem != NULL){
+		delete jobSystem;
+		jobSystem = NULL;
+	}
+	LeaveCriticalSection(&sceneLock);
+	return jobSystem != NULL;
+}
+
+/**
+* @fn	void Gl_ShaderWindow::renderScene(SCENE_LAYER layer);
+*
+* @brief	Renders every object in one layer of the scene
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	layer	The layer.
+*/
+void Gl_ShaderWindow::renderScene(SCENE_LAYER layer){
+	vector<DrawableObject*> &objects = sceneObjects[layer];
+
+	if(layer != LAYER_WORLD){
+		for(unsigned int i = 0; i < objects.size(); ++i)
+			renderObject(objects[i]);
+		return;
+	}
+
+	int count = (int)objects.size();
+	bool culling = frustumCulling && frustumCuller.isValid();
+
+	// gather the spheres into arrays and test them all in one batch
+	if(culling){
+		cullX.resize(count);
+		cullY.resize(count);
+		cullZ.resize(count);
+		cullRadius.resize(count);
+		cullMask.resize(FrustumCuller::maskWords(count) + 1); // never empty, so &cullMask[0] is valid
+		for(int i = 0; i < count; ++i){
+			const DrawableState &state = objects[i]->getRenderState();
+			cullX[i] = state.position[0];
+			cullY[i] = state.position[1];
+			cullZ[i] = state.position[2];
+			cullRadius[i] = objects[i]->getBoundingSphereRadius();
+		}
+		if(count > 0)
+			frustumCuller.cullSpheres(&cullX[0], &cullY[0], &cullZ[0], &cullRadius[0], count, &cullMask[0]);
+	}
+
+	visibleCount = culledCount = 0;
+	for(int i = 0; i < count; ++i){
+		if(culling && !FrustumCuller::isVisible(&cullMask[0], i)){
+			++culledCount;
+			continue;
+		}
+		renderObject(objects[i]);
+		++visibleCount;
+	}
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::isCulled(DrawableObject *obj);
+*
+* @brief	Tests an object's bounding sphere, around the position it is about to be drawn at, against
+* 			the frustum set up by preDraw3D(). Outside preDraw3D() and postDraw3D() there is no frustum
+* 			and nothing is culled
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	obj	The object.
+*
+* @return	true if the object can be skipped.
+*/
+bool Gl_ShaderWindow::isCulled(DrawableObject *obj){
+	float radius = obj->getBoundingSphereRadius();
+
+	// no radius means no bounds to test, rather than a point
+	if(!frustumCulling || !frustumCuller.isValid() || radius <= 0.0f)
+		return false;
+	return !frustumCuller.isSphereVisible(obj->getRenderState().position, radius);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::cleanupScene();
+*
+* @brief	Cleans up and deletes every object in the scene, including any still waiting to be added
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::cleanupScene(){
+	// cleanup() deletes GL objects, so they have to go from the context they were made in
+	if(headlessContext != NULL)
+		headlessContext->makeCurrent();
+	else if(shown())
+		make_current();
+	applySceneChanges();
+	deleteRetiredObjects();
+	for(int layer = 0; layer < NUM_LAYERS; ++layer){
+		vector<DrawableObject*> &objects = sceneObjects[layer];
+		for(unsigned int i = 0; i < objects.size(); ++i){
+			objects[i]->cleanup();
+			delete objects[i];
+		}
+		objects.clear();
+	}
+	pickIds.clear();
+	pickSelection.clear();
+	sceneBVH.clear();
+}
+
+/**
+* @fn	void Gl_ShaderWindow::publishSimObjects();
+*
+* @brief	Calls publishState() on every object in the scene
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::publishSimObjects(){
+	for(int layer = 0; layer < NUM_LAYERS; ++layer){
+		vector<DrawableObject*> &objects = sceneObjects[layer];
+		for(unsigned int i = 0; i < objects.size(); ++i)
+			objects[i]->publishState();
+	}
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::startSimulationThread();
+*
+* @brief	Moves environmentCalc() off the FLTK thread and onto a thread of its own. 
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @return	true if the thread is running.
+*/
+bool Gl_ShaderWindow::startSimulationThread(){
+	if(simThread != NULL)
+		return true;
+
+	// make sure the snapshots are current before anyone draws from them
+	applySceneChanges();
+	for(int layer = 0; layer < NUM_LAYERS; ++layer){
+		vector<DrawableObject*> &objects = sceneObjects[layer];
+		for(unsigned int i = 0; i < objects.size(); ++i){
+			if(!objects[i]->isSnapshotSafe()){
+				fprintf(stderr, "Gl_ShaderWindow::startSimulationThread() '%s' renders from live state\n", objects[i]->getName());
+				return false;
+			}
+		}
+	}
+	publishSimObjects();
+	DrawableObject::setUseSnapshots(true);
+	DrawableObject::setInterpolationAlpha(1.0f);
+
+	simThreadQuit = 0;
+	simStopWatch.Reset();
+	simAccumulator = 0.0f;
+	simThread = CreateThread(NULL, 0, simThreadProc, this, 0, NULL);
+	if(simThread == NULL){
+		fprintf(stderr, "Gl_ShaderWindow::startSimulationThread() CreateThread failed: %d\n", GetLastError());
+		DrawableObject::setUseSnapshots(false);
+		return false;
+	}
+	return true;
+}
+
+/**
+* @fn	void Gl_ShaderWindow::stopSimulationThread();
+*
+* @brief	Stops the simulation thread and waits for it to finish. environmentCalc() goes back to being
+* 			called from the timer.
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::stopSimulationThread(){
+	if(simThread == NULL)
+		return;
+
+	InterlockedExchange(&simThreadQuit, 1);
+	WaitForSingleObject(simThread, INFINITE);
+	CloseHandle(simThread);
+	simThread = NULL;
+
+	DrawableObject::setUseSnapshots(false);
+	simStopWatch.Reset();
+	simAccumulator = 0.0f;
+}
+
+/**
+* @fn	static DWORD WINAPI Gl_ShaderWindow::simThreadProc(LPVOID data);
+*
+* @brief	The simulation thread's loop. Runs environmentCalc() at the fixed simulation rate (or once every
+* 			refreshSeconds if there isn't one), publishes the results, and sleeps until the next step is due
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	data	pointer to this window
+*
+* @return	0 when the thread exits
+*/
+DWORD WINAPI Gl_ShaderWindow::simThreadProc(LPVOID data){
+	Gl_ShaderWindow *gvw = (Gl_ShaderWindow*)data;
+	float waitSeconds;
+
+	while(gvw->simThreadQuit == 0){
+		EnterCriticalSection(&gvw->sceneLock);
+		if(gvw->simulationStep > 0.0f){
+			gvw->stepSimulation();
+			waitSeconds = gvw->simulationStep - gvw->simAccumulator;
+		}else{
+			gvw->timedEnvironmentCalc();
+			waitSeconds = gvw->refreshSeconds;
+		}
+		gvw->publishSimObjects();
+		LeaveCriticalSection(&gvw->sceneLock);
+
+		// Sleep() is coarse, but the accumulator in stepSimulation() catches up on any steps we oversleep
+		Sleep((DWORD)(waitSeconds*1000.0f));
+	}
+	return 0;
 }
 
 /**
@@ -113,7 +1108,8 @@ void Gl_ShaderWindow::timerCallback(void* data){
 *				glClearColor(0.75, 0.75, 0.75, 0.75);
 *				view frustum of 45 degrees horizontal
 * 				
-* 			Also prints the GL_VERSION and all extensions to the console
+* 			Also prints the GL_VERSION to the console. Call GLCapabilities::setVerbose(true) first
+* 			to print all the limits and extensions as well
 *
 * @author	Phil
 * @date	3/15/2012
@@ -136,17 +1132,8 @@ void Gl_ShaderWindow::init(int width, int height)
 			exit(-1);
 		}
 
-		fprintf(stderr, "GL_VERSION: %s\n", glGetString(GL_VERSION));
-		string str = string((char *)glGetString(GL_EXTENSIONS ));
-		char *cstr = new char [str.size()+1];
-		strcpy (cstr, str.c_str());
-		char *p=strtok (cstr," ");
-		while (p!=NULL)
-		{
-			printf("%s\n", p);
-			p=strtok(NULL," ");
-		}
-		delete[] cstr;
+		GLCapabilities::reset(); // this may be a new context
+		fprintf(stderr, "GL_VERSION: %s\n", GLCapabilities::getVersion());
 
 		shaderManager.InitializeStockShaders();
 
@@ -158,6 +1145,8 @@ void Gl_ShaderWindow::init(int width, int height)
 		glClearColor(0.75, 0.75, 0.75, 0.75);
 
 		localInit(); 
+		applySceneChanges(); // so that objects added in localInit() are drawn in the first frame
+		frameClock.reset(); // so that loading time doesn't show up as the first step
 		initialized = true;
 	}
 
@@ -182,7 +1171,17 @@ void Gl_ShaderWindow::init(int width, int height)
 * @date	3/15/2012
 */
 void Gl_ShaderWindow::cleanup(){
+	stopSimulationThread();
+	stopRecording();
+	setParallelUpdate(false);
+	assetLoader.cleanup(); // before the objects go, since pending uploads may refer to them
+	idBuffer.cleanup();
 	localCleanup();
+	cleanupScene();
+	if(headlessContext != NULL){
+		delete headlessContext;
+		headlessContext = NULL;
+	}
 }
 
 
@@ -283,56 +1282,439 @@ void Gl_ShaderWindow::setPickMatrix(GLdouble x, GLdouble y, GLdouble deltax, GLd
 *
 */
 int Gl_ShaderWindow::handle(int event){
+	InputEvent e;
+
+	if(event != FL_PUSH && event != FL_DRAG && event != FL_RELEASE && event != FL_MOUSEWHEEL)
+		return __super::handle(event);
+
+	// while a log is replaying, it is the only thing allowed to move the view
+	if(inputRecorder.isReplaying())
+		return (event == FL_PUSH) ? 1 : __super::handle(event);
+
+	e = InputEvent::fromFltk(event, frameCount, tmode);
+
+	if(event == FL_PUSH && e.button == 3){
+		// Dynamically create menu, pop it up
+		popupMenu = new Fl_Menu_Button(e.x, e.y, 80, 1);
+
+		popupMenu->add("Eyepoint",  0, Menu_CB, (void*)this);
+		popupMenu->add("Rotate World",  0, Menu_CB, (void*)this);
+		popupMenu->add("Move World", 0, Menu_CB, (void*)this);
+		popupMenu->add("Move Model", 0, Menu_CB, (void*)this);
+		popupMenu->add("Pick", 0, Menu_CB, (void*)this);
+		popupMenu->popup();
+	}
+
+	// applied once per frame by coalesceInput(). If a long frame has filled the queue, drain it
+	// now; handle() and the timer both run on the FLTK thread, so that is safe
+	if(!inputQueue.push(e)){
+		coalesceInput();
+		inputQueue.push(e);
+	}
+
+	return (event == FL_PUSH) ? 1 : __super::handle(event);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::pollPickResults();
+*
+* @brief	Collects any finished picks from the objects in the scene, which hands them to each
+* 			object's pick callback. Only GL_QUERY_RESULT_AVAILABLE is asked for until a result is ready,
+* 			so this never waits on the GPU
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::pollPickResults(){
+	for(int layer = 0; layer < NUM_LAYERS; ++layer){
+		vector<DrawableObject*> &objects = sceneObjects[layer];
+		for(unsigned int i = 0; i < objects.size(); ++i){
+			while(objects[i]->isPickPending() && objects[i]->pickResult() != DrawableObject::UNAVAILABLE)
+				; // drain everything that has finished
+		}
+	}
+}
+
+/**
+* @fn	void Gl_ShaderWindow::requestIdPick(int x, int y, int w, int h);
+*
+* @brief	Asks for the world objects in a rectangle of the window to be picked through the IdBuffer
+* 			on the next frame. A second request before then replaces the first
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	x	The left edge, in window coordinates.
+* @param	y	The top edge, in window coordinates.
+* @param	w	The width.
+* @param	h	The height.
+*/
+void Gl_ShaderWindow::requestIdPick(int x, int y, int w, int h){
+	idPickRect[0] = x;
+	idPickRect[1] = y;
+	idPickRect[2] = w;
+	idPickRect[3] = h;
+	idPickPending = true;
+	requestRedraw();
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::getPickRay(int x, int y, M3DVector3f origin, M3DVector3f dir);
+*
+* @brief	Makes the world space ray under a window position, using the view that the last frame was
+* 			drawn with
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	x	  	The x coordinate, in window coordinates.
+* @param	y	  	The y coordinate, in window coordinates.
+* @param	origin	[out] The start of the ray.
+* @param	dir   	[out] The unit direction of the ray.
+*
+* @return	false if no frame has been drawn yet.
+*/
+bool Gl_ShaderWindow::getPickRay(int x, int y, M3DVector3f origin, M3DVector3f dir){
+	M3DMatrix44f modelView, projection;
+	int viewport[4];
+
+	EnterCriticalSection(&pickViewLock);
+	bool hasView = hasPickView;
+	memcpy(modelView, pickModelView, sizeof(modelView));
+	memcpy(projection, pickProjection, sizeof(projection));
+	for(int i = 0; i < 4; ++i)
+		viewport[i] = pickViewport[i];
+	LeaveCriticalSection(&pickViewLock);
+
+	if(!hasView)
+		return false;
+
+	// aim at the middle of the pixel. FLTK's y runs down the window, GL's runs up
+	return RayCaster::unproject(modelView, projection, viewport, x + 0.5f, viewport[3] - y - 0.5f, origin, dir);
+}
+
+/**
+* @fn	int Gl_ShaderWindow::rayPick(int x, int y, vector<RayCaster::Hit> &hits);
+*
+* @brief	Picks the world objects under a window position on the CPU, by casting a ray against their
+* 			bounding volumes
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	x		  	The x coordinate, in window coordinates.
+* @param	y		  	The y coordinate, in window coordinates.
+* @param [out]	hits	The objects hit, nearest first.
+*
+* @return	The number of objects hit.
+*/
+int Gl_ShaderWindow::rayPick(int x, int y, vector<RayCaster::Hit> &hits){
+	M3DVector3f origin, dir;
+
+	hits.clear();
+	if(!getPickRay(x, y, origin, dir))
+		return 0;
+
+	// the lock keeps applySceneChanges() and the simulation from changing the tree underneath us
+	EnterCriticalSection(&sceneLock);
+	sceneBVH.castRay(origin, dir, hits);
+	LeaveCriticalSection(&sceneLock);
+	return (int)hits.size();
+}
+
+/**
+* @fn	int Gl_ShaderWindow::queryBox(const float boxMin[3], const float boxMax[3],
+* 		vector<DrawableObject*> &results);
+*
+* @brief	Finds the world objects whose bounds overlap a box
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	boxMin		   	The minimum corner.
+* @param	boxMax		   	The maximum corner.
+* @param [out]	results	The objects.
+*
+* @return	The number of objects found.
+*/
+int Gl_ShaderWindow::queryBox(const float boxMin[3], const float boxMax[3], vector<DrawableObject*> &results){
+	EnterCriticalSection(&sceneLock);
+	int count = sceneBVH.queryBox(boxMin, boxMax, results);
+	LeaveCriticalSection(&sceneLock);
+	return count;
+}
+
+/**
+* @fn	int Gl_ShaderWindow::querySphere(const float center[3], float radius,
+* 		vector<DrawableObject*> &results);
+*
+* @brief	Finds the world objects whose bounds come within 'radius' of a point
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	center		   	The center.
+* @param	radius		   	The radius.
+* @param [out]	results	The objects.
+*
+* @return	The number of objects found.
+*/
+int Gl_ShaderWindow::querySphere(const float center[3], float radius, vector<DrawableObject*> &results){
+	EnterCriticalSection(&sceneLock);
+	int count = sceneBVH.querySphere(center, radius, results);
+	LeaveCriticalSection(&sceneLock);
+	return count;
+}
+
+/**
+* @fn	int Gl_ShaderWindow::queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results);
+*
+* @brief	Finds the world objects whose bounds might be inside a frustum
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param [in,out]	frustum	The frustum.
+* @param [out]	results	   	The objects.
+*
+* @return	The number of objects found.
+*/
+int Gl_ShaderWindow::queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results){
+	EnterCriticalSection(&sceneLock);
+	int count = sceneBVH.queryFrustum(frustum, results);
+	LeaveCriticalSection(&sceneLock);
+	return count;
+}
+
+/**
+* @fn	void Gl_ShaderWindow::renderIdPass();
+*
+* @brief	Draws the world objects into the IdBuffer for the requested pick rectangle, then binds the
+* 			normal draw target again. Each object is drawn with its own render(), so nothing has to be
+* 			added to the objects for them to be pickable
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::renderIdPass(){
+	ProfileScope scope(profiler, idPassSection);
+	vector<DrawableObject*> &objects = sceneObjects[LAYER_WORLD];
+
+	idPickPending = false;
+	if(idBuffer.getWidth() != screenWidth || idBuffer.getHeight() != screenHeight || !idBuffer.isValid()){
+		if(!idBuffer.create(screenWidth, screenHeight))
+			return;
+	}
+
+	// FLTK's y runs down the window, GL's runs up
+	if(!idBuffer.begin(idPickRect[0], screenHeight - idPickRect[1] - idPickRect[3], idPickRect[2], idPickRect[3]))
+		return;
+
+	for(unsigned int i = 0; i < objects.size(); ++i){
+		if(isCulled(objects[i]))
+			continue;
+		idBuffer.beginObject();
+		objects[i]->render(modelViewMatrix, projectionMatrix, shaderManager);
+		idBuffer.endObject(objects[i]->getPickId());
+	}
+
+	idBuffer.end();
+	bindDrawTarget();
+}
+
+/**
+* @fn	void Gl_ShaderWindow::pollIdPick();
+*
+* @brief	Collects a finished IdBuffer pick, if there is one. The objects that were picked go into
+* 			pickSelection and are passed to their pick callbacks as hits; objects that weren't picked
+* 			aren't called, since with thousands of objects that would be thousands of misses. Objects
+* 			removed since the pick was drawn are left out
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::pollIdPick(){
+	vector<GLuint> ids;
+	map<GLuint, DrawableObject*>::iterator it;
+
+	while(idBuffer.getResult(ids)){
+		pickSelection.clear();
+		for(unsigned int i = 0; i < ids.size(); ++i){
+			it = pickIds.find(ids[i]);
+			if(it != pickIds.end())
+				pickSelection.push_back(it->second);
+		}
+		for(unsigned int i = 0; i < pickSelection.size(); ++i)
+			pickSelection[i]->notifyPick(true);
+	}
+}
+
+/**
+* @fn	bool Gl_ShaderWindow::needsRedraw();
+*
+* @brief	Decides whether on-demand mode should draw a frame this tick. Every object's dirty flag is
+* 			read and cleared, even once the answer is known, so that old changes don't cause an extra
+* 			frame later.
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @return	true if something has changed since the last frame.
+*/
+bool Gl_ShaderWindow::needsRedraw(){
+	bool changed = InterlockedExchange(&redrawRequested, 0) != 0;
+
+	if(isPicking || idPickPending || idBuffer.isPending() || assetLoader.getNumPending() > 0)
+		changed = true;
+
+	for(int layer = 0; layer < NUM_LAYERS; ++layer){
+		vector<DrawableObject*> &objects = sceneObjects[layer];
+		for(unsigned int i = 0; i < objects.size(); ++i){
+			if(objects[i]->takeDirty() || objects[i]->isAnimating() || objects[i]->isPickPending())
+				changed = true;
+		}
+	}
+	return changed;
+}
+
+/**
+* @fn	void Gl_ShaderWindow::coalesceInput();
+*
+* @brief	Drains the events queued by handle() since the last frame and applies them as a few
+* 			combined events. A drag only needs its last position, since processInput() takes the
+* 			delta from lastMouseX/Y, and wheel deltas add. A press or release ends the run, so that
+* 			everything before it is applied first. The combined events are what gets recorded, so a
+* 			replay takes exactly the same steps.
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::coalesceInput(){
+	InputEvent e, drag, wheel;
+	bool hasDrag = false;
+	bool hasWheel = false;
+
+	while(inputQueue.pop(e)){
+		if(e.type == FL_DRAG){
+			if(hasDrag && (drag.mode != e.mode || drag.buttons != e.buttons))
+				dispatchInput(drag);
+			drag = e;
+			hasDrag = true;
+		}else if(e.type == FL_MOUSEWHEEL){
+			if(hasWheel && wheel.mode == e.mode){
+				wheel.dy += e.dy;
+			}else{
+				if(hasWheel)
+					dispatchInput(wheel);
+				wheel = e;
+				hasWheel = true;
+			}
+		}else{
+			if(hasDrag)
+				dispatchInput(drag);
+			if(hasWheel)
+				dispatchInput(wheel);
+			hasDrag = hasWheel = false;
+			dispatchInput(e);
+		}
+	}
+
+	if(hasDrag)
+		dispatchInput(drag);
+	if(hasWheel)
+		dispatchInput(wheel);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::dispatchInput(const InputEvent &e);
+*
+* @brief	Records an event if recording, then applies it with processInput()
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	e	The event.
+*/
+void Gl_ShaderWindow::dispatchInput(const InputEvent &e){
+	if(inputRecorder.isRecording())
+		inputRecorder.record(e);
+	processInput(e);
+}
+
+/**
+* @fn	void Gl_ShaderWindow::processInput(const InputEvent &e);
+*
+* @brief	Applies a mouse event to the eyepoint, world and model transforms. Called by coalesceInput()
+* 			for live events and by replayInput() for recorded ones, so both take exactly the same path
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	e	The event.
+*/
+void Gl_ShaderWindow::processInput(const InputEvent &e){
 	float xtemp = 0.0f;
 	float ytemp = 0.0f;
 	float ztemp = 0.0f;
-	int keyCode = 0;
-	
-	switch(event){
+
+	requestRedraw();
+
+	switch(e.type){
 	case FL_PUSH: // set the values
-		//printf("Gl_ShaderWindow::handle(FL_PUSH): Mouse = %d, %d\n", Fl::event_x(), Fl::event_y());
-		lastMouseX = Fl::event_x();
-		lastMouseY = Fl::event_y();
-
-		if ( Fl::event_button() == 3 ) {
-			// Dynamically create menu, pop it up
-			popupMenu = new Fl_Menu_Button(Fl::event_x(), Fl::event_y(), 80, 1);
-
-			popupMenu->add("Eyepoint",  0, Menu_CB, (void*)this);
-			popupMenu->add("Rotate World",  0, Menu_CB, (void*)this);
-			popupMenu->add("Move World", 0, Menu_CB, (void*)this);
-			popupMenu->add("Move Model", 0, Menu_CB, (void*)this);
-			popupMenu->add("Pick", 0, Menu_CB, (void*)this);
-			popupMenu->popup();
-		}
+		//printf("Gl_ShaderWindow::handle(FL_PUSH): Mouse = %d, %d\n", e.x, e.y);
+		lastMouseX = e.x;
+		lastMouseY = e.y;
+
+		if((tmode == PICK)&&( e.button == 1 )){
+			if(pickMode == PICK_ID_BUFFER){
+				pickStartX = e.x;
+				pickStartY = e.y;
+			}else if(pickMode == PICK_RAY){
+				vector<RayCaster::Hit> hits;
 
-		if((tmode == PICK)&&( Fl::event_button() == 1 )){
-			isPicking = true;
+				rayPick(e.x, e.y, hits);
+				pickSelection.clear();
+				for(unsigned int i = 0; i < hits.size(); ++i){
+					pickSelection.push_back(hits[i].obj);
+					hits[i].obj->notifyPick(true);
+				}
+			}else{
+				isPicking = true;
+			}
 		}
-		return 1;
+		return;
 	case FL_DRAG: // subtract from the values
 		
-		mouseX = lastMouseX - Fl::event_x();
-		mouseY = lastMouseY - Fl::event_y();
-		lastMouseX = Fl::event_x();
-		lastMouseY = Fl::event_y();
+		mouseX = lastMouseX - e.x;
+		mouseY = lastMouseY - e.y;
+		lastMouseX = e.x;
+		lastMouseY = e.y;
 		//printf("Gl_ShaderWindow::handle(FL_DRAG): Button = %d, Mouse = %d, %d\n", Fl::event_buttons(), mouseX, mouseY);
 		break;
 	case FL_RELEASE:
-		//printf("Gl_ShaderWindow::handle(FL_RELEASE): Mouse = %d, %d\n", Fl::event_x(), Fl::event_y());
+		//printf("Gl_ShaderWindow::handle(FL_RELEASE): Mouse = %d, %d\n", e.x, e.y);
 		mouseX = 0;
 		mouseY = 0;
-		if((tmode == PICK)&&( Fl::event_button() == 1 )){
+		if((tmode == PICK)&&( e.button == 1 )){
 			isPicking = false;
+			if(pickMode == PICK_ID_BUFFER){
+				int w = abs(e.x - pickStartX);
+				int h = abs(e.y - pickStartY);
+
+				if(w < 3 && h < 3) // a click. Give it the same 10 pixel slop as setPickMatrix()
+					requestIdPick(e.x - 5, e.y - 5, 10, 10);
+				else
+					requestIdPick(min(e.x, pickStartX), min(e.y, pickStartY), w + 1, h + 1);
+			}
 		}
 		break;
 	case FL_MOUSEWHEEL:
-		//printf("Gl_ShaderWindow::handle(FL_MOUSEWHEEL): Mouse delta = %d, %d\n", Fl::event_dx(), Fl::event_dy());
+		//printf("Gl_ShaderWindow::handle(FL_MOUSEWHEEL): Mouse delta = %d, %d\n", Fl::event_dx(), e.dy);
 		if(tmode == WORLD_ROTATE || tmode == WORLD_MOVE){
-			ztemp = (Fl::event_dy() * mouseWheelScalar);
+			ztemp = (e.dy * mouseWheelScalar);
 			worldPos[2] += ztemp;
 		}else if(tmode == EYE_ROTATE || tmode == EYE_MOVE){ // EYE
-			float vecSize = Fl::event_dy() * mouseWheelScalar;
+			float vecSize = e.dy * mouseWheelScalar;
 			eyePos[0] += (vecSize * eyeVec[0]); 
 			eyePos[1] += (vecSize * eyeVec[1]); 
 			eyePos[2] += (vecSize * eyeVec[2]); 
@@ -345,53 +1727,50 @@ int Gl_ShaderWindow::handle(int event){
 
 
 	if(tmode == WORLD_MOVE){
-		if(Fl::event_button1()){
+		if(e.button1()){
 			worldPos[0] -= mouseX * transScalar;
 			worldPos[1] += mouseY * transScalar;
-		}else if(Fl::event_button2()){
+		}else if(e.button2()){
 			worldPos[2] += mouseY * transScalar;
 		} 
 	}else if(tmode == WORLD_ROTATE){
-		if(Fl::event_button1()){
+		if(e.button1()){
 			xtemp = -mouseY * rotScalar;
 			ytemp = -mouseX * rotScalar;
 			worldOrient[0] += xtemp;
 			worldOrient[1] += ytemp;	
-		}else if(Fl::event_button2()){
+		}else if(e.button2()){
 			ztemp = mouseY * transScalar;
 			worldPos[2] += ztemp;
 		}	
 	}else if(tmode == MODEL_MOVE){
-		if(Fl::event_button1()){
+		if(e.button1()){
 			modelPos[0] += mouseX * modelTransScalar;
 			modelPos[2] += mouseY * modelTransScalar;
 		}
 		
 	}else if(tmode == EYE_MOVE){
-		if(Fl::event_button1()){
+		if(e.button1()){
 			eyePos[0] -= mouseX * transScalar; // moving "Left" and "Right" WRT the screen
 			eyePos[1] += mouseY * transScalar; // moving "Up" and "Down" WRT the screen
-		}else if(Fl::event_button2()){ // eyepos must be calculated with respect to the orientation
+		}else if(e.button2()){ // eyepos must be calculated with respect to the orientation
 			float vecSize = -mouseY * transScalar; // moving "In" and "Out" WRT the screen
 			eyePos[0] += (vecSize * eyeVec[0]); 
 			eyePos[1] += (vecSize * eyeVec[1]); 
 			eyePos[2] += (vecSize * eyeVec[2]); 
 		}
 	}else if(tmode == EYE_ROTATE){
-		if(Fl::event_button1()){
+		if(e.button1()){
 			eyeOrient[0] -= mouseY * rotScalar;
 			eyeOrient[1] -= mouseX * rotScalar;
 			calcEyeVec();
-		}else if(Fl::event_button2()){ // eyepos must be calculated with respect to the orientation
+		}else if(e.button2()){ // eyepos must be calculated with respect to the orientation
 			float vecSize = -mouseY * transScalar; // moving "In" and "Out" WRT the screen
 			eyePos[0] += (vecSize * eyeVec[0]); 
 			eyePos[1] += (vecSize * eyeVec[1]); 
 			eyePos[2] += (vecSize * eyeVec[2]); 
 		}
 	}
-
-
-	return __super::handle(event);
 }
 
 /**
@@ -413,11 +1792,28 @@ void Gl_ShaderWindow::draw3Dsetup(){
 	//Dprint::add("Gl_ShaderWindow::draw3Dsetup() - size = (%.2f, %.2f)", width, height);
 
 
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-	glDrawBuffers(1, windowBuff);
+	bindDrawTarget();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
+/**
+* @fn	void Gl_ShaderWindow::bindDrawTarget();
+*
+* @brief	Binds the framebuffer that frames are drawn into: the offscreen target in headless mode,
+* 			otherwise the window's back buffer
+*
+* @author	agent
+* @date	10/17/2026
+*/
+void Gl_ShaderWindow::bindDrawTarget(){
+	if(offscreen != NULL){
+		offscreen->bind();
+	}else{
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		glDrawBuffers(1, windowBuff);
+	}
+}
+
 /**
 * @fn	void Gl_ShaderWindow::postDraw3D();
 *
@@ -427,6 +1823,7 @@ void Gl_ShaderWindow::draw3Dsetup(){
 * @date	3/15/2012
 */
 void Gl_ShaderWindow::preDraw3D() {
+	ProfileScope scope(profiler, preDraw3DSection);
 	GLint viewport[4];
 	glGetIntegerv(GL_VIEWPORT,viewport);
 
@@ -438,6 +1835,17 @@ void Gl_ShaderWindow::preDraw3D() {
 		if(!valid()){
 		init(w(), h());
 	}
+	if(swapIntervalPending){
+		FramePacer::setSwapInterval(swapInterval);
+		swapIntervalPending = false;
+	}
+
+	deleteRetiredObjects();
+	profiler.begin(assetUploadSection);
+	assetLoader.update(assetBudgetMs);
+	profiler.end(assetUploadSection);
+	pollPickResults();
+	pollIdPick();
 
 	draw3Dsetup();
 
@@ -454,11 +1862,26 @@ void Gl_ShaderWindow::preDraw3D() {
 
 		modelViewMatrix.Rotate(worldOrient[0], 1, 0, 0);
 		modelViewMatrix.Rotate(worldOrient[1], 0, 1, 0);
+
+		// keep the view for getPickRay(), before setPickMatrix() narrows it
+		EnterCriticalSection(&pickViewLock);
+		modelViewMatrix.GetMatrix(pickModelView);
+		projectionMatrix.GetMatrix(pickProjection);
+		for(int i = 0; i < 4; ++i)
+			pickViewport[i] = viewport[i];
+		hasPickView = true;
+		LeaveCriticalSection(&pickViewLock);
+
+		// renderScene() culls against the same view
+		frustumCuller.setViewProjection(modelViewMatrix.GetMatrix(), projectionMatrix.GetMatrix());
+		DrawableObject::setViewportHeight(viewport[3]);
 		
 		// set up picking
 		if(isPicking){
 			setPickMatrix(lastMouseX,viewport[3]-lastMouseY,10,10,viewport);
 			//printf("Started Picking\n");
+		}else if(idPickPending){
+			renderIdPass();
 		}
 }
 
@@ -472,6 +1895,7 @@ void Gl_ShaderWindow::preDraw3D() {
 * @date	3/15/2012
 */
 void Gl_ShaderWindow::postDraw3D() {
+	ProfileScope scope(profiler, postDraw3DSection);
 	// finish up picking
 	if(isPicking){
 		isPicking = false;
@@ -479,6 +1903,7 @@ void Gl_ShaderWindow::postDraw3D() {
 		//printf("Finished Picking\n");
 	}
 	modelViewMatrix.PopMatrix();
+	frustumCuller.invalidate();
 }
 
 /**
@@ -496,6 +1921,7 @@ void Gl_ShaderWindow::postDraw3D() {
 * @date	3/15/2012
 */
 void Gl_ShaderWindow::draw2D() {
+	ProfileScope scope(profiler, draw2DSection);
 
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
@@ -509,7 +1935,9 @@ void Gl_ShaderWindow::draw2D() {
 
 	glColor3f(1.0f, 1.0f, 1.0f);
 
-	Dprint::screenPrint(screenWidth, screenHeight);
+	// gl_font() makes its display lists through FLTK's window, which a headless context doesn't have
+	if(headlessContext == NULL)
+		Dprint::screenPrint(screenWidth, screenHeight);
 	Dprint::reset();
 
 	glPopAttrib();
@@ -517,4 +1945,10 @@ void Gl_ShaderWindow::draw2D() {
 
 Gl_ShaderWindow::~Gl_ShaderWindow(void)
 {
+	stopSimulationThread();
+	setParallelUpdate(false);
+	delete headlessContext;
+	DeleteCriticalSection(&sceneLock);
+	DeleteCriticalSection(&sceneChangeLock);
+	DeleteCriticalSection(&pickViewLock);
 }
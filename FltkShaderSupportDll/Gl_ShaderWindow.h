@@ -8,14 +8,31 @@
 #include <GLFrame.h>
 #include <GLFrustum.h>
 #include <GLGeometryTransform.h>
+#include <StopWatch.h>
 
 #include <math.h>
+#include <vector>
+#include <map>
 
 
 #include <GL/glut.h>
 #include <GL/GLU.h>
 #include "Dprint.h"
 #include "ScreenRepaint.h"
+#include "FrameProfiler.h"
+#include "OffscreenTarget.h"
+#include "HeadlessContext.h"
+#include "InputRecorder.h"
+#include "JobSystem.h"
+#include "GLCapabilities.h"
+#include "AssetLoader.h"
+#include "RingBuffer.h"
+#include "FramePacer.h"
+#include "FrameClock.h"
+#include "IdBuffer.h"
+#include "RayCaster.h"
+#include "FrustumCuller.h"
+#include "DynamicBVH.h"
 
 #define M_PI       3.14159265358979323846
 
@@ -76,6 +93,7 @@ public:
 		eyePos[0] = x;
 		eyePos[1] = y;
 		eyePos[2] = z;
+		requestRedraw();
 	}
 
 	/**
@@ -94,6 +112,7 @@ public:
 		eyeOrient[0] = pitch;
 		eyeOrient[1] = roll;
 		eyeOrient[2] = yaw;
+		requestRedraw();
 	}
 
 	/**
@@ -129,6 +148,7 @@ public:
 		worldPos[0] = x;
 		worldPos[1] = y;
 		worldPos[2] = z;
+		requestRedraw();
 	}
 
 	/**
@@ -147,6 +167,7 @@ public:
 		worldOrient[0] = pitch;
 		worldOrient[1] = roll;
 		worldOrient[2] = yaw;
+		requestRedraw();
 	}
 
 	/**
@@ -236,232 +257,1434 @@ public:
 	/**
 	 * @fn	void Gl_ShaderWindow::setRefreshSeconds(float duration)
 	 *
-	 * @brief	Sets the minimum 'pause' between frames. Typical values range between 0.001 to 0.1 seconds. 
-	 * 			Complex frames may take longer to draw
+	 * @brief	Sets the time between frames. Typical values range between 0.001 to 0.1 seconds. 
+	 * 			Complex frames may take longer to draw, in which case the FramePacer counts a missed deadline
 	 *
 	 * @author	Phil
 	 * @date	3/15/2012
 	 *
 	 * @param	duration	The duration.
 	 */
-	void setRefreshSeconds(float duration) {refreshSeconds = duration;};
+	void setRefreshSeconds(float duration) {refreshSeconds = duration; pacer.setTargetInterval(duration);};
 
 	/**
-	 * @fn	void Gl_ShaderWindow::init(int width, int height);
+	 * @fn	void Gl_ShaderWindow::setSwapInterval(int interval)
 	 *
-	 * @brief	Initialises the openGl canvas
+	 * @brief	Sets the number of vertical blanks each buffer swap waits for (0 for off, 1 for vsync),
+	 * 			where the driver supports WGL_EXT_swap_control. Applied at the start of the next frame.
+	 * 			The driver's default is left alone unless this is called
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
-	 * @param	width 	The width.
-	 * @param	height	The height.
+	 * @param	interval	The swap interval.
 	 */
-	void init(int width, int height);
+	void setSwapInterval(int interval) {swapInterval = interval; swapIntervalPending = true;};
 
 	/**
-	 * @fn	virtual void Gl_ShaderWindow::localInit() = 0;
+	 * @fn	FramePacer& Gl_ShaderWindow::getFramePacer()
 	 *
-	 * @brief	any additional initialization required by a subclass should add their code here. It is called in the correct order within init()
+	 * @brief	Gets the frame pacer, for the last frame's cost and lateness and the missed deadline count
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The frame pacer.
 	 */
-	virtual void localInit() = 0;
+	FramePacer& getFramePacer() {return pacer;};
 
 	/**
-	 * @fn	virtual void Gl_ShaderWindow::resize()
+	 * @fn	FrameClock& Gl_ShaderWindow::getFrameClock()
 	 *
-	 * @brief	Resizes the canvas and reinitializes any OpenGl values that may need it
+	 * @brief	Gets the clock that drives environmentCalc(). It is stamped once per step, and its step
+	 * 			and time are what every DrawableObject sees
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The frame clock.
 	 */
-	virtual void resize(){};
+	FrameClock& getFrameClock() {return frameClock;};
 
 	/**
-	 * @fn	virtual void Gl_ShaderWindow::draw3Dsetup();
+	 * @fn	void Gl_ShaderWindow::setOnDemandRedraw(bool onDemand)
 	 *
-	 * @brief	Called before all drawing begins by init()
+	 * @brief	Turns on-demand redraw on or off. When on, the timer still runs input and
+	 * 			environmentCalc() every tick, but a frame is only drawn if the camera moved, an object
+	 * 			was changed or added, an asset arrived, or an object in the scene is animating. Off by
+	 * 			default, so that every tick draws a frame
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	onDemand	true to only draw when something has changed.
 	 */
-	virtual void draw3Dsetup();
+	void setOnDemandRedraw(bool onDemand) {onDemandRedraw = onDemand; requestRedraw();};
 
 	/**
-	 * @fn	void Gl_ShaderWindow::preDraw3D();
+	 * @fn	bool Gl_ShaderWindow::isOnDemandRedraw()
 	 *
-	 * @brief	Called every frame before drawing. Contains things like glClear()
+	 * @brief	Query if on-demand redraw is on.
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if frames are only drawn when something has changed.
 	 */
-	void preDraw3D(); 
+	bool isOnDemandRedraw() {return onDemandRedraw;};
 
 	/**
-	 * @fn	void Gl_ShaderWindow::postDraw3D();
+	 * @fn	void Gl_ShaderWindow::requestRedraw()
 	 *
-	 * @brief	Called every frame after all 3D drawing has completed. The default cleans up after 
-	 * 			picking and calls modelViewMatrixStack.popMatrix();
+	 * @brief	Asks for a frame to be drawn on the next tick in on-demand mode. Safe to call from any thread
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
 	 */
-	void postDraw3D(); 
+	void requestRedraw() {InterlockedExchange(&redrawRequested, 1);};
 
 	/**
-	 * @fn	void Gl_ShaderWindow::draw2D();
+	 * @fn	void Gl_ShaderWindow::setSimulationRate(float hz);
 	 *
-	 * @brief	Contains 2D overlay drawing. This uses fixed function pipline calls, and should be replaced at some time with 
-	 * 			a text overlay shader. I think that the way it could be done would be to create a single grid with all the 
-	 * 			characters and pass that to the vertex shader with the XY index and size of the letter. The vertex shader moves 
-	 * 			the texture so that the letter is centered and then passes off the texture and size to the fragment shader, 
-	 * 			which clips the output so only the particular letter is shown.
-	 * 			
-	 *			Heres a tutorial on how to make the text texture: http://nehe.gamedev.net/tutorial/2d_texture_font/18002/
+	 * @brief	Switches the window to a fixed-timestep simulation loop. environmentCalc() is then called
+	 * 			as many times as needed to advance the simulation at 'hz' steps per second, independent
+	 * 			of how fast frames are drawn. Every DrawableObject sees a deltaTime of exactly 1/hz.
+	 * 			Passing 0 restores the default behavior of one environmentCalc() per timer tick.
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	hz	The simulation rate in steps per second (e.g. 240 or 1000), or 0 to disable
 	 */
-	void draw2D();
+	void setSimulationRate(float hz);
 
 	/**
-	 * @fn	virtual void Gl_ShaderWindow::environmentCalc() = 0;
+	 * @fn	void Gl_ShaderWindow::setMaxSimulationSteps(int steps)
 	 *
-	 * @brief	Do any calculations for things that happen as a function of time in the running system and call the 
-	 * 			environmentCalc() methods in any DrawableObject
+	 * @brief	Sets the maximum number of fixed steps that will be run for a single timer tick. If the
+	 * 			simulation falls further behind than this, the backlog is dropped rather than letting
+	 * 			the simulation consume the whole frame.
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	steps	The maximum number of steps per tick.
 	 */
-	virtual void environmentCalc() = 0;
+	void setMaxSimulationSteps(int steps) {maxSimSteps = steps;};
 
 	/**
-	 * @fn	void Gl_ShaderWindow::cleanup();
+	 * @fn	float Gl_ShaderWindow::getInterpolationAlpha()
 	 *
-	 * @brief	Cleans up this object.
+	 * @brief	Gets how far (0.0 - 1.0) the current frame lies between the last two simulation steps.
+	 * 			Always 1.0 when not in fixed-timestep mode.
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The interpolation alpha.
 	 */
-	void cleanup();
+	float getInterpolationAlpha() {return interpolationAlpha;};
 
 	/**
-	 * @fn	virtual void Gl_ShaderWindow::localCleanup() = 0;
+	 * @enum	SCENE_LAYER
 	 *
-	 * @brief	Place to do cleanup in inhereting classes, such as calling delete() on DrawableObjects
+	 * @brief	Which pass a scene object is drawn in. LAYER_WORLD objects are drawn between preDraw3D()
+	 * 			and postDraw3D(); LAYER_SCREEN objects (e.g. ScreenRepaint) are screen-space passes drawn
+	 * 			after postDraw3D() and before draw2D()
+	 */
+	enum SCENE_LAYER{LAYER_WORLD, LAYER_SCREEN, NUM_LAYERS};
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::addObject(DrawableObject *obj, SCENE_LAYER layer = LAYER_WORLD);
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @brief	Adds an object to the scene. The window owns it from then on, and will call cleanup()
+	 * 			and delete it when it is removed or the window is cleaned up. The add takes effect at the
+	 * 			start of the next frame (or straight after localInit()), so it is safe to call from
+	 * 			inside environmentCalc(), even on the simulation thread. While the simulation thread is
+	 * 			running, objects that aren't snapshot safe (see DrawableObject::setSnapshotSafe()) are
+	 * 			refused
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	obj	the object.
+	 * @param	layer		The pass to draw it in.
+	 *
+	 * @return	false if the object was refused, in which case the caller still owns it.
 	 */
-	virtual void localCleanup() = 0;
+	bool addObject(DrawableObject *obj, SCENE_LAYER layer = LAYER_WORLD);
 
 	/**
-	 * @fn	int Gl_ShaderWindow::handle(int event);
+	 * @fn	void Gl_ShaderWindow::removeObject(DrawableObject *obj);
 	 *
-	 * @brief	The widget class handle(int event) override
-	 *			The virtual method Fl_Widget::handle(int event) is called to handle each event passed to the widget. It can:
-	 *				Change the state of the widget.
-	 *				Call Fl_Widget::redraw() if the widget needs to be redisplayed.
-	 *				Call Fl_Widget::damage(uchar c) if the widget needs a partial-update (assuming you provide support for this in your draw() method).
-	 *				Call Fl_Widget::do_callback() if a callback should be generated.
-	 *				Call Fl_Widget::handle() on child widgets.
-	 *			Events are identified by the integer argument. Other information about the most recent event is stored in static locations
-	 *			and acquired by calling the Fl::event_*() methods. This information remains valid until another event is handled.
-	 *			
-	 *			When implemented in a widget, this function must return 0 if the widget does not use the event or 1 otherwise.
+	 * @brief	Removes an object from the scene at the start of the next frame. It is cleaned up and
+	 * 			deleted in the next preDraw3D(), where the GL context is current
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
-	 * @param	event	the kind of event received
+	 * @param [in,out]	obj	the object.
+	 */
+	void removeObject(DrawableObject *obj);
+
+	/**
+	 * @fn	int Gl_ShaderWindow::getNumObjects(SCENE_LAYER layer)
 	 *
+	 * @brief	Gets the number of objects in a layer of the scene
 	 *
-	 * @return	0	if the event was not used or understood
-	 *			1	if the event was used and can be deleted
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
+	 * @param	layer	The layer.
+	 *
+	 * @return	The number of objects.
 	 */
-	int handle(int event);
+	int getNumObjects(SCENE_LAYER layer) {return (int)sceneObjects[layer].size();};
 
-	static inline double frand(double fMin, double fMax)
-	{
-		double f = (double)rand() / RAND_MAX;
-		return fMin + f * (fMax - fMin);
-	}
+	/**
+	 * @fn	DrawableObject* Gl_ShaderWindow::getObject(SCENE_LAYER layer, int index)
+	 *
+	 * @brief	Gets an object in a layer of the scene
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	layer	The layer.
+	 * @param	index	Zero-based index of the object.
+	 *
+	 * @return	The object.
+	 */
+	DrawableObject* getObject(SCENE_LAYER layer, int index) {return sceneObjects[layer][index];};
 
 	/**
-	 * @enum	TRANSFORM_MODE
+	 * @fn	void Gl_ShaderWindow::calcScene();
 	 *
-	 * @brief	Values that represent TRANSFORM_MODE.
+	 * @brief	Calls environmentCalc() on every object in the scene. Typically called from the subclass's
+	 * 			environmentCalc(). In parallel-update mode the objects are spread across the job system's
+	 * 			workers, and any that haven't opted in with setParallelCalc(true) are then updated in
+	 * 			order on the calling thread
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
 	 */
+	void calcScene();
 
-	static enum TRANSFORM_MODE{EYE_MOVE, EYE_ROTATE, WORLD_MOVE, WORLD_ROTATE, PICK, MODEL_MOVE, MODEL_ROTATE};
+	/**
+	 * @fn	bool Gl_ShaderWindow::setParallelUpdate(bool enable, int numThreads = 0);
+	 *
+	 * @brief	Turns parallel-update mode on or off. Turning it on starts a work-stealing JobSystem that
+	 * 			calcScene() uses; turning it off stops the workers.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	enable	  	true to enable.
+	 * @param	numThreads	The number of worker threads. Zero uses one per core, less one
+	 *
+	 * @return	true if parallel update is on.
+	 */
+	bool setParallelUpdate(bool enable, int numThreads = 0);
 
-protected:
+	/**
+	 * @fn	bool Gl_ShaderWindow::isParallelUpdate()
+	 *
+	 * @brief	Query if calcScene() is running in parallel.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if parallel.
+	 */
+	bool isParallelUpdate() {return jobSystem != NULL;};
 
 	/**
-	 * @fn	void Gl_ShaderWindow::setFloats(GLfloat *ptr, int amount, ...);
+	 * @fn	void Gl_ShaderWindow::renderScene(SCENE_LAYER layer);
 	 *
-	 * @brief	Sets the floats in an array
+	 * @brief	Renders every object in one layer of the scene, in the order they were added. World
+	 * 			objects whose bounding sphere is outside the view frustum are skipped (see
+	 * 			setFrustumCulling())
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
-	 * @param [in,out]	ptr	If non-null, the pointer.
-	 * @param	amount	the number of indicies.
-	 * @param	...		The values to be set in the array
+	 * @param	layer	The layer.
 	 */
-	void setFloats(GLfloat *ptr, int amount, ...);
+	void renderScene(SCENE_LAYER layer);
 
 	/**
-	 * @fn	static void Gl_ShaderWindow::timerCallback(void* data);
+	 * @fn	void Gl_ShaderWindow::setFrustumCulling(bool enable)
 	 *
-	 * @brief	Drawing callback, triggered by the timer
+	 * @brief	Sets whether renderScene() skips world objects that are out of view. The planes are
+	 * 			taken from the view in preDraw3D(), and each object is tested with its bounding sphere
+	 * 			around its render position. Objects that haven't set a boundingSphereRadius are always
+	 * 			drawn. Defaults to true.
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
-	 * @param [in,out]	pointer to any data to be used/modified within the callback
+	 * @param	enable	true to cull.
 	 */
-	static void timerCallback(void* data);
+	void setFrustumCulling(bool enable) {frustumCulling = enable;};
+	bool isFrustumCulling() {return frustumCulling;};
 
 	/**
-	 * @fn	static void Gl_ShaderWindow::Menu_CB(Fl_Widget*, void *data);
+	 * @fn	int Gl_ShaderWindow::getVisibleCount()
 	 *
-	 * @brief	Callback from menu selection
+	 * @brief	Gets the number of world objects renderScene() drew in the last frame
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
-	 * @param [in,out]	parameter1	pointer to the widget that is the source of this call
-	 * @param [in,out]	data	  	pointer to any data to be used/modified within the callback
+	 * @return	The visible count.
 	 */
-	static void Menu_CB(Fl_Widget* wp, void *data);
+	int getVisibleCount() {return visibleCount;};
 
 	/**
-	 * @fn	void Gl_ShaderWindow::setPickMatrix(GLdouble x, GLdouble y, GLdouble deltax,
-	 * 		GLdouble deltay, GLint viewport[4]);
+	 * @fn	int Gl_ShaderWindow::getCulledCount()
 	 *
-	 * @brief	A slightly modified version of the original gluPickMatrix, taken from:
-	 *				http://oss.sgi.com/cgi-bin/cvsweb.cgi/projects/ogl-sample/main/gfx/lib/glu/libutil/project.c?rev=1.4;content-type=text%2Fplain
+	 * @brief	Gets the number of world objects renderScene() skipped in the last frame
 	 *
+	 * @author	agent
+	 * @date	10/17/2026
 	 *
-	 * @author	Phil
-	 * @date	3/15/2012
+	 * @return	The culled count.
+	 */
+	int getCulledCount() {return culledCount;};
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::startSimulationThread();
 	 *
-	 * @param	x			cursor x
-	 * @param	y			cursor y
-	 * @param	deltax  	x size of the selection area
-	 * @param	deltay  	y size of the selection area
-	 * @param	viewport	The viewport.
+	 * @brief	Moves environmentCalc() off the FLTK thread and onto a thread of its own. After every update
+	 * 			the thread calls publishState() on each object in the scene, and render()
+	 * 			draws from those snapshots without locking. environmentCalc() must not make any GL calls 
+	 * 			while this is running. Uses the fixed simulation rate if one has been set, otherwise 
+	 * 			refreshSeconds. Every object in the scene must be snapshot safe (see
+	 * 			DrawableObject::setSnapshotSafe()), and ones that aren't are kept out of the scene while
+	 * 			the thread runs.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if the thread is running, false if it couldn't start or an object isn't snapshot safe.
 	 */
-	void setPickMatrix(GLdouble x, GLdouble y, GLdouble deltax, GLdouble deltay, GLint viewport[4]);
+	bool startSimulationThread();
 
 	/**
-	 * @summary	The refresh rate in seconds. Typically 0.001 to 0.1
+	 * @fn	void Gl_ShaderWindow::stopSimulationThread();
+	 *
+	 * @brief	Stops the simulation thread and waits for it to finish. environmentCalc() goes back to being
+	 * 			called from the timer.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
 	 */
-	float refreshSeconds;
+	void stopSimulationThread();
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::isSimulationThreaded()
+	 *
+	 * @brief	Query if the simulation is running on its own thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if it is.
+	 */
+	bool isSimulationThreaded() {return simThread != NULL;};
+
+	/**
+	 * @fn	FrameProfiler& Gl_ShaderWindow::getProfiler()
+	 *
+	 * @brief	Gets the frame profiler. preDraw3D(), postDraw3D(), draw2D(), environmentCalc() and every
+	 * 			object drawn with renderObject() or updated with calcObject() are timed once it is enabled
+	 * 			with getProfiler().setEnabled(true)
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The profiler.
+	 */
+	FrameProfiler& getProfiler() {return profiler;};
+
+	/**
+	 * @fn	void Gl_ShaderWindow::setGpuTiming(bool enable)
+	 *
+	 * @brief	Turns GPU timing of renderObject() on or off. It only runs while the profiler is
+	 * 			enabled and the context supports timer queries. On by default
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	enable	true to enable.
+	 */
+	void setGpuTiming(bool enable) {gpuTiming = enable;};
+
+	/**
+	 * @fn	AssetLoader& Gl_ShaderWindow::getAssetLoader()
+	 *
+	 * @brief	Gets the asset loader. Textures and meshes requested through it in localInit() are read in
+	 * 			the background and uploaded a few at a time in preDraw3D(), so the window comes up right away
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The asset loader.
+	 */
+	AssetLoader& getAssetLoader() {return assetLoader;};
+
+	/**
+	 * @fn	void Gl_ShaderWindow::setAssetBudget(float ms)
+	 *
+	 * @brief	Sets how long preDraw3D() may spend uploading loaded assets each frame. The default is 2 ms
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	ms	The budget in milliseconds.
+	 */
+	void setAssetBudget(float ms) {assetBudgetMs = ms;};
+
+	/**
+	 * @enum	PICK_MODE
+	 *
+	 * @brief	How PICK mode finds what is under the mouse. PICK_OCCLUSION sets isPicking so that the
+	 * 			subclass can pickRender() the objects it wants tested. PICK_ID_BUFFER looks the pixels up in
+	 * 			the IdBuffer instead: a click picks the nearest object under the cursor and a drag picks
+	 * 			every object in the box. PICK_RAY casts a ray through the cursor on the CPU with rayPick(),
+	 * 			so the result is there as soon as the mouse goes down
+	 */
+	enum PICK_MODE{PICK_OCCLUSION, PICK_ID_BUFFER, PICK_RAY};
+
+	/**
+	 * @fn	void Gl_ShaderWindow::setPickMode(PICK_MODE mode)
+	 *
+	 * @brief	Sets the pick mode. The default is PICK_OCCLUSION
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	mode	The mode.
+	 */
+	void setPickMode(PICK_MODE mode) {pickMode = mode;};
+	PICK_MODE getPickMode() {return pickMode;};
+
+	/**
+	 * @fn	void Gl_ShaderWindow::requestIdPick(int x, int y, int w, int h);
+	 *
+	 * @brief	Asks for the world objects in a rectangle of the window to be picked through the
+	 * 			IdBuffer. The IDs are drawn on the next frame and read back a frame or two after that,
+	 * 			when each object picked is passed to its pick callback and getPickSelection() is updated.
+	 * 			Must be called from the FLTK thread
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x	The left edge, in window coordinates.
+	 * @param	y	The top edge, in window coordinates (y runs down the window).
+	 * @param	w	The width.
+	 * @param	h	The height.
+	 */
+	void requestIdPick(int x, int y, int w, int h);
+
+	/**
+	 * @fn	const vector<DrawableObject*>& Gl_ShaderWindow::getPickSelection()
+	 *
+	 * @brief	Gets the objects found by the last PICK_ID_BUFFER or PICK_RAY pick, nearest first. Empty
+	 * 			if it hit nothing. Objects are dropped from it as they are deleted after removeObject().
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The picked objects.
+	 */
+	const vector<DrawableObject*>& getPickSelection() {return pickSelection;};
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::getPickRay(int x, int y, M3DVector3f origin, M3DVector3f dir);
+	 *
+	 * @brief	Makes the world space ray under a window position, using the view that the last frame
+	 * 			was drawn with. Safe to call from any thread
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x			  	The x coordinate, in window coordinates.
+	 * @param	y			  	The y coordinate, in window coordinates (y runs down the window).
+	 * @param	origin		  	[out] The start of the ray.
+	 * @param	dir			  	[out] The unit direction of the ray.
+	 *
+	 * @return	false if no frame has been drawn yet.
+	 */
+	bool getPickRay(int x, int y, M3DVector3f origin, M3DVector3f dir);
+
+	/**
+	 * @fn	int Gl_ShaderWindow::rayPick(int x, int y, vector<RayCaster::Hit> &hits);
+	 *
+	 * @brief	Picks the world objects under a window position on the CPU, by casting a ray against
+	 * 			their bounding volumes (see DrawableObject::rayIntersect()). Nothing goes to the GPU, so
+	 * 			the answer is immediate, and it can be called from the simulation thread, where it sees the
+	 * 			objects as the simulation has them
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x			  	The x coordinate, in window coordinates.
+	 * @param	y			  	The y coordinate, in window coordinates (y runs down the window).
+	 * @param [out]	hits	The objects hit, nearest first.
+	 *
+	 * @return	The number of objects hit.
+	 */
+	int rayPick(int x, int y, vector<RayCaster::Hit> &hits);
+
+	/**
+	 * @fn	int Gl_ShaderWindow::queryBox(const float boxMin[3], const float boxMax[3],
+	 * 		vector<DrawableObject*> &results);
+	 *
+	 * @brief	Finds the world objects whose bounds overlap a world space box, from the spatial index
+	 * 			(see DrawableObject::getWorldBounds()). Like rayPick(), it sees the objects as the
+	 * 			simulation has them, and can be called from the simulation thread
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	boxMin		   	The minimum corner.
+	 * @param	boxMax		   	The maximum corner.
+	 * @param [out]	results	The objects.
+	 *
+	 * @return	The number of objects found.
+	 */
+	int queryBox(const float boxMin[3], const float boxMax[3], vector<DrawableObject*> &results);
+
+	/**
+	 * @fn	int Gl_ShaderWindow::querySphere(const float center[3], float radius,
+	 * 		vector<DrawableObject*> &results);
+	 *
+	 * @brief	Finds the world objects whose bounds come within 'radius' of a world space point
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	center		   	The center.
+	 * @param	radius		   	The radius.
+	 * @param [out]	results	The objects.
+	 *
+	 * @return	The number of objects found.
+	 */
+	int querySphere(const float center[3], float radius, vector<DrawableObject*> &results);
+
+	/**
+	 * @fn	int Gl_ShaderWindow::queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results);
+	 *
+	 * @brief	Finds the world objects whose bounds might be inside a frustum, e.g. a shadow caster's or
+	 * 			a second camera's. The window's own culling of what it draws doesn't use this; it tests
+	 * 			the interpolated render state each frame instead
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	frustum	The frustum, with world space planes.
+	 * @param [out]	results	   	The objects.
+	 *
+	 * @return	The number of objects found.
+	 */
+	int queryFrustum(FrustumCuller &frustum, vector<DrawableObject*> &results);
+
+	/**
+	 * @fn	void Gl_ShaderWindow::renderObject(DrawableObject *obj);
+	 *
+	 * @brief	Calls obj->render() with this window's matrix stacks and shader manager, timing it
+	 * 			in the profiler under the object's name. The GPU time is reported a few frames late
+	 * 			in the "<name>.gpu" section. Don't nest calls, since timer queries can't overlap
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	obj	the object to draw.
+	 */
+	void renderObject(DrawableObject *obj);
+
+	/**
+	 * @fn	void Gl_ShaderWindow::calcObject(DrawableObject *obj);
+	 *
+	 * @brief	Calls obj->environmentCalc(), timing it in the profiler under the object's name
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	obj	the object to update.
+	 */
+	void calcObject(DrawableObject *obj);
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::runHeadless(int frames, int width, int height,
+	 * 		const char *profileFile = NULL, const char *imageFile = NULL);
+	 *
+	 * @brief	Renders a fixed number of frames into an offscreen framebuffer instead of the window and
+	 * 			returns, for benchmarks and regression runs. If the window hasn't been drawn yet, the
+	 * 			frames are drawn with a HeadlessContext, which needs no window or display, and the
+	 * 			Dprint overlay is left out since FLTK's GL text only works in FLTK's contexts. If that
+	 * 			context can't be made, or the scene already lives in the window's context, the window is
+	 * 			created iconized and its context is used instead; nothing is drawn to it. Call cleanup()
+	 * 			afterwards rather than showing the window, since the scene may belong to the headless
+	 * 			context. Each frame advances the simulation by exactly refreshSeconds, so runs are
+	 * 			repeatable, and is timed in the profiler's "headlessFrame" section with a glFinish() so
+	 * 			that GPU work is included.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	frames	   	The number of frames to draw.
+	 * @param	width	   	The width of the offscreen framebuffer.
+	 * @param	height	   	The height of the offscreen framebuffer.
+	 * @param	profileFile	If not NULL, the profiler statistics are written here (.json for JSON, otherwise CSV)
+	 * @param	imageFile  	If not NULL, the last frame is written here as a TGA file
+	 *
+	 * @return	false if the GL context or the offscreen framebuffer could not be created.
+	 */
+	bool runHeadless(int frames, int width, int height, const char *profileFile = NULL, const char *imageFile = NULL);
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::isHeadless()
+	 *
+	 * @brief	Query if frames are being drawn into the offscreen framebuffer
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if headless.
+	 */
+	bool isHeadless() {return offscreen != NULL;};
+
+	/**
+	 * @fn	void Gl_ShaderWindow::startRecording(const char *fileName);
+	 *
+	 * @brief	Starts recording every mouse event that handle() processes, along with the frame and
+	 * 			time it arrived and the view that the recording started from
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName	Filename of the binary log. It is written by stopRecording(), or by cleanup()
+	 * 						if the recording is still running
+	 */
+	void startRecording(const char *fileName);
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::stopRecording();
+	 *
+	 * @brief	Stops recording and writes the binary log
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if it succeeds, false if it fails or nothing was being recorded.
+	 */
+	bool stopRecording();
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::startReplay(const char *fileName, const char *profileFile = NULL);
+	 *
+	 * @brief	Loads a log written by stopRecording() and feeds the events back in on the frames they
+	 * 			were recorded in, starting from the recorded view. Live mouse input is ignored until
+	 * 			it finishes. The replay runs in real time off the timer; to run it as fast as possible
+	 * 			call runHeadless(getReplayFrames(), ...) straight afterwards. Frame time statistics
+	 * 			are printed when it finishes.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName   	Filename of the log.
+	 * @param	profileFile	If not NULL, the profiler statistics are written here when the replay finishes
+	 *
+	 * @return	false if the log can't be read.
+	 */
+	bool startReplay(const char *fileName, const char *profileFile = NULL);
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::isReplaying()
+	 *
+	 * @brief	Query if a log is being replayed.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if replaying.
+	 */
+	bool isReplaying() {return inputRecorder.isReplaying();};
+
+	/**
+	 * @fn	unsigned int Gl_ShaderWindow::getReplayFrames()
+	 *
+	 * @brief	Gets the number of frames that the loaded log covers
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of frames.
+	 */
+	unsigned int getReplayFrames() {return inputRecorder.getNumFrames();};
+
+	/**
+	 * @fn	void Gl_ShaderWindow::init(int width, int height);
+	 *
+	 * @brief	Initialises the openGl canvas
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 *
+	 * @param	width 	The width.
+	 * @param	height	The height.
+	 */
+	void init(int width, int height);
+
+	/**
+	 * @fn	virtual void Gl_ShaderWindow::localInit() = 0;
+	 *
+	 * @brief	any additional initialization required by a subclass should add their code here. It is called in the correct order within init()
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	virtual void localInit() = 0;
+
+	/**
+	 * @fn	virtual void Gl_ShaderWindow::resize()
+	 *
+	 * @brief	Resizes the canvas and reinitializes any OpenGl values that may need it
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	virtual void resize(){};
+
+	/**
+	 * @fn	void Gl_ShaderWindow::flush();
+	 *
+	 * @brief	Fl_Gl_Window::flush() override: draws and swaps, then ends the paced frame
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void flush();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::endPacedFrame();
+	 *
+	 * @brief	Ends the frame started by the timer tick and records its cost in the "frameCost" section
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void endPacedFrame();
+
+	/**
+	 * @fn	virtual void Gl_ShaderWindow::draw3Dsetup();
+	 *
+	 * @brief	Called before all drawing begins by init()
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	virtual void draw3Dsetup();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::preDraw3D();
+	 *
+	 * @brief	Called every frame before drawing. Contains things like glClear()
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	void preDraw3D(); 
+
+	/**
+	 * @fn	void Gl_ShaderWindow::postDraw3D();
+	 *
+	 * @brief	Called every frame after all 3D drawing has completed. The default cleans up after 
+	 * 			picking and calls modelViewMatrixStack.popMatrix();
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	void postDraw3D(); 
+
+	/**
+	 * @fn	void Gl_ShaderWindow::draw2D();
+	 *
+	 * @brief	Contains 2D overlay drawing. This uses fixed function pipline calls, and should be replaced at some time with 
+	 * 			a text overlay shader. I think that the way it could be done would be to create a single grid with all the 
+	 * 			characters and pass that to the vertex shader with the XY index and size of the letter. The vertex shader moves 
+	 * 			the texture so that the letter is centered and then passes off the texture and size to the fragment shader, 
+	 * 			which clips the output so only the particular letter is shown.
+	 * 			
+	 *			Heres a tutorial on how to make the text texture: http://nehe.gamedev.net/tutorial/2d_texture_font/18002/
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	void draw2D();
+
+	/**
+	 * @fn	virtual void Gl_ShaderWindow::environmentCalc() = 0;
+	 *
+	 * @brief	Do any calculations for things that happen as a function of time in the running system and call the 
+	 * 			environmentCalc() methods in any DrawableObject
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	virtual void environmentCalc() = 0;
+
+	/**
+	 * @fn	void Gl_ShaderWindow::cleanup();
+	 *
+	 * @brief	Cleans up this object. Calls localCleanup() and then cleans up and deletes every object
+	 * 			in the scene
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	void cleanup();
+
+	/**
+	 * @fn	virtual void Gl_ShaderWindow::localCleanup() = 0;
+	 *
+	 * @brief	Place to do cleanup in inhereting classes, such as calling delete() on DrawableObjects
+	 * 			that aren't in the scene
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 */
+	virtual void localCleanup() = 0;
+
+	/**
+	 * @fn	int Gl_ShaderWindow::handle(int event);
+	 *
+	 * @brief	The widget class handle(int event) override
+	 *			The virtual method Fl_Widget::handle(int event) is called to handle each event passed to the widget. It can:
+	 *				Change the state of the widget.
+	 *				Call Fl_Widget::redraw() if the widget needs to be redisplayed.
+	 *				Call Fl_Widget::damage(uchar c) if the widget needs a partial-update (assuming you provide support for this in your draw() method).
+	 *				Call Fl_Widget::do_callback() if a callback should be generated.
+	 *				Call Fl_Widget::handle() on child widgets.
+	 *			Events are identified by the integer argument. Other information about the most recent event is stored in static locations
+	 *			and acquired by calling the Fl::event_*() methods. This information remains valid until another event is handled.
+	 *			
+	 *			When implemented in a widget, this function must return 0 if the widget does not use the event or 1 otherwise.
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 *
+	 * @param	event	the kind of event received
+	 *
+	 *
+	 * @return	0	if the event was not used or understood
+	 *			1	if the event was used and can be deleted
+	 *
+	 */
+	int handle(int event);
+
+	static inline double frand(double fMin, double fMax)
+	{
+		double f = (double)rand() / RAND_MAX;
+		return fMin + f * (fMax - fMin);
+	}
+
+	/**
+	 * @enum	TRANSFORM_MODE
+	 *
+	 * @brief	Values that represent TRANSFORM_MODE.
+	 */
+
+	static enum TRANSFORM_MODE{EYE_MOVE, EYE_ROTATE, WORLD_MOVE, WORLD_ROTATE, PICK, MODEL_MOVE, MODEL_ROTATE};
+
+protected:
+
+	/**
+	 * @fn	void Gl_ShaderWindow::setFloats(GLfloat *ptr, int amount, ...);
+	 *
+	 * @brief	Sets the floats in an array
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 *
+	 * @param [in,out]	ptr	If non-null, the pointer.
+	 * @param	amount	the number of indicies.
+	 * @param	...		The values to be set in the array
+	 */
+	void setFloats(GLfloat *ptr, int amount, ...);
+
+	/**
+	 * @fn	static void Gl_ShaderWindow::timerCallback(void* data);
+	 *
+	 * @brief	Drawing callback, triggered by the timer
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 *
+	 * @param [in,out]	pointer to any data to be used/modified within the callback
+	 */
+	static void timerCallback(void* data);
+
+	/**
+	 * @fn	static void Gl_ShaderWindow::Menu_CB(Fl_Widget*, void *data);
+	 *
+	 * @brief	Callback from menu selection
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 *
+	 * @param [in,out]	parameter1	pointer to the widget that is the source of this call
+	 * @param [in,out]	data	  	pointer to any data to be used/modified within the callback
+	 */
+	static void Menu_CB(Fl_Widget* wp, void *data);
+
+	/**
+	 * @fn	void Gl_ShaderWindow::setPickMatrix(GLdouble x, GLdouble y, GLdouble deltax,
+	 * 		GLdouble deltay, GLint viewport[4]);
+	 *
+	 * @brief	A slightly modified version of the original gluPickMatrix, taken from:
+	 *				http://oss.sgi.com/cgi-bin/cvsweb.cgi/projects/ogl-sample/main/gfx/lib/glu/libutil/project.c?rev=1.4;content-type=text%2Fplain
+	 *
+	 *
+	 * @author	Phil
+	 * @date	3/15/2012
+	 *
+	 * @param	x			cursor x
+	 * @param	y			cursor y
+	 * @param	deltax  	x size of the selection area
+	 * @param	deltay  	y size of the selection area
+	 * @param	viewport	The viewport.
+	 */
+	void setPickMatrix(GLdouble x, GLdouble y, GLdouble deltax, GLdouble deltay, GLint viewport[4]);
+
+	/**
+	 * @summary	The refresh rate in seconds. Typically 0.001 to 0.1
+	 */
+	float refreshSeconds;
+
+	/**
+	 * @fn	void Gl_ShaderWindow::stepSimulation();
+	 *
+	 * @brief	Runs the fixed-timestep accumulator: adds the wall time since the last call and calls
+	 * 			environmentCalc() once for every whole simulation step that has accumulated
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void stepSimulation();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::advanceSimulation(float seconds);
+	 *
+	 * @brief	Adds 'seconds' to the accumulator and runs the whole simulation steps it now holds
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	seconds	The time to advance by.
+	 */
+	void advanceSimulation(float seconds);
+
+	/**
+	 * @summary	The duration of a fixed simulation step in seconds. Zero if fixed-timestep mode is off
+	 */
+	float simulationStep;
+
+	/**
+	 * @summary	Wall time that has accumulated but not yet been simulated
+	 */
+	float simAccumulator;
+
+	/**
+	 * @summary	The maximum number of simulation steps per timer tick
+	 */
+	int maxSimSteps;
+
+	/**
+	 * @summary	The fraction of a simulation step that the current frame represents
+	 */
+	float interpolationAlpha;
+
+	/**
+	 * @summary	Measures wall time between simulation updates
+	 */
+	CStopWatch simStopWatch;
+
+	/**
+	 * @fn	static DWORD WINAPI Gl_ShaderWindow::simThreadProc(LPVOID data);
+	 *
+	 * @brief	The simulation thread's loop
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	data	pointer to this window
+	 *
+	 * @return	0 when the thread exits
+	 */
+	static DWORD WINAPI simThreadProc(LPVOID data);
+
+	/**
+	 * @fn	void Gl_ShaderWindow::publishSimObjects();
+	 *
+	 * @brief	Calls publishState() on every object in the scene
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void publishSimObjects();
+
+	/**
+	 * @summary	The simulation thread. NULL if environmentCalc() is being called from the timer
+	 */
+	HANDLE simThread;
+
+	/**
+	 * @summary	Set to non-zero to ask the simulation thread to exit
+	 */
+	volatile LONG simThreadQuit;
+
+	/**
+	 * @fn	void Gl_ShaderWindow::applySceneChanges();
+	 *
+	 * @brief	Carries out the adds and removes queued since the last frame. Only called from the FLTK
+	 * 			thread, outside of any traversal. It runs from the timer, where no GL context is current,
+	 * 			so removed objects are only retired here; deleteRetiredObjects() cleans them up
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void applySceneChanges();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::deleteRetiredObjects();
+	 *
+	 * @brief	Drops the objects that have left the scene from the pick selection, then calls cleanup()
+	 * 			on, and deletes, them. Called from preDraw3D() and cleanupScene(), with the GL context
+	 * 			current, since cleanup() deletes GL objects
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void deleteRetiredObjects();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::cleanupScene();
+	 *
+	 * @brief	Cleans up and deletes every object in the scene, including any still waiting to be added
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void cleanupScene();
+
+	/**
+	 * @struct	SceneChange
+	 *
+	 * @brief	An add or remove waiting for the start of the next frame
+	 */
+	struct SceneChange
+	{
+		DrawableObject	*obj;
+		SCENE_LAYER		layer;
+		bool			add;
+	};
+
+	/**
+	 * @summary	The scene, one flat array per layer. Only the FLTK thread changes these
+	 */
+	vector<DrawableObject*> sceneObjects[NUM_LAYERS];
+
+	/**
+	 * @summary	Adds and removes waiting for applySceneChanges()
+	 */
+	vector<SceneChange> sceneChanges;
+
+	/**
+	 * @summary	Objects out of the scene, waiting for deleteRetiredObjects()
+	 */
+	vector<DrawableObject*> retiredObjects;
+
+	/**
+	 * @summary	Guards sceneChanges
+	 */
+	CRITICAL_SECTION sceneChangeLock;
+
+	/**
+	 * @summary	Held by the simulation thread while it traverses the scene, and by applySceneChanges()
+	 * 			while it changes it
+	 */
+	CRITICAL_SECTION sceneLock;
+
+	/**
+	 * @struct	CalcSceneJob
+	 *
+	 * @brief	What calcSceneRange() needs to update a slice of one layer
+	 */
+	struct CalcSceneJob
+	{
+		Gl_ShaderWindow			*window;
+		vector<DrawableObject*>	*objects;
+	};
+
+	/**
+	 * @fn	static void Gl_ShaderWindow::calcSceneRange(void *data, int begin, int end);
+	 *
+	 * @brief	JobSystem callback that updates objects [begin, end) of a layer, skipping any that haven't
+	 * 			opted in to parallel update
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	data	The CalcSceneJob.
+	 * @param	begin			The first object.
+	 * @param	end				One past the last object.
+	 */
+	static void calcSceneRange(void *data, int begin, int end);
+
+	/**
+	 * @summary	The worker pool for parallel update. NULL when calcScene() runs serially
+	 */
+	JobSystem *jobSystem;
+
+	/**
+	 * @fn	void Gl_ShaderWindow::timedEnvironmentCalc();
+	 *
+	 * @brief	Calls environmentCalc(), timing it in the profiler
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void timedEnvironmentCalc();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::updateSpatialIndex();
+	 *
+	 * @brief	Brings the world objects' leaves in sceneBVH up to date after a simulation step, and
+	 * 			rebuilds it once the refits have let it go loose
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void updateSpatialIndex();
+
+	/**
+	 * @summary	The frame profiler
+	 */
+	FrameProfiler profiler;
+
+	/**
+	 * @summary	Profiler sections for the phases of the frame
+	 */
+	int preDraw3DSection;
+	int postDraw3DSection;
+	int draw2DSection;
+	int environmentCalcSection;
+
+	/**
+	 * @summary	true to time renderObject() on the GPU as well
+	 */
+	bool gpuTiming;
+
+	/**
+	 * @summary	The framebuffer that frames are drawn into in headless mode. NULL when drawing to the window
+	 */
+	OffscreenTarget *offscreen;
+
+	/**
+	 * @summary	The window-less context runHeadless() draws with. NULL if it is using the window's
+	 */
+	HeadlessContext *headlessContext;
+
+	/**
+	 * @summary	Profiler section for whole frames in headless mode
+	 */
+	int headlessFrameSection;
+
+	/**
+	 * @summary	Loads textures and meshes in the background
+	 */
+	AssetLoader assetLoader;
+
+	/**
+	 * @summary	The time preDraw3D() may spend on asset uploads, in milliseconds
+	 */
+	float assetBudgetMs;
+	int assetUploadSection;
+
+	/**
+	 * @summary	The frustum planes of the current frame, whether to use them, and what they did in the
+	 * 			last frame
+	 */
+	FrustumCuller frustumCuller;
+	bool frustumCulling;
+	int visibleCount;
+	int culledCount;
+
+	/**
+	 * @summary	The world objects by their simulation state bounds, for rayPick() and the queries, and
+	 * 			the profiler section for keeping it up to date
+	 */
+	DynamicBVH sceneBVH;
+	int spatialIndexSection;
+
+	/**
+	 * @summary	The world objects' bounding spheres as structure-of-arrays for
+	 * 			FrustumCuller::cullSpheres(), and its answer. Kept between frames so they aren't reallocated
+	 */
+	vector<float> cullX;
+	vector<float> cullY;
+	vector<float> cullZ;
+	vector<float> cullRadius;
+	vector<unsigned int> cullMask;
+
+	/**
+	 * @summary	How PICK mode picks
+	 */
+	PICK_MODE pickMode;
+
+	/**
+	 * @summary	Holds the pick ID of the nearest world object at each pixel of the pick rectangle
+	 */
+	IdBuffer idBuffer;
+
+	/**
+	 * @summary	true if an IdBuffer pick should be drawn on the next frame, and the rectangle to draw it
+	 * 			in (x, y, w, h in window coordinates)
+	 */
+	bool idPickPending;
+	int idPickRect[4];
+
+	/**
+	 * @summary	Where the mouse went down in PICK_ID_BUFFER mode
+	 */
+	int pickStartX;
+	int pickStartY;
+
+	/**
+	 * @summary	The objects found by the last IdBuffer pick
+	 */
+	vector<DrawableObject*> pickSelection;
+
+	/**
+	 * @summary	Finds an object from the pick ID it was given when it joined the scene
+	 */
+	map<GLuint, DrawableObject*> pickIds;
+	GLuint nextPickId;
+
+	int idPassSection;
+
+	/**
+	 * @summary	The view the last frame was drawn with, for getPickRay(). Guarded by pickViewLock, since
+	 * 			the simulation thread may read it
+	 */
+	M3DMatrix44f pickModelView;
+	M3DMatrix44f pickProjection;
+	GLint pickViewport[4];
+	bool hasPickView;
+	CRITICAL_SECTION pickViewLock;
+
+	/**
+	 * @fn	void Gl_ShaderWindow::processInput(const InputEvent &e);
+	 *
+	 * @brief	Applies a mouse event to the eyepoint, world and model transforms. Live and replayed
+	 * 			events both come through here
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	e	The event.
+	 */
+	void processInput(const InputEvent &e);
+
+	/**
+	 * @fn	void Gl_ShaderWindow::replayInput();
+	 *
+	 * @brief	Feeds in the recorded events for the current frame when a log is replaying
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void replayInput();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::pollPickResults();
+	 *
+	 * @brief	Collects any finished picks from the objects in the scene, which hands them to each
+	 * 			object's pick callback. Called by preDraw3D() every frame
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void pollPickResults();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::renderIdPass();
+	 *
+	 * @brief	Draws the world objects into the IdBuffer for the requested pick rectangle, then binds
+	 * 			the normal draw target again. Called by preDraw3D() once the view is set up
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void renderIdPass();
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::isCulled(DrawableObject *obj);
+	 *
+	 * @brief	Query if a world object is out of view this frame.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	obj	The object.
+	 *
+	 * @return	true if culling is on and the object's bounding sphere is outside the frustum.
+	 */
+	bool isCulled(DrawableObject *obj);
+
+	/**
+	 * @fn	void Gl_ShaderWindow::pollIdPick();
+	 *
+	 * @brief	Collects a finished IdBuffer pick, if there is one, into pickSelection and the pick
+	 * 			callbacks. Called by preDraw3D() every frame
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void pollIdPick();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::bindDrawTarget();
+	 *
+	 * @brief	Binds the framebuffer that frames are drawn into: the offscreen target in headless mode,
+	 * 			otherwise the window's back buffer
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void bindDrawTarget();
+
+	/**
+	 * @fn	bool Gl_ShaderWindow::needsRedraw();
+	 *
+	 * @brief	Decides whether on-demand mode should draw a frame this tick, clearing the dirty flags
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if something has changed since the last frame.
+	 */
+	bool needsRedraw();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::coalesceInput();
+	 *
+	 * @brief	Drains the events queued by handle() since the last frame and applies them as a few
+	 * 			combined events: runs of drags collapse to the last position and runs of wheel events
+	 * 			to their summed delta
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void coalesceInput();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::dispatchInput(const InputEvent &e);
+	 *
+	 * @brief	Records an event if recording, then applies it with processInput()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	e	The event.
+	 */
+	void dispatchInput(const InputEvent &e);
+
+	/**
+	 * @fn	void Gl_ShaderWindow::finishReplay();
+	 *
+	 * @brief	Stops the replay and reports the frame time statistics
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void finishReplay();
+
+	/**
+	 * @fn	void Gl_ShaderWindow::writeProfile(const char *fileName);
+	 *
+	 * @brief	Writes the profiler statistics as JSON if the file name ends in .json, otherwise as CSV
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName	Filename of the file.
+	 */
+	void writeProfile(const char *fileName);
+
+	/**
+	 * @summary	Records and replays mouse input
+	 */
+	InputRecorder inputRecorder;
+
+	/**
+	 * @summary	Events from handle() waiting for coalesceInput()
+	 */
+	RingBuffer<InputEvent, 256> inputQueue;
+
+	/**
+	 * @summary	true to only draw frames when something has changed
+	 */
+	bool onDemandRedraw;
+
+	/**
+	 * @summary	Non-zero if requestRedraw() has been called since the last frame
+	 */
+	volatile LONG redrawRequested;
+
+	/**
+	 * @summary	Schedules the timer ticks and measures what each frame costs
+	 */
+	FramePacer pacer;
+	int frameCostSection;
+
+	/**
+	 * @summary	The time base for environmentCalc()
+	 */
+	FrameClock frameClock;
+
+	/**
+	 * @summary	The swap interval to set, and whether it still needs setting
+	 */
+	int swapInterval;
+	bool swapIntervalPending;
+
+	/**
+	 * @summary	Where stopRecording() writes the log
+	 */
+	string recordFile;
+
+	/**
+	 * @summary	Where to write the profiler statistics when the replay finishes. Empty for nowhere
+	 */
+	string replayProfileFile;
+
+	/**
+	 * @summary	The number of timer ticks (or headless frames) so far. Recorded events are keyed to it
+	 */
+	unsigned int frameCount;
+
+	/**
+	 * @summary	Measures the time between timer ticks
+	 */
+	CStopWatch frameStopWatch;
+
+	/**
+	 * @summary	Profiler section for the time between timer ticks
+	 */
+	int frameSection;
 
 	/**
 	 * @summary	true if graphics have been initialized.
@@ -0,0 +1,137 @@
+#include "StdAfx.h"
+#include "GpuTimer.h"
+#include "GLCapabilities.h"
+
+/**
+ * @fn	GpuTimer::GpuTimer(void)
+ *
+ * @brief	Constructor. No GL calls are made until the first begin()
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+GpuTimer::GpuTimer(void)
+{
+	for(int i = 0; i < NUM_QUERIES; ++i){
+		queries[i] = 0;
+		pending[i] = false;
+	}
+	next = 0;
+	oldest = 0;
+	timing = false;
+	initialized = false;
+	lastMs = 0.0f;
+}
+
+GpuTimer::~GpuTimer(void)
+{
+}
+
+/**
+ * @fn	bool GpuTimer::isSupported()
+ *
+ * @brief	Query if the current context supports timer queries (GL 3.3 or ARB_timer_query)
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	true if supported.
+ */
+bool GpuTimer::isSupported(){
+	return GLCapabilities::isVersion(3, 3) || GLCapabilities::hasExtension("GL_ARB_timer_query");
+}
+
+/**
+ * @fn	void GpuTimer::begin()
+ *
+ * @brief	Starts timing the GL commands that follow, unless every query in the ring is still in flight
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void GpuTimer::begin(){
+	if(!initialized){
+		if(!isSupported())
+			return;
+		glGenQueries(NUM_QUERIES, queries);
+		initialized = true;
+	}
+
+	// the GPU is more than NUM_QUERIES frames behind. Skip this one rather than wait
+	if(pending[next])
+		return;
+
+	glBeginQuery(GL_TIME_ELAPSED, queries[next]);
+	timing = true;
+}
+
+/**
+ * @fn	void GpuTimer::end()
+ *
+ * @brief	Stops timing.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void GpuTimer::end(){
+	if(!timing)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	pending[next] = true;
+	next = (next + 1) % NUM_QUERIES;
+	timing = false;
+}
+
+/**
+ * @fn	bool GpuTimer::getResult(float &ms)
+ *
+ * @brief	Gets the oldest finished measurement, if there is one. Queries complete in the order they
+ * 			were issued, so if the oldest isn't available yet none of the others are either
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	ms	The GPU time in milliseconds.
+ *
+ * @return	true if a result was returned, false if nothing has finished yet.
+ */
+bool GpuTimer::getResult(float &ms){
+	GLint available = 0;
+	GLuint64 elapsed = 0;
+
+	if(!pending[oldest])
+		return false;
+
+	glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+	if(!available)
+		return false;
+
+	glGetQueryObjectui64v(queries[oldest], GL_QUERY_RESULT, &elapsed);
+	pending[oldest] = false;
+	oldest = (oldest + 1) % NUM_QUERIES;
+
+	lastMs = (float)(elapsed/1000000.0); // nanoseconds
+	ms = lastMs;
+	return true;
+}
+
+/**
+ * @fn	void GpuTimer::cleanup()
+ *
+ * @brief	Deletes the query objects.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void GpuTimer::cleanup(){
+	if(initialized){
+		glDeleteQueries(NUM_QUERIES, queries);
+		initialized = false;
+	}
+	for(int i = 0; i < NUM_QUERIES; ++i)
+		pending[i] = false;
+	next = 0;
+	oldest = 0;
+	timing = false;
+}
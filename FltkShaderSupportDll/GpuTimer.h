@@ -0,0 +1,152 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+
+/**
+ * @class	GpuTimer
+ *
+ * @brief	Measures how long the GPU takes to execute a block of GL commands using GL_TIME_ELAPSED
+ * 			queries. The queries are kept in a small ring and a result is only read back once
+ * 			GL_QUERY_RESULT_AVAILABLE says it is ready - usually a few frames later - so timing never
+ * 			stalls the pipeline. If every query in the ring is still in flight, that begin()/end() pair
+ * 			is simply not timed.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class GpuTimer
+{
+public:
+
+	/**
+	 * @brief	Number of queries in the ring
+	 */
+	enum {NUM_QUERIES = 4};
+
+	/**
+	 * @fn	GpuTimer::GpuTimer(void);
+	 *
+	 * @brief	Constructor. No GL calls are made until the first begin()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	GpuTimer(void);
+
+	/**
+	 * @fn	GpuTimer::~GpuTimer(void);
+	 *
+	 * @brief	Destructor. Call cleanup() while the GL context is still current first
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~GpuTimer(void);
+
+	/**
+	 * @fn	static bool GpuTimer::isSupported();
+	 *
+	 * @brief	Query if the current context supports timer queries
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if supported.
+	 */
+	static bool isSupported();
+
+	/**
+	 * @fn	void GpuTimer::begin();
+	 *
+	 * @brief	Starts timing the GL commands that follow. Timer queries can't be nested, so only one
+	 * 			GpuTimer may be between begin() and end() at a time
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void begin();
+
+	/**
+	 * @fn	void GpuTimer::end();
+	 *
+	 * @brief	Stops timing.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void end();
+
+	/**
+	 * @fn	bool GpuTimer::getResult(float &ms);
+	 *
+	 * @brief	Gets the oldest finished measurement, if there is one. Never waits on the GPU
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	ms	The GPU time in milliseconds.
+	 *
+	 * @return	true if a result was returned, false if nothing has finished yet.
+	 */
+	bool getResult(float &ms);
+
+	/**
+	 * @fn	float GpuTimer::getLastMs()
+	 *
+	 * @brief	Gets the most recent result returned by getResult()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The GPU time in milliseconds.
+	 */
+	float getLastMs(){	return lastMs;	};
+
+	/**
+	 * @fn	void GpuTimer::cleanup();
+	 *
+	 * @brief	Deletes the query objects.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void cleanup();
+
+protected:
+
+	/**
+	 * @summary	The query objects
+	 */
+	GLuint queries[NUM_QUERIES];
+
+	/**
+	 * @summary	true for queries that have been issued but not read back
+	 */
+	bool pending[NUM_QUERIES];
+
+	/**
+	 * @summary	The next query to issue
+	 */
+	int next;
+
+	/**
+	 * @summary	The oldest query that hasn't been read back
+	 */
+	int oldest;
+
+	/**
+	 * @summary	true between begin() and end() if this pair is being timed
+	 */
+	bool timing;
+
+	/**
+	 * @summary	true once the queries have been generated
+	 */
+	bool initialized;
+
+	/**
+	 * @summary	The most recent result
+	 */
+	float lastMs;
+};
@@ -17,10 +17,14 @@ GLBatch	_yzBatch;
 * @param	divisions	The number of lines in each 'grid plane'.
 */
 GridStage::GridStage(float size, int divisions):DrawableObject(GL_TEXTURE0){
+	setName("GridStage");
+	setSnapshotSafe(true); // nothing moves
 	init(size, divisions);
 }
 
 GridStage::GridStage():DrawableObject(GL_TEXTURE0){
+	setName("GridStage");
+	setSnapshotSafe(true); // nothing moves
 }
 
 GridStage::~GridStage(void)
@@ -43,6 +47,11 @@ void GridStage::init(float size, int divisions){
 void GridStage::setup(){
 		float step = _size/(float)_divisions;
 		float pos;
+
+		// the planes fill a cube, which is what the bounds describe. Ray picks test the planes themselves
+		setFloats( minAARB, 3, -_size, -_size, -_size);
+		setFloats( maxAARB, 3, _size, _size, _size);
+		boundingSphereRadius = _size*sqrt(3.0f);
 		
 		// XY plane (green)
 		//glMaterial(GL_FRONT, GL_AMBIENT, lm.getGreenMaterial());
@@ -112,4 +121,43 @@ void GridStage::render(GLMatrixStack &modelViewStack, GLMatrixStack &projectionS
 		shaderManager.UseStockShader(GLT_SHADER_FLAT, projectionStack.GetMatrix(),	 vBlue);	
 		_yzBatch.Draw();
 	projectionStack.PopMatrix();
-}
\ No newline at end of file
+}
+
+/**
+* @fn	bool GridStage::rayIntersect(const M3DVector3f origin, const M3DVector3f dir, float &distance);
+*
+* @brief	Tests a world space ray against the XY, XZ and YZ planes, each limited to +/- _size about
+* 			position
+*
+* @author	agent
+* @date	10/17/2026
+*
+* @param	origin			The start of the ray.
+* @param	dir				The unit direction of the ray.
+* @param [out]	distance	How far along the ray the nearest plane was hit.
+*
+* @return	true if the ray crosses one of the planes inside the grid.
+*/
+bool GridStage::rayIntersect(const M3DVector3f origin, const M3DVector3f dir, float &distance){
+	bool hit = false;
+
+	// axis is the plane's normal: 2 is XY, 1 is XZ, 0 is YZ
+	for(int axis = 0; axis < 3; ++axis){
+		if(fabs(dir[axis]) < 1e-6f)
+			continue; // parallel to the plane
+		float t = (position[axis] - origin[axis])/dir[axis];
+		if(t < 0.0f || (hit && t >= distance))
+			continue;
+
+		bool inside = true;
+		for(int i = 0; i < 3; ++i){
+			if(i != axis && fabs(origin[i] + dir[i]*t - position[i]) > _size)
+				inside = false;
+		}
+		if(inside){
+			distance = t;
+			hit = true;
+		}
+	}
+	return hit;
+}
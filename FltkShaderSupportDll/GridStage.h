@@ -66,6 +66,24 @@ public:
 	 */
 	void render(GLMatrixStack &modelViewStack, GLMatrixStack &projectionStack, GLShaderManager &shaderManager);
 
+	/**
+	 * @fn	bool GridStage::rayIntersect(const M3DVector3f origin, const M3DVector3f dir,
+	 * 		float &distance);
+	 *
+	 * @brief	Tests a world space ray against the three grid planes rather than the cube they fill,
+	 * 			so that picks aimed at objects standing on the grid aren't swallowed by it
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	origin			The start of the ray.
+	 * @param	dir				The unit direction of the ray.
+	 * @param [out]	distance	How far along the ray the nearest plane was hit.
+	 *
+	 * @return	true if the ray crosses one of the planes inside the grid.
+	 */
+	bool rayIntersect(const M3DVector3f origin, const M3DVector3f dir, float &distance);
+
 	/**
 	 * @fn	void GridStage::environmentCalc()
 	 *
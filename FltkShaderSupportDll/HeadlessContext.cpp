@@ -0,0 +1,245 @@
+#include "StdAfx.h"
+#include "HeadlessContext.h"
+
+/**
+ * @fn	HeadlessContext::HeadlessContext(void)
+ *
+ * @brief	Constructor. Nothing is created until create() is called
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+HeadlessContext::HeadlessContext(void)
+{
+	context = NULL;
+#if !defined(HEADLESS_CONTEXT_OSMESA)
+	pbuffer = NULL;
+	pbufferDC = NULL;
+	releasePbufferDC = NULL;
+	destroyPbuffer = NULL;
+#endif
+}
+
+HeadlessContext::~HeadlessContext(void)
+{
+	destroy();
+}
+
+#if defined(HEADLESS_CONTEXT_OSMESA)
+
+/**
+ * @fn	bool HeadlessContext::create()
+ *
+ * @brief	Creates an OSMesa context with a 24 bit depth buffer and an 8 bit stencil
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	false if OSMesa couldn't make the context.
+ */
+bool HeadlessContext::create(){
+	destroy();
+
+	context = OSMesaCreateContextExt(OSMESA_RGBA, 24, 8, 0, NULL);
+	if(context == NULL){
+		fprintf(stderr, "HeadlessContext::create() OSMesaCreateContextExt failed\n");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @fn	bool HeadlessContext::makeCurrent()
+ *
+ * @brief	Makes the context current on the calling thread, drawing to a single pixel
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	false if there is no context, or it couldn't be made current.
+ */
+bool HeadlessContext::makeCurrent(){
+	if(context == NULL)
+		return false;
+	return OSMesaMakeCurrent(context, pixel, GL_UNSIGNED_BYTE, 1, 1) != GL_FALSE;
+}
+
+/**
+ * @fn	void HeadlessContext::destroy()
+ *
+ * @brief	Deletes the context
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void HeadlessContext::destroy(){
+	if(context == NULL)
+		return;
+	if(OSMesaGetCurrentContext() == context)
+		OSMesaMakeCurrent(NULL, NULL, GL_UNSIGNED_BYTE, 0, 0);
+	OSMesaDestroyContext(context);
+	context = NULL;
+}
+
+#else
+
+static const char *dummyClassName = "HeadlessContextDummy";
+
+/**
+ * @fn	bool HeadlessContext::create()
+ *
+ * @brief	Creates a 1x1 pbuffer and a context on it. The pbuffer pixel format can only be chosen
+ * 			with wglChoosePixelFormatARB(), which needs a current context, so a throwaway window and
+ * 			context are made for that first. The window is never shown
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	false if the driver doesn't have WGL_ARB_pbuffer and WGL_ARB_pixel_format, or any step fails.
+ */
+bool HeadlessContext::create(){
+	static bool classRegistered = false;
+	PIXELFORMATDESCRIPTOR pfd;
+	PFNWGLCHOOSEPIXELFORMATARBPROC choosePixelFormat;
+	PFNWGLCREATEPBUFFERARBPROC createPbuffer;
+	PFNWGLGETPBUFFERDCARBPROC getPbufferDC;
+	HWND dummyWindow;
+	HDC dummyDC;
+	HGLRC dummyContext;
+	int format;
+	UINT numFormats;
+	const int formatAttribs[] = {
+		WGL_DRAW_TO_PBUFFER_ARB, TRUE,
+		WGL_SUPPORT_OPENGL_ARB, TRUE,
+		WGL_PIXEL_TYPE_ARB, WGL_TYPE_RGBA_ARB,
+		WGL_COLOR_BITS_ARB, 32,
+		WGL_DEPTH_BITS_ARB, 24,
+		0};
+	const int pbufferAttribs[] = {0};
+
+	destroy();
+
+	if(!classRegistered){
+		WNDCLASSA wc;
+		memset(&wc, 0, sizeof(wc));
+		wc.style = CS_OWNDC;
+		wc.lpfnWndProc = DefWindowProcA;
+		wc.hInstance = GetModuleHandle(NULL);
+		wc.lpszClassName = dummyClassName;
+		classRegistered = RegisterClassA(&wc) != 0;
+	}
+	dummyWindow = CreateWindowA(dummyClassName, "", WS_POPUP, 0, 0, 1, 1, NULL, NULL, GetModuleHandle(NULL), NULL);
+	if(dummyWindow == NULL){
+		fprintf(stderr, "HeadlessContext::create() unable to create the pixel format window: %d\n", GetLastError());
+		return false;
+	}
+	dummyDC = GetDC(dummyWindow);
+
+	memset(&pfd, 0, sizeof(pfd));
+	pfd.nSize = sizeof(pfd);
+	pfd.nVersion = 1;
+	pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL;
+	pfd.iPixelType = PFD_TYPE_RGBA;
+	pfd.cColorBits = 32;
+	pfd.cDepthBits = 24;
+	pfd.iLayerType = PFD_MAIN_PLANE;
+	SetPixelFormat(dummyDC, ChoosePixelFormat(dummyDC, &pfd), &pfd);
+	dummyContext = wglCreateContext(dummyDC);
+	if(dummyContext == NULL || !wglMakeCurrent(dummyDC, dummyContext)){
+		fprintf(stderr, "HeadlessContext::create() unable to create the pixel format context: %d\n", GetLastError());
+		if(dummyContext != NULL)
+			wglDeleteContext(dummyContext);
+		ReleaseDC(dummyWindow, dummyDC);
+		DestroyWindow(dummyWindow);
+		return false;
+	}
+
+	choosePixelFormat = (PFNWGLCHOOSEPIXELFORMATARBPROC)wglGetProcAddress("wglChoosePixelFormatARB");
+	createPbuffer = (PFNWGLCREATEPBUFFERARBPROC)wglGetProcAddress("wglCreatePbufferARB");
+	getPbufferDC = (PFNWGLGETPBUFFERDCARBPROC)wglGetProcAddress("wglGetPbufferDCARB");
+	releasePbufferDC = (PFNWGLRELEASEPBUFFERDCARBPROC)wglGetProcAddress("wglReleasePbufferDCARB");
+	destroyPbuffer = (PFNWGLDESTROYPBUFFERARBPROC)wglGetProcAddress("wglDestroyPbufferARB");
+
+	if(choosePixelFormat == NULL || createPbuffer == NULL || getPbufferDC == NULL ||
+		releasePbufferDC == NULL || destroyPbuffer == NULL){
+		fprintf(stderr, "HeadlessContext::create() WGL_ARB_pbuffer or WGL_ARB_pixel_format is not supported\n");
+	}else if(!choosePixelFormat(dummyDC, formatAttribs, NULL, 1, &format, &numFormats) || numFormats == 0){
+		fprintf(stderr, "HeadlessContext::create() no pbuffer pixel format\n");
+	}else{
+		pbuffer = createPbuffer(dummyDC, format, 1, 1, pbufferAttribs);
+		if(pbuffer != NULL){
+			pbufferDC = getPbufferDC(pbuffer);
+			context = wglCreateContext(pbufferDC);
+		}
+		if(context == NULL)
+			fprintf(stderr, "HeadlessContext::create() unable to create the pbuffer context: %d\n", GetLastError());
+	}
+
+	// the pbuffer doesn't depend on the window it was chosen through
+	wglMakeCurrent(NULL, NULL);
+	wglDeleteContext(dummyContext);
+	ReleaseDC(dummyWindow, dummyDC);
+	DestroyWindow(dummyWindow);
+
+	if(context == NULL){
+		destroy();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @fn	bool HeadlessContext::makeCurrent()
+ *
+ * @brief	Makes the pbuffer context current on the calling thread
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	false if there is no context, or it couldn't be made current.
+ */
+bool HeadlessContext::makeCurrent(){
+	if(context == NULL)
+		return false;
+	return wglMakeCurrent(pbufferDC, context) != FALSE;
+}
+
+/**
+ * @fn	void HeadlessContext::destroy()
+ *
+ * @brief	Deletes the context, then the pbuffer and its device context
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void HeadlessContext::destroy(){
+	if(context != NULL){
+		if(wglGetCurrentContext() == context)
+			wglMakeCurrent(NULL, NULL);
+		wglDeleteContext(context);
+		context = NULL;
+	}
+	if(pbuffer != NULL){
+		if(pbufferDC != NULL)
+			releasePbufferDC(pbuffer, pbufferDC);
+		destroyPbuffer(pbuffer);
+	}
+	pbuffer = NULL;
+	pbufferDC = NULL;
+}
+
+#endif
+
+/**
+ * @fn	bool HeadlessContext::isValid()
+ *
+ * @brief	Query if create() succeeded.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	true if there is a context.
+ */
+bool HeadlessContext::isValid(){
+	return context != NULL;
+}
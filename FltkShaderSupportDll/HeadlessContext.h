@@ -0,0 +1,121 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#if defined(HEADLESS_CONTEXT_OSMESA)
+#include <GL/osmesa.h>
+#else
+#include <GL/wglew.h>
+#endif
+#include <stdio.h>
+
+/**
+ * @class	HeadlessContext
+ *
+ * @brief	A GL context that isn't attached to a window, so that runHeadless() can draw without a
+ * 			display. Frames go into an OffscreenTarget, so the context's own surface is only 1x1.
+ *
+ * 			By default this is a WGL pbuffer. The pixel format has to be picked through a context, so a
+ * 			throwaway window that is never shown is made for that and destroyed straight away. On a
+ * 			machine with no GPU, Mesa's llvmpipe opengl32.dll provides the pbuffer. Building with
+ * 			HEADLESS_CONTEXT_OSMESA uses OSMesa instead, which needs no window at all; GLEW has to be
+ * 			built with GLEW_OSMESA to match.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class HeadlessContext
+{
+public:
+
+	/**
+	 * @fn	HeadlessContext::HeadlessContext(void);
+	 *
+	 * @brief	Constructor. Nothing is created until create() is called
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	HeadlessContext(void);
+
+	/**
+	 * @fn	HeadlessContext::~HeadlessContext(void);
+	 *
+	 * @brief	Destructor. Calls destroy()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~HeadlessContext(void);
+
+	/**
+	 * @fn	bool HeadlessContext::create();
+	 *
+	 * @brief	Creates the context, replacing any previous one. It isn't made current
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	false if the driver can't make a context without a window. The reason is printed to
+	 * 			stderr.
+	 */
+	bool create();
+
+	/**
+	 * @fn	bool HeadlessContext::makeCurrent();
+	 *
+	 * @brief	Makes the context current on the calling thread
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	false if there is no context, or it couldn't be made current.
+	 */
+	bool makeCurrent();
+
+	/**
+	 * @fn	bool HeadlessContext::isValid()
+	 *
+	 * @brief	Query if create() succeeded.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if there is a context.
+	 */
+	bool isValid();
+
+	/**
+	 * @fn	void HeadlessContext::destroy();
+	 *
+	 * @brief	Releases the context if it is current, then deletes it and its surface. Anything made
+	 * 			in it should be deleted first
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void destroy();
+
+protected:
+
+#if defined(HEADLESS_CONTEXT_OSMESA)
+	/**
+	 * @summary	The context, and the 1x1 color buffer it is made current on
+	 */
+	OSMesaContext context;
+	GLubyte pixel[4];
+#else
+	/**
+	 * @summary	The pbuffer, its device context and the GL context made on it
+	 */
+	HPBUFFERARB pbuffer;
+	HDC pbufferDC;
+	HGLRC context;
+
+	/**
+	 * @summary	WGL_ARB_pbuffer entry points, kept for destroy()
+	 */
+	PFNWGLRELEASEPBUFFERDCARBPROC releasePbufferDC;
+	PFNWGLDESTROYPBUFFERARBPROC destroyPbuffer;
+#endif
+};
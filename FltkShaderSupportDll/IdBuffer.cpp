@@ -0,0 +1,364 @@
+#include "StdAfx.h"
+#include "IdBuffer.h"
+#include <stdio.h>
+#include <algorithm>
+
+static const GLenum fboBuffs[] = { GL_COLOR_ATTACHMENT0 };
+
+static const char *idVertexSrc =
+	"#version 130\n"
+	"in vec4 vVertex;\n"
+	"void main(void){\n"
+	"	gl_Position = vVertex;\n"
+	"}\n";
+
+static const char *idFragmentSrc =
+	"#version 130\n"
+	"uniform uint objectId;\n"
+	"out uint oId;\n"
+	"void main(void){\n"
+	"	oId = objectId;\n"
+	"}\n";
+
+/**
+ * @fn	IdBuffer::IdBuffer(void)
+ *
+ * @brief	Constructor. Nothing is allocated until create() is called
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+IdBuffer::IdBuffer(void)
+{
+	fbo = 0;
+	idRenderbuffer = 0;
+	depthStencilBuffer = 0;
+	width = 0;
+	height = 0;
+	idProgram = 0;
+	objectIdLoc = -1;
+	drawing = false;
+	for(int i = 0; i < NUM_READBACKS; ++i){
+		pbos[i] = 0;
+		fences[i] = NULL;
+	}
+	next = 0;
+	oldest = 0;
+}
+
+IdBuffer::~IdBuffer(void)
+{
+}
+
+/**
+ * @fn	bool IdBuffer::create(int w, int h)
+ *
+ * @brief	Creates the framebuffer and its renderbuffers, replacing any previous ones. The shader and
+ * 			the pixel buffers are made the first time only.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	w	The width.
+ * @param	h	The height.
+ *
+ * @return	true if the framebuffer is complete.
+ */
+bool IdBuffer::create(int w, int h){
+	GLenum status;
+
+	if(idProgram == 0){
+		idProgram = gltLoadShaderPairSrcWithAttributes(idVertexSrc, idFragmentSrc, 1, GLT_ATTRIBUTE_VERTEX, "vVertex");
+		if(idProgram == 0){
+			fprintf(stderr, "IdBuffer::create() unable to build the ID shader\n");
+			return false;
+		}
+		glBindFragDataLocation(idProgram, 0, "oId");
+		glLinkProgram(idProgram); // relink so the output binding takes
+		objectIdLoc = glGetUniformLocation(idProgram, "objectId");
+
+		// clip space, so no matrices are needed
+		quadBatch.Begin(GL_TRIANGLE_FAN, 4);
+			quadBatch.Vertex3f(-1.0f, -1.0f, 0.0f);
+			quadBatch.Vertex3f(1.0f, -1.0f, 0.0f);
+			quadBatch.Vertex3f(1.0f, 1.0f, 0.0f);
+			quadBatch.Vertex3f(-1.0f, 1.0f, 0.0f);
+		quadBatch.End();
+
+		glGenBuffers(NUM_READBACKS, pbos);
+	}
+
+	deleteBuffers();
+	width = w;
+	height = h;
+
+	glGenRenderbuffers(1, &idRenderbuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, idRenderbuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_R32UI, width, height);
+
+	glGenRenderbuffers(1, &depthStencilBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthStencilBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, idRenderbuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencilBuffer);
+
+	status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if(status != GL_FRAMEBUFFER_COMPLETE){
+		fprintf(stderr, "IdBuffer::create() framebuffer incomplete: 0x%x\n", status);
+		deleteBuffers();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @fn	bool IdBuffer::begin(int x, int y, int w, int h)
+ *
+ * @brief	Binds the framebuffer and clears the rectangle that is about to be picked
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	x	The left edge.
+ * @param	y	The bottom edge.
+ * @param	w	The width.
+ * @param	h	The height.
+ *
+ * @return	false if there is nothing to draw.
+ */
+bool IdBuffer::begin(int x, int y, int w, int h){
+	static const GLuint noId[] = {0, 0, 0, 0};
+	int x1 = min(x + w, width);
+	int y1 = min(y + h, height);
+
+	// the GPU is NUM_READBACKS picks behind. Skip this one rather than wait
+	if(fbo == 0 || fences[next] != NULL)
+		return false;
+
+	center[0] = x + w/2;
+	center[1] = y + h/2;
+	rect[0] = max(x, 0);
+	rect[1] = max(y, 0);
+	rect[2] = x1 - rect[0];
+	rect[3] = y1 - rect[1];
+	if(rect[2] <= 0 || rect[3] <= 0)
+		return false;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glDrawBuffers(1, fboBuffs);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(rect[0], rect[1], rect[2], rect[3]);
+	glClearBufferuiv(GL_COLOR, 0, noId);
+	glClear(GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+	glEnable(GL_STENCIL_TEST);
+
+	drawing = true;
+	return true;
+}
+
+/**
+ * @fn	void IdBuffer::beginObject()
+ *
+ * @brief	Turns off color writes and marks the stencil wherever the object passes the depth test
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void IdBuffer::beginObject(){
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glStencilFunc(GL_ALWAYS, 1, 0xff);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+}
+
+/**
+ * @fn	void IdBuffer::endObject(GLuint id)
+ *
+ * @brief	Writes the object's ID into the marked pixels and clears the marks. The depth the object
+ * 			wrote is left alone, so objects drawn later only take the pixels they are in front of
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	id	The object's pick ID.
+ */
+void IdBuffer::endObject(GLuint id){
+	GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glStencilFunc(GL_EQUAL, 1, 0xff);
+	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
+	glDisable(GL_DEPTH_TEST);
+	glDepthMask(GL_FALSE);
+
+	glUseProgram(idProgram);
+	glUniform1ui(objectIdLoc, id);
+	quadBatch.Draw();
+
+	glDepthMask(GL_TRUE);
+	if(depthTest)
+		glEnable(GL_DEPTH_TEST);
+}
+
+/**
+ * @fn	void IdBuffer::end()
+ *
+ * @brief	Starts the copy of the rectangle into a pixel buffer and puts the state back
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void IdBuffer::end(){
+	if(!drawing)
+		return;
+
+	glDisable(GL_STENCIL_TEST);
+	glDisable(GL_SCISSOR_TEST);
+	glUseProgram(0);
+
+	readbackRect[next][0] = rect[2];
+	readbackRect[next][1] = rect[3];
+	readbackRect[next][2] = center[0] - rect[0];
+	readbackRect[next][3] = center[1] - rect[1];
+
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[next]);
+	glBufferData(GL_PIXEL_PACK_BUFFER, rect[2]*rect[3]*sizeof(GLuint), NULL, GL_STREAM_READ);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glReadPixels(rect[0], rect[1], rect[2], rect[3], GL_RED_INTEGER, GL_UNSIGNED_INT, NULL); // returns straight away
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	fences[next] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	next = (next + 1) % NUM_READBACKS;
+	drawing = false;
+}
+
+/**
+ * @fn	bool IdBuffer::getResult(vector<GLuint> &ids)
+ *
+ * @brief	Gets the oldest finished pick without waiting, if there is one. Readbacks finish in the
+ * 			order they were issued, so if the oldest isn't done none of the others are either
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	ids	Filled with each different ID in the rectangle, nearest the middle first.
+ *
+ * @return	true if a result was returned, false if nothing has finished yet.
+ */
+bool IdBuffer::getResult(vector<GLuint> &ids){
+	GLenum status;
+	GLuint *pixels;
+	int w, h;
+	vector< pair<int, GLuint> > found; // (distance from the middle squared, ID)
+
+	if(fences[oldest] == NULL)
+		return false;
+
+	status = glClientWaitSync(fences[oldest], 0, 0); // zero timeout, so this only polls
+	if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		return false;
+
+	glDeleteSync(fences[oldest]);
+	fences[oldest] = NULL;
+
+	w = readbackRect[oldest][0];
+	h = readbackRect[oldest][1];
+	ids.clear();
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[oldest]);
+	pixels = (GLuint*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, w*h*sizeof(GLuint), GL_MAP_READ_BIT);
+	if(pixels != NULL){
+		for(int y = 0; y < h; ++y){
+			for(int x = 0; x < w; ++x){
+				GLuint id = pixels[y*w + x];
+				int dx = x - readbackRect[oldest][2];
+				int dy = y - readbackRect[oldest][3];
+				int dist = dx*dx + dy*dy;
+				unsigned int i;
+
+				if(id == 0)
+					continue;
+				for(i = 0; i < found.size() && found[i].second != id; ++i)
+					;
+				if(i == found.size())
+					found.push_back(make_pair(dist, id));
+				else if(dist < found[i].first)
+					found[i].first = dist;
+			}
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	oldest = (oldest + 1) % NUM_READBACKS;
+
+	sort(found.begin(), found.end());
+	for(unsigned int i = 0; i < found.size(); ++i)
+		ids.push_back(found[i].second);
+	return true;
+}
+
+/**
+ * @fn	bool IdBuffer::isPending()
+ *
+ * @brief	Query if any pick is still on its way.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	true if getResult() has something to collect, now or soon.
+ */
+bool IdBuffer::isPending(){
+	return fences[oldest] != NULL;
+}
+
+/**
+ * @fn	void IdBuffer::deleteBuffers()
+ *
+ * @brief	Deletes just the framebuffer and its renderbuffers
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void IdBuffer::deleteBuffers(){
+	if(fbo != 0)
+		glDeleteFramebuffers(1, &fbo);
+	if(idRenderbuffer != 0)
+		glDeleteRenderbuffers(1, &idRenderbuffer);
+	if(depthStencilBuffer != 0)
+		glDeleteRenderbuffers(1, &depthStencilBuffer);
+	fbo = 0;
+	idRenderbuffer = 0;
+	depthStencilBuffer = 0;
+}
+
+/**
+ * @fn	void IdBuffer::cleanup()
+ *
+ * @brief	Deletes the framebuffer, the shader, the pixel buffers and any fences
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void IdBuffer::cleanup(){
+	deleteBuffers();
+	for(int i = 0; i < NUM_READBACKS; ++i){
+		if(fences[i] != NULL)
+			glDeleteSync(fences[i]);
+		fences[i] = NULL;
+	}
+	if(idProgram != 0){
+		glDeleteProgram(idProgram);
+		glDeleteBuffers(NUM_READBACKS, pbos);
+	}
+	idProgram = 0;
+	next = 0;
+	oldest = 0;
+	drawing = false;
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <GLBatch.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class	IdBuffer
+ *
+ * @brief	A framebuffer with a 32 bit unsigned integer color buffer that holds, for each pixel, the
+ * 			pick ID of the object nearest the eye. Picking a point or a box is then one read of the
+ * 			pixels under it, however many objects are in the scene.
+ *
+ * 			The objects' own shaders only write a color, so the IDs are written in a pass of their own,
+ * 			and only on frames where a pick was asked for. Each object is drawn with its normal render()
+ * 			with color writes off, marking the stencil wherever it passes the depth test; a single quad
+ * 			then writes the object's ID into the marked pixels and clears the mark. The whole pass is
+ * 			scissored to the pick rectangle. The pixels are read into a pixel buffer object and
+ * 			collected a frame or two later with getResult(), once a fence says the copy is done, so the
+ * 			CPU never waits on the GPU.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class IdBuffer
+{
+public:
+
+	/**
+	 * @fn	IdBuffer::IdBuffer(void);
+	 *
+	 * @brief	Constructor. Nothing is allocated until create() is called
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	IdBuffer(void);
+
+	/**
+	 * @fn	IdBuffer::~IdBuffer(void);
+	 *
+	 * @brief	Destructor. Call cleanup() while the GL context is still current first
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~IdBuffer(void);
+
+	/**
+	 * @fn	bool IdBuffer::create(int w, int h);
+	 *
+	 * @brief	Creates the framebuffer and its renderbuffers at the window's size, replacing any
+	 * 			previous ones. The shader and the pixel buffers are made the first time only.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	w	The width.
+	 * @param	h	The height.
+	 *
+	 * @return	true if the framebuffer is complete.
+	 */
+	bool create(int w, int h);
+
+	/**
+	 * @fn	bool IdBuffer::begin(int x, int y, int w, int h);
+	 *
+	 * @brief	Binds the framebuffer and clears the rectangle that is about to be picked. Everything
+	 * 			outside it is scissored away. The rectangle is in GL window coordinates (origin at the
+	 * 			bottom left) and is clipped to the buffer.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	x	The left edge.
+	 * @param	y	The bottom edge.
+	 * @param	w	The width.
+	 * @param	h	The height.
+	 *
+	 * @return	false if the rectangle is off the buffer or every readback is still in flight, in which
+	 * 			case nothing should be drawn and end() should not be called.
+	 */
+	bool begin(int x, int y, int w, int h);
+
+	/**
+	 * @fn	void IdBuffer::beginObject();
+	 *
+	 * @brief	Call before drawing an object with its own render(). Turns off color writes and marks the
+	 * 			stencil wherever the object passes the depth test
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void beginObject();
+
+	/**
+	 * @fn	void IdBuffer::endObject(GLuint id);
+	 *
+	 * @brief	Call after drawing an object. Writes its ID into the marked pixels and clears the marks
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	id	The object's pick ID. Zero is reserved for "nothing".
+	 */
+	void endObject(GLuint id);
+
+	/**
+	 * @fn	void IdBuffer::end();
+	 *
+	 * @brief	Starts the copy of the rectangle into a pixel buffer and puts the state back. The caller
+	 * 			has to rebind its own framebuffer afterwards
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void end();
+
+	/**
+	 * @fn	bool IdBuffer::getResult(vector<GLuint> &ids);
+	 *
+	 * @brief	Gets the oldest finished pick without waiting, if there is one.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	ids	Filled with each different ID in the rectangle, nearest the middle of the
+	 * 						rectangle first. Empty if the pick hit nothing.
+	 *
+	 * @return	true if a result was returned, false if nothing has finished yet.
+	 */
+	bool getResult(vector<GLuint> &ids);
+
+	/**
+	 * @fn	bool IdBuffer::isPending();
+	 *
+	 * @brief	Query if any pick is still on its way.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if getResult() has something to collect, now or soon.
+	 */
+	bool isPending();
+
+	/**
+	 * @fn	bool IdBuffer::isValid()
+	 *
+	 * @brief	Query if create() has succeeded.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if the buffer can be drawn into.
+	 */
+	bool isValid(){	return fbo != 0;	};
+
+	int getWidth(){	return width;	};
+	int getHeight(){	return height;	};
+
+	/**
+	 * @fn	void IdBuffer::cleanup();
+	 *
+	 * @brief	Deletes the framebuffer, the shader, the pixel buffers and any fences
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void cleanup();
+
+protected:
+
+	/**
+	 * @fn	void IdBuffer::deleteBuffers();
+	 *
+	 * @brief	Deletes just the framebuffer and its renderbuffers
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void deleteBuffers();
+
+	/**
+	 * @summary	The framebuffer, its GL_R32UI color renderbuffer and its depth/stencil renderbuffer
+	 */
+	GLuint fbo;
+	GLuint idRenderbuffer;
+	GLuint depthStencilBuffer;
+	int width;
+	int height;
+
+	/**
+	 * @summary	Writes the objectId uniform into every pixel of a full screen quad
+	 */
+	GLuint idProgram;
+	GLint objectIdLoc;
+	GLBatch quadBatch;
+
+	/**
+	 * @summary	The rectangle being picked by the current pass, after clipping, and the middle of the
+	 * 			rectangle that was asked for
+	 */
+	int rect[4];
+	int center[2];
+	bool drawing;
+
+	/**
+	 * @summary	Readbacks, used round robin. Each is finished when its fence is signalled
+	 */
+	static const int NUM_READBACKS = 3;
+	GLuint pbos[NUM_READBACKS];
+	GLsync fences[NUM_READBACKS];
+	int readbackRect[NUM_READBACKS][4]; // width, height and the middle, relative to the corner
+	int next;
+	int oldest;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <FL/Fl.H>
+
+#pragma pack(push, 1)
+
+/**
+ * @struct	InputEvent
+ *
+ * @brief	A mouse event copied out of FLTK's Fl::event_*() statics, so that it can be handled later,
+ * 			written to a log and replayed. Packed to 18 bytes because it is stored as-is in the
+ * 			InputRecorder log.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+struct InputEvent
+{
+	/**
+	 * @summary	The frame (timer tick) the event arrived in
+	 */
+	unsigned int	frame;
+
+	/**
+	 * @summary	Seconds since recording started
+	 */
+	float			time;
+
+	/**
+	 * @summary	The FLTK event (FL_PUSH, FL_DRAG, FL_RELEASE or FL_MOUSEWHEEL)
+	 */
+	unsigned char	type;
+
+	/**
+	 * @summary	The Gl_ShaderWindow::TRANSFORM_MODE when the event arrived
+	 */
+	unsigned char	mode;
+
+	/**
+	 * @summary	Fl::event_button()
+	 */
+	unsigned char	button;
+
+	/**
+	 * @summary	The buttons held down, bit 0 for button 1, bit 1 for button 2 and bit 2 for button 3
+	 */
+	unsigned char	buttons;
+
+	/**
+	 * @summary	Fl::event_x(), Fl::event_y() and Fl::event_dy()
+	 */
+	short			x;
+	short			y;
+	short			dy;
+
+	/**
+	 * @fn	static InputEvent InputEvent::fromFltk(int event, unsigned int frame, int mode)
+	 *
+	 * @brief	Copies the current FLTK event state
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	event	The FLTK event.
+	 * @param	frame	The current frame.
+	 * @param	mode 	The current transform mode.
+	 *
+	 * @return	The event.
+	 */
+	static InputEvent fromFltk(int event, unsigned int frame, int mode){
+		InputEvent e;
+		e.frame = frame;
+		e.time = 0.0f;
+		e.type = (unsigned char)event;
+		e.mode = (unsigned char)mode;
+		e.button = (unsigned char)Fl::event_button();
+		e.buttons = (unsigned char)((Fl::event_state() & FL_BUTTONS) >> 24);
+		e.x = (short)Fl::event_x();
+		e.y = (short)Fl::event_y();
+		e.dy = (short)Fl::event_dy();
+		return e;
+	}
+
+	bool button1() const {	return (buttons & 0x1) != 0;	};
+	bool button2() const {	return (buttons & 0x2) != 0;	};
+};
+
+#pragma pack(pop)
@@ -0,0 +1,212 @@
+#include "StdAfx.h"
+#include "InputRecorder.h"
+#include <string.h>
+
+static const char logMagic[4] = {'I', 'R', 'E', 'C'};
+static const int logVersion = 1;
+
+/**
+ * @fn	InputRecorder::InputRecorder(void)
+ *
+ * @brief	Constructor.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+InputRecorder::InputRecorder(void)
+{
+	memset(&viewState, 0, sizeof(viewState));
+	numFrames = 0;
+	firstFrame = 0;
+	replayIndex = 0;
+	recording = false;
+	replaying = false;
+}
+
+InputRecorder::~InputRecorder(void)
+{
+}
+
+/**
+ * @fn	void InputRecorder::startRecording(const ViewState &view, unsigned int frame)
+ *
+ * @brief	Throws away any previous events and starts recording
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	view 	The window state when recording starts.
+ * @param	frame	The current frame.
+ */
+void InputRecorder::startRecording(const ViewState &view, unsigned int frame){
+	events.clear();
+	viewState = view;
+	firstFrame = frame;
+	numFrames = 0;
+	replaying = false;
+	recording = true;
+	stopWatch.Reset();
+}
+
+/**
+ * @fn	void InputRecorder::record(InputEvent e)
+ *
+ * @brief	Stamps the event with the time since recording started and stores it
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	e	The event.
+ */
+void InputRecorder::record(InputEvent e){
+	if(!recording)
+		return;
+
+	e.frame -= firstFrame;
+	e.time = stopWatch.GetElapsedSeconds();
+	events.push_back(e);
+}
+
+/**
+ * @fn	void InputRecorder::stopRecording(unsigned int frame)
+ *
+ * @brief	Stops recording.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	frame	The current frame.
+ */
+void InputRecorder::stopRecording(unsigned int frame){
+	if(!recording)
+		return;
+
+	numFrames = frame - firstFrame + 1;
+	recording = false;
+}
+
+/**
+ * @fn	bool InputRecorder::save(const char *fileName)
+ *
+ * @brief	Writes the recorded events to a binary log
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	fileName	Filename of the file.
+ *
+ * @return	true if it succeeds, false if it fails.
+ */
+bool InputRecorder::save(const char *fileName){
+	FILE *fp;
+	unsigned int count = (unsigned int)events.size();
+
+	if(fopen_s(&fp, fileName, "wb") != 0){
+		fprintf(stderr, "InputRecorder::save() unable to open '%s'\n", fileName);
+		return false;
+	}
+
+	fwrite(logMagic, sizeof(logMagic), 1, fp);
+	fwrite(&logVersion, sizeof(logVersion), 1, fp);
+	fwrite(&viewState, sizeof(viewState), 1, fp);
+	fwrite(&numFrames, sizeof(numFrames), 1, fp);
+	fwrite(&count, sizeof(count), 1, fp);
+	if(count > 0)
+		fwrite(&events[0], sizeof(InputEvent), count, fp);
+	fclose(fp);
+	return true;
+}
+
+/**
+ * @fn	bool InputRecorder::load(const char *fileName)
+ *
+ * @brief	Reads a binary log written by save()
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	fileName	Filename of the file.
+ *
+ * @return	true if it succeeds, false if the file can't be read or isn't a log.
+ */
+bool InputRecorder::load(const char *fileName){
+	FILE *fp;
+	char magic[4];
+	int version = 0;
+	unsigned int count = 0;
+	long start, end;
+	bool ok;
+
+	if(fopen_s(&fp, fileName, "rb") != 0){
+		fprintf(stderr, "InputRecorder::load() unable to open '%s'\n", fileName);
+		return false;
+	}
+
+	ok = fread(magic, sizeof(magic), 1, fp) == 1 && memcmp(magic, logMagic, sizeof(magic)) == 0 &&
+		fread(&version, sizeof(version), 1, fp) == 1 && version == logVersion &&
+		fread(&viewState, sizeof(viewState), 1, fp) == 1 &&
+		fread(&numFrames, sizeof(numFrames), 1, fp) == 1 &&
+		fread(&count, sizeof(count), 1, fp) == 1;
+
+	// check the count against what is left of the file before allocating, so that a truncated or
+	// corrupt log is rejected instead of asking for gigabytes
+	if(ok){
+		start = ftell(fp);
+		ok = start >= 0 && fseek(fp, 0, SEEK_END) == 0;
+		end = ok ? ftell(fp) : -1;
+		ok = ok && end >= start && count <= (unsigned long)(end - start)/sizeof(InputEvent) &&
+			fseek(fp, start, SEEK_SET) == 0;
+	}
+	if(ok){
+		events.resize(count);
+		if(count > 0)
+			ok = fread(&events[0], sizeof(InputEvent), count, fp) == count;
+	}
+	fclose(fp);
+
+	if(!ok){
+		fprintf(stderr, "InputRecorder::load() '%s' is not a valid input log\n", fileName);
+		events.clear();
+		numFrames = 0;
+		return false;
+	}
+
+	recording = false;
+	replaying = false;
+	return true;
+}
+
+/**
+ * @fn	void InputRecorder::startReplay()
+ *
+ * @brief	Rewinds to the first event and starts replaying
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void InputRecorder::startReplay(){
+	recording = false;
+	replayIndex = 0;
+	replaying = true;
+}
+
+/**
+ * @fn	bool InputRecorder::nextEvent(unsigned int frame, InputEvent &e)
+ *
+ * @brief	Gets the next event that arrived in or before 'frame'.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	frame		 	The current frame.
+ * @param [in,out]	e	The event.
+ *
+ * @return	false if there are no more events for this frame.
+ */
+bool InputRecorder::nextEvent(unsigned int frame, InputEvent &e){
+	if(!replaying || replayIndex >= events.size() || events[replayIndex].frame > frame)
+		return false;
+
+	e = events[replayIndex++];
+	return true;
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <StopWatch.h>
+#include <stdio.h>
+#include <vector>
+#include "InputEvent.h"
+
+using namespace std;
+
+/**
+ * @class	InputRecorder
+ *
+ * @brief	Records the mouse events that Gl_ShaderWindow handles, with the frame and time they arrived,
+ * 			and plays them back frame by frame so that benchmark runs traverse the scene identically.
+ * 			Events are kept in memory while recording and only written out by save(), so recording
+ * 			does no file I/O during the frame.
+ *
+ * 			The log is a small header (magic, version, the ViewState at the start of the recording
+ * 			and the event count) followed by the packed InputEvents.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class InputRecorder
+{
+public:
+
+	/**
+	 * @struct	ViewState
+	 *
+	 * @brief	The window state that the events are applied to, saved so that a replay starts from
+	 * 			the same place as the recording
+	 */
+	struct ViewState
+	{
+		float	eyePos[3];
+		float	eyeOrient[3];
+		float	worldPos[3];
+		float	worldOrient[3];
+		float	modelPos[3];
+		float	refreshSeconds;
+		int		mode;
+	};
+
+	/**
+	 * @fn	InputRecorder::InputRecorder(void);
+	 *
+	 * @brief	Constructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	InputRecorder(void);
+
+	/**
+	 * @fn	InputRecorder::~InputRecorder(void);
+	 *
+	 * @brief	Destructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~InputRecorder(void);
+
+	/**
+	 * @fn	void InputRecorder::startRecording(const ViewState &view, unsigned int frame);
+	 *
+	 * @brief	Throws away any previous events and starts recording. Frames are stored relative to
+	 * 			'frame', so a replay starts at frame 0
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	view 	The window state when recording starts.
+	 * @param	frame	The current frame.
+	 */
+	void startRecording(const ViewState &view, unsigned int frame);
+
+	/**
+	 * @fn	void InputRecorder::record(InputEvent e);
+	 *
+	 * @brief	Stamps the event with the time since recording started and stores it
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	e	The event.
+	 */
+	void record(InputEvent e);
+
+	/**
+	 * @fn	void InputRecorder::stopRecording(unsigned int frame);
+	 *
+	 * @brief	Stops recording.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	frame	The current frame, so that the replay runs for as long as the recording did.
+	 */
+	void stopRecording(unsigned int frame);
+
+	/**
+	 * @fn	bool InputRecorder::save(const char *fileName);
+	 *
+	 * @brief	Writes the recorded events to a binary log
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName	Filename of the file.
+	 *
+	 * @return	true if it succeeds, false if it fails.
+	 */
+	bool save(const char *fileName);
+
+	/**
+	 * @fn	bool InputRecorder::load(const char *fileName);
+	 *
+	 * @brief	Reads a binary log written by save()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName	Filename of the file.
+	 *
+	 * @return	true if it succeeds, false if the file can't be read or isn't a log.
+	 */
+	bool load(const char *fileName);
+
+	/**
+	 * @fn	void InputRecorder::startReplay();
+	 *
+	 * @brief	Rewinds to the first event and starts replaying
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void startReplay();
+
+	/**
+	 * @fn	bool InputRecorder::nextEvent(unsigned int frame, InputEvent &e);
+	 *
+	 * @brief	Gets the next event that arrived in or before 'frame'. Call until it returns false once
+	 * 			per frame.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	frame		 	The current frame.
+	 * @param [in,out]	e	The event.
+	 *
+	 * @return	false if there are no more events for this frame.
+	 */
+	bool nextEvent(unsigned int frame, InputEvent &e);
+
+	/**
+	 * @fn	void InputRecorder::stopReplay();
+	 *
+	 * @brief	Stops replaying.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void stopReplay(){	replaying = false;	};
+
+	bool isRecording(){	return recording;	};
+	bool isReplaying(){	return replaying;	};
+
+	/**
+	 * @fn	unsigned int InputRecorder::getNumFrames()
+	 *
+	 * @brief	Gets the number of frames the recording covers
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of frames.
+	 */
+	unsigned int getNumFrames(){	return numFrames;	};
+
+	/**
+	 * @fn	const ViewState& InputRecorder::getViewState()
+	 *
+	 * @brief	Gets the window state at the start of the recording
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The view state.
+	 */
+	const ViewState& getViewState(){	return viewState;	};
+
+protected:
+
+	/**
+	 * @summary	The recorded events, in the order they arrived
+	 */
+	vector<InputEvent> events;
+
+	/**
+	 * @summary	The window state at the start of the recording
+	 */
+	ViewState viewState;
+
+	/**
+	 * @summary	The number of frames the recording covers
+	 */
+	unsigned int numFrames;
+
+	/**
+	 * @summary	The frame recording started in. Events are stored relative to it
+	 */
+	unsigned int firstFrame;
+
+	/**
+	 * @summary	The next event to replay
+	 */
+	unsigned int replayIndex;
+
+	/**
+	 * @summary	Times the events while recording
+	 */
+	CStopWatch stopWatch;
+
+	bool recording;
+	bool replaying;
+};
@@ -0,0 +1,214 @@
+#include "StdAfx.h"
+#include "JobSystem.h"
+#include <stdio.h>
+#include <limits.h>
+
+/**
+ * @fn	JobSystem::JobSystem(int numThreads)
+ *
+ * @brief	Constructor. Starts the worker threads
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	numThreads	The number of worker threads. Zero uses one per core, less one for the calling thread
+ */
+JobSystem::JobSystem(int numThreads)
+{
+	SYSTEM_INFO sysInfo;
+
+	if(numThreads <= 0){
+		GetSystemInfo(&sysInfo);
+		numThreads = (int)sysInfo.dwNumberOfProcessors - 1;
+		if(numThreads < 1)
+			numThreads = 1;
+	}
+
+	quit = 0;
+	wakeSemaphore = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+
+	for(int i = 0; i < numThreads; ++i){
+		Worker *w = new Worker;
+		w->pool = this;
+		w->index = i;
+		InitializeCriticalSection(&w->lock);
+		workers.push_back(w);
+	}
+
+	// start the threads only once every queue exists, since they steal from each other
+	for(unsigned int i = 0; i < workers.size(); ++i){
+		workers[i]->thread = CreateThread(NULL, 0, workerProc, workers[i], 0, NULL);
+		if(workers[i]->thread == NULL)
+			fprintf(stderr, "JobSystem::JobSystem() CreateThread failed: %d\n", GetLastError());
+	}
+}
+
+JobSystem::~JobSystem(void)
+{
+	InterlockedExchange(&quit, 1);
+	ReleaseSemaphore(wakeSemaphore, (LONG)workers.size(), NULL);
+
+	for(unsigned int i = 0; i < workers.size(); ++i){
+		if(workers[i]->thread != NULL){
+			WaitForSingleObject(workers[i]->thread, INFINITE);
+			CloseHandle(workers[i]->thread);
+		}
+	}
+	for(unsigned int i = 0; i < workers.size(); ++i){
+		DeleteCriticalSection(&workers[i]->lock);
+		delete workers[i];
+	}
+	CloseHandle(wakeSemaphore);
+}
+
+/**
+ * @fn	void JobSystem::parallelFor(int count, int grainSize, JobFunction func, void *data)
+ *
+ * @brief	Splits [0, count) into chunks, deals them out across the worker queues, and then works on
+ * 			them from this thread too until they are all finished.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	count	 	The number of items.
+ * @param	grainSize	The minimum number of items per chunk.
+ * @param	func	 	The function to run on each chunk.
+ * @param [in,out]	data	Passed through to func.
+ */
+void JobSystem::parallelFor(int count, int grainSize, JobFunction func, void *data){
+	volatile LONG remaining;
+	int numWorkers = (int)workers.size();
+	int numChunks, chunkSize;
+	Job job;
+
+	if(count <= 0)
+		return;
+
+	// a few chunks per thread, so that there is something left to steal when the split is uneven
+	if(grainSize < 1)
+		grainSize = 1;
+	chunkSize = count/((numWorkers + 1)*4);
+	if(chunkSize < grainSize)
+		chunkSize = grainSize;
+	numChunks = (count + chunkSize - 1)/chunkSize;
+
+	if(numChunks == 1 || numWorkers == 0){
+		func(data, 0, count);
+		return;
+	}
+
+	remaining = numChunks;
+	job.func = func;
+	job.data = data;
+	job.remaining = &remaining;
+
+	for(int i = 0; i < numChunks; ++i){
+		Worker *w = workers[i % numWorkers];
+		job.begin = i*chunkSize;
+		job.end = min(job.begin + chunkSize, count);
+		EnterCriticalSection(&w->lock);
+		w->jobs.push_back(job);
+		LeaveCriticalSection(&w->lock);
+	}
+	ReleaseSemaphore(wakeSemaphore, min(numChunks, numWorkers), NULL);
+
+	// help out, then wait for any chunks that are still running on the workers
+	while(remaining > 0){
+		if(findJob(-1, job))
+			runJob(job);
+		else
+			SwitchToThread();
+	}
+}
+
+/**
+ * @fn	DWORD WINAPI JobSystem::workerProc(LPVOID data)
+ *
+ * @brief	The worker thread's loop: sleep until woken, then run jobs until there are none left anywhere
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	data	pointer to the Worker
+ *
+ * @return	0 when the thread exits
+ */
+DWORD WINAPI JobSystem::workerProc(LPVOID data){
+	Worker *self = (Worker*)data;
+	JobSystem *pool = self->pool;
+	Job job;
+
+	while(true){
+		WaitForSingleObject(pool->wakeSemaphore, INFINITE);
+		if(pool->quit != 0)
+			break;
+
+		while(pool->findJob(self->index, job))
+			runJob(job);
+	}
+	return 0;
+}
+
+/**
+ * @fn	bool JobSystem::findJob(int self, Job &job)
+ *
+ * @brief	Takes a job from the back of queue 'self' (the most recently queued, so likely still in
+ * 			cache), or steals the oldest job from another queue
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	self	 	The caller's queue, or -1 for a thread outside the pool.
+ * @param [in,out]	job	The job.
+ *
+ * @return	false if every queue is empty.
+ */
+bool JobSystem::findJob(int self, Job &job){
+	int numWorkers = (int)workers.size();
+	bool found = false;
+
+	if(self >= 0){
+		Worker *w = workers[self];
+		EnterCriticalSection(&w->lock);
+		if(!w->jobs.empty()){
+			job = w->jobs.back();
+			w->jobs.pop_back();
+			found = true;
+		}
+		LeaveCriticalSection(&w->lock);
+		if(found)
+			return true;
+	}
+
+	for(int i = 1; i <= numWorkers; ++i){
+		Worker *victim = workers[(self + i + numWorkers) % numWorkers];
+		if(victim->index == self)
+			continue;
+
+		EnterCriticalSection(&victim->lock);
+		if(!victim->jobs.empty()){
+			job = victim->jobs.front();
+			victim->jobs.pop_front();
+			found = true;
+		}
+		LeaveCriticalSection(&victim->lock);
+		if(found)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @fn	void JobSystem::runJob(Job &job)
+ *
+ * @brief	Runs a job and counts it off
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	job	The job.
+ */
+void JobSystem::runJob(Job &job){
+	job.func(job.data, job.begin, job.end);
+	InterlockedDecrement(job.remaining);
+}
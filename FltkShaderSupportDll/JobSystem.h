@@ -0,0 +1,169 @@
+#pragma once
+
+#include <windows.h>
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class	JobSystem
+ *
+ * @brief	A small work-stealing thread pool. Each worker thread has its own queue of jobs; a worker takes
+ * 			jobs from the back of its own queue and, when that runs dry, steals from the front of the
+ * 			other workers' queues, so an uneven split of work evens itself out. The thread that calls
+ * 			parallelFor() works (and steals) alongside the pool until the whole range is done.
+ *
+ * 			The queues are short and only touched once per chunk, so each one is guarded by a
+ * 			CRITICAL_SECTION rather than being lock-free.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class JobSystem
+{
+public:
+
+	/**
+	 * @brief	A function that processes the items [begin, end) of a parallelFor()
+	 */
+	typedef void (*JobFunction)(void *data, int begin, int end);
+
+	/**
+	 * @fn	JobSystem::JobSystem(int numThreads = 0);
+	 *
+	 * @brief	Constructor. Starts the worker threads
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	numThreads	The number of worker threads. Zero uses one per core, less one for the calling thread
+	 */
+	JobSystem(int numThreads = 0);
+
+	/**
+	 * @fn	JobSystem::~JobSystem(void);
+	 *
+	 * @brief	Destructor. Stops and waits for the worker threads
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~JobSystem(void);
+
+	/**
+	 * @fn	void JobSystem::parallelFor(int count, int grainSize, JobFunction func, void *data);
+	 *
+	 * @brief	Splits [0, count) into chunks of about grainSize items, runs func on each chunk across the
+	 * 			pool and returns once every chunk has finished. Not reentrant: func must not call
+	 * 			parallelFor() itself.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	count	 	The number of items.
+	 * @param	grainSize	The minimum number of items per chunk.
+	 * @param	func	 	The function to run on each chunk.
+	 * @param [in,out]	data	Passed through to func.
+	 */
+	void parallelFor(int count, int grainSize, JobFunction func, void *data);
+
+	/**
+	 * @fn	int JobSystem::getNumThreads()
+	 *
+	 * @brief	Gets the number of worker threads.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of worker threads.
+	 */
+	int getNumThreads(){	return (int)workers.size();	};
+
+protected:
+
+	/**
+	 * @struct	Job
+	 *
+	 * @brief	One chunk of a parallelFor()
+	 */
+	struct Job
+	{
+		JobFunction		func;
+		void			*data;
+		int				begin;
+		int				end;
+		volatile LONG	*remaining;
+	};
+
+	/**
+	 * @struct	Worker
+	 *
+	 * @brief	A worker thread and its queue
+	 */
+	struct Worker
+	{
+		JobSystem			*pool;
+		int					index;
+		HANDLE				thread;
+		deque<Job>			jobs;
+		CRITICAL_SECTION	lock;
+	};
+
+	/**
+	 * @fn	static DWORD WINAPI JobSystem::workerProc(LPVOID data);
+	 *
+	 * @brief	The worker thread's loop
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	data	pointer to the Worker
+	 *
+	 * @return	0 when the thread exits
+	 */
+	static DWORD WINAPI workerProc(LPVOID data);
+
+	/**
+	 * @fn	bool JobSystem::findJob(int self, Job &job);
+	 *
+	 * @brief	Takes a job from the back of queue 'self', or steals one from the front of another queue
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	self	 	The caller's queue, or -1 for a thread outside the pool.
+	 * @param [in,out]	job	The job.
+	 *
+	 * @return	false if every queue is empty.
+	 */
+	bool findJob(int self, Job &job);
+
+	/**
+	 * @fn	static void JobSystem::runJob(Job &job);
+	 *
+	 * @brief	Runs a job and counts it off
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	job	The job.
+	 */
+	static void runJob(Job &job);
+
+	/**
+	 * @summary	The workers. Allocated individually so that their CRITICAL_SECTIONs never move
+	 */
+	vector<Worker*> workers;
+
+	/**
+	 * @summary	Signalled once for every job queued, to wake sleeping workers
+	 */
+	HANDLE wakeSemaphore;
+
+	/**
+	 * @summary	Set to non-zero to ask the workers to exit
+	 */
+	volatile LONG quit;
+};
@@ -0,0 +1,105 @@
+#include "StdAfx.h"
+#include "LodChain.h"
+#include <float.h>
+
+/**
+ * @fn	LodChain::LodChain(float hysteresis)
+ *
+ * @brief	Constructor.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	hysteresis	The hysteresis fraction.
+ */
+LodChain::LodChain(float hysteresis)
+{
+	this->hysteresis = hysteresis;
+}
+
+LodChain::~LodChain(void)
+{
+}
+
+/**
+ * @fn	void LodChain::addLevel(GLBatchBase *batch, float minPixels)
+ *
+ * @brief	Adds the next coarser level.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	batch	The mesh.
+ * @param	minPixels	 	The smallest size on screen that this level is for.
+ */
+void LodChain::addLevel(GLBatchBase *batch, float minPixels){
+	Level level = {batch, minPixels};
+	levels.push_back(level);
+}
+
+/**
+ * @fn	int LodChain::selectLevel(float pixels, int current)
+ *
+ * @brief	Steps coarser while the object is clearly below the current level's threshold, then finer
+ * 			while it is clearly above the next finer one's. Between the two bands nothing changes
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	pixels 	The object's size on screen.
+ * @param	current	The level it was drawn at last time.
+ *
+ * @return	The level to draw it at now.
+ */
+int LodChain::selectLevel(float pixels, int current){
+	int last = (int)levels.size() - 1;
+
+	if(last < 0)
+		return 0;
+	if(current < 0)
+		current = 0;
+	if(current > last)
+		current = last;
+
+	while(current < last && pixels < levels[current].minPixels*(1.0f - hysteresis))
+		++current;
+	while(current > 0 && pixels >= levels[current - 1].minPixels*(1.0f + hysteresis))
+		--current;
+	return current;
+}
+
+/**
+ * @fn	float LodChain::projectedSize(float radius, const M3DMatrix44f modelView,
+ * 		const M3DMatrix44f projection, int viewportHeight)
+ *
+ * @brief	A sphere of radius r at distance d covers 2r/d of the view in the y direction, scaled by
+ * 			projection[5] (the cotangent of half the field of view), and the view is 2 units of
+ * 			normalized device coordinates for viewportHeight pixels
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	radius		  	The radius, in model units.
+ * @param	modelView	  	The model view matrix.
+ * @param	projection	  	The projection matrix.
+ * @param	viewportHeight	The height of the viewport.
+ *
+ * @return	The diameter in pixels.
+ */
+float LodChain::projectedSize(float radius, const M3DMatrix44f modelView, const M3DMatrix44f projection, int viewportHeight){
+	// the largest column of the upper 3x3 is the largest scale along any axis
+	float scaleSq = m3dGetVectorLengthSquared3(&modelView[0]);
+	float colSq = m3dGetVectorLengthSquared3(&modelView[4]);
+	if(colSq > scaleSq)
+		scaleSq = colSq;
+	colSq = m3dGetVectorLengthSquared3(&modelView[8]);
+	if(colSq > scaleSq)
+		scaleSq = colSq;
+
+	float eyeRadius = radius*sqrt(scaleSq);
+	float depth = -modelView[14]; // the eye looks down -z
+
+	if(depth <= eyeRadius)
+		return FLT_MAX;
+	return eyeRadius*projection[5]*viewportHeight/depth;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <GLBatchBase.h>
+#include <math3d.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class	LodChain
+ *
+ * @brief	A set of meshes for one object at decreasing levels of detail, with the smallest projected
+ * 			size (in pixels across the screen) that each is meant for. Level 0 is the finest. Any
+ * 			GLBatchBase will do, so GLTriangleBatch and GLBatch levels can be mixed.
+ *
+ * 			A level only changes once the size has moved a hysteresis fraction past its threshold, so
+ * 			an object sitting right at a threshold doesn't flip between meshes every frame. The chain
+ * 			holds no per-object state; each object keeps its own current level (see
+ * 			DrawableObject::selectLod()), so one chain can be shared by many objects.
+ *
+ * 			The chain doesn't own the meshes.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class LodChain
+{
+public:
+
+	/**
+	 * @fn	LodChain::LodChain(float hysteresis = 0.15f);
+	 *
+	 * @brief	Constructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	hysteresis	How far past a threshold, as a fraction of it, the size has to go before
+	 * 						the level changes.
+	 */
+	LodChain(float hysteresis = 0.15f);
+
+	/**
+	 * @fn	LodChain::~LodChain(void);
+	 *
+	 * @brief	Destructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~LodChain(void);
+
+	/**
+	 * @fn	void LodChain::addLevel(GLBatchBase *batch, float minPixels);
+	 *
+	 * @brief	Adds the next coarser level. Add them finest first, with falling thresholds; the last
+	 * 			one is used for anything smaller, whatever its threshold
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	batch	The mesh.
+	 * @param	minPixels	 	The smallest size on screen, in pixels, that this level is for.
+	 */
+	void addLevel(GLBatchBase *batch, float minPixels);
+
+	/**
+	 * @fn	int LodChain::getNumLevels()
+	 *
+	 * @brief	Gets the number of levels.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of levels.
+	 */
+	int getNumLevels(){	return (int)levels.size();	};
+
+	/**
+	 * @fn	GLBatchBase* LodChain::getBatch(int level)
+	 *
+	 * @brief	Gets the mesh for a level.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	level	The level.
+	 *
+	 * @return	The mesh, or NULL if there is no such level.
+	 */
+	GLBatchBase* getBatch(int level){
+		if(level < 0 || level >= (int)levels.size())
+			return NULL;
+		return levels[level].batch;
+	};
+
+	/**
+	 * @fn	int LodChain::selectLevel(float pixels, int current);
+	 *
+	 * @brief	Picks the level for an object of a given size on screen.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	pixels 	The object's size on screen (e.g. from projectedSize()).
+	 * @param	current	The level the object was drawn at last time.
+	 *
+	 * @return	The level to draw it at now.
+	 */
+	int selectLevel(float pixels, int current);
+
+	/**
+	 * @fn	static float LodChain::projectedSize(float radius, const M3DMatrix44f modelView,
+	 * 		const M3DMatrix44f projection, int viewportHeight);
+	 *
+	 * @brief	Estimates how many pixels tall a bounding sphere centered on the model's origin is on
+	 * 			screen, for a perspective projection. Any scale in modelView is applied to the radius
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	radius		  	The radius, in model units.
+	 * @param	modelView	  	The model view matrix, with the object's own transform applied.
+	 * @param	projection	  	The projection matrix.
+	 * @param	viewportHeight	The height of the viewport in pixels.
+	 *
+	 * @return	The diameter in pixels, or FLT_MAX if the eye is inside the sphere.
+	 */
+	static float projectedSize(float radius, const M3DMatrix44f modelView, const M3DMatrix44f projection, int viewportHeight);
+
+protected:
+
+	/**
+	 * @struct	Level
+	 *
+	 * @brief	A mesh and the smallest projected size it is used for
+	 */
+	struct Level
+	{
+		GLBatchBase *batch;
+		float minPixels;
+	};
+
+	/**
+	 * @summary	The levels, finest first
+	 */
+	vector<Level> levels;
+
+	/**
+	 * @summary	The fraction a size has to pass a threshold by before the level changes
+	 */
+	float hysteresis;
+};
@@ -0,0 +1,734 @@
+#include "StdAfx.h"
+#include "MeshSimplifier.h"
+#include <algorithm>
+
+// how much more the edges of seams and holes weigh than the faces around them
+static const double BOUNDARY_WEIGHT = 10.0;
+
+// how close two values must be to weld, as GLTriangleBatch::AddTriangle() uses
+static const float WELD_EPSILON = 0.00001f;
+
+/**
+ * @struct	XLess
+ *
+ * @brief	Orders vertex indexes by x, so that vertices that might weld sort close together
+ */
+struct XLess
+{
+	const vector<MeshSimplifier::Vertex> *verts;
+	bool operator()(int a, int b) const {	return (*verts)[a].pos[0] < (*verts)[b].pos[0];	};
+};
+
+/**
+ * @fn	MeshSimplifier::MeshSimplifier(void)
+ *
+ * @brief	Constructor.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+MeshSimplifier::MeshSimplifier(void)
+{
+	welded = false;
+	liveTriangles = 0;
+}
+
+MeshSimplifier::~MeshSimplifier(void)
+{
+}
+
+/**
+ * @fn	void MeshSimplifier::clear()
+ *
+ * @brief	Throws away the mesh.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void MeshSimplifier::clear(){
+	corners.clear();
+	vertices.clear();
+	vertexPos.clear();
+	positions.clear();
+	sourceIndexes.clear();
+	indexes.clear();
+	quadrics.clear();
+	welded = false;
+	liveTriangles = 0;
+}
+
+/**
+ * @fn	void MeshSimplifier::addTriangle(M3DVector3f verts[3], M3DVector3f norms[3],
+ * 		M3DVector2f texCoords[3])
+ *
+ * @brief	Adds a triangle. Welding waits until the mesh is first used
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	verts	 	The positions.
+ * @param	norms	 	The normals.
+ * @param	texCoords	The texture coordinates.
+ */
+void MeshSimplifier::addTriangle(M3DVector3f verts[3], M3DVector3f norms[3], M3DVector2f texCoords[3]){
+	for(int i = 0; i < 3; ++i){
+		Vertex v;
+		m3dCopyVector3(v.pos, verts[i]);
+		m3dCopyVector3(v.norm, norms[i]);
+		v.tex[0] = texCoords[i][0];
+		v.tex[1] = texCoords[i][1];
+		corners.push_back(v);
+	}
+	welded = false;
+}
+
+/**
+ * @fn	void MeshSimplifier::setMesh(const M3DVector3f *verts, const M3DVector3f *norms,
+ * 		const M3DVector2f *texCoords, int numVerts, const GLushort *indexes, int numIndexes)
+ *
+ * @brief	Replaces the mesh with an indexed triangle list.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	verts	  	The positions.
+ * @param	norms	  	The normals.
+ * @param	texCoords 	The texture coordinates.
+ * @param	numVerts  	The number of vertices.
+ * @param	indexes   	Three indexes per triangle.
+ * @param	numIndexes	The number of indexes.
+ */
+void MeshSimplifier::setMesh(const M3DVector3f *verts, const M3DVector3f *norms, const M3DVector2f *texCoords, int numVerts, const GLushort *indexes, int numIndexes){
+	clear();
+	corners.reserve(numIndexes - numIndexes%3);
+	for(int i = 0; i + 2 < numIndexes; i += 3){
+		if(indexes[i] >= numVerts || indexes[i + 1] >= numVerts || indexes[i + 2] >= numVerts){
+			fprintf(stderr, "MeshSimplifier::setMesh() triangle %d indexes past vertex %d\n", i/3, numVerts);
+			continue;
+		}
+		for(int k = 0; k < 3; ++k){
+			Vertex v;
+			int index = indexes[i + k];
+			m3dCopyVector3(v.pos, verts[index]);
+			m3dCopyVector3(v.norm, norms[index]);
+			v.tex[0] = texCoords[index][0];
+			v.tex[1] = texCoords[index][1];
+			corners.push_back(v);
+		}
+	}
+}
+
+/**
+ * @fn	void MeshSimplifier::weld()
+ *
+ * @brief	Merges the corners into vertices where position, normal and texture coordinate all match,
+ * 			and groups the vertices by position. Triangles with two corners at the same position are
+ * 			dropped
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void MeshSimplifier::weld(){
+	if(welded)
+		return;
+
+	int numCorners = (int)corners.size();
+	vector<int> cornerVertex;
+
+	weldClose(corners, 8, vertices, cornerVertex);
+	weldClose(vertices, 3, positions, vertexPos);
+
+	sourceIndexes.clear();
+	for(int i = 0; i + 2 < numCorners; i += 3){
+		int p0 = vertexPos[cornerVertex[i]];
+		int p1 = vertexPos[cornerVertex[i + 1]];
+		int p2 = vertexPos[cornerVertex[i + 2]];
+		if(p0 == p1 || p1 == p2 || p2 == p0)
+			continue;
+		sourceIndexes.push_back(cornerVertex[i]);
+		sourceIndexes.push_back(cornerVertex[i + 1]);
+		sourceIndexes.push_back(cornerVertex[i + 2]);
+	}
+
+	welded = true;
+	reset();
+}
+
+/**
+ * @fn	void MeshSimplifier::weldClose(const vector<Vertex> &in, int numFloats, vector<Vertex> &out,
+ * 		vector<int> &remap)
+ *
+ * @brief	Merges vertices whose first 'numFloats' values (3 for the position, 8 for the whole vertex)
+ * 			are all within WELD_EPSILON of the first of them. Sorting by x first means only a narrow
+ * 			run of vertices has to be compared
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	in		 	The vertices.
+ * @param	numFloats	The number of values to compare.
+ * @param [out]	out  	One vertex for each group.
+ * @param [out]	remap	The group of each vertex in 'in'.
+ */
+void MeshSimplifier::weldClose(const vector<Vertex> &in, int numFloats, vector<Vertex> &out, vector<int> &remap){
+	int n = (int)in.size();
+	vector<int> order(n);
+	XLess less;
+
+	for(int i = 0; i < n; ++i)
+		order[i] = i;
+	less.verts = &in;
+	sort(order.begin(), order.end(), less);
+
+	out.clear();
+	remap.assign(n, -1);
+	for(int i = 0; i < n; ++i){
+		if(remap[order[i]] >= 0)
+			continue;
+
+		const float *vi = in[order[i]].pos; // pos, norm and tex are packed one after another
+		int group = (int)out.size();
+		out.push_back(in[order[i]]);
+		remap[order[i]] = group;
+
+		for(int j = i + 1; j < n && in[order[j]].pos[0] - vi[0] <= WELD_EPSILON; ++j){
+			if(remap[order[j]] >= 0)
+				continue;
+
+			const float *vj = in[order[j]].pos;
+			int k = 1;
+			while(k < numFloats && m3dCloseEnough(vi[k], vj[k], WELD_EPSILON))
+				++k;
+			if(k == numFloats)
+				remap[order[j]] = group;
+		}
+	}
+}
+
+/**
+ * @fn	void MeshSimplifier::reset()
+ *
+ * @brief	Goes back to the welded mesh and its original quadrics
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void MeshSimplifier::reset(){
+	if(!welded){
+		weld(); // which resets
+		return;
+	}
+	indexes = sourceIndexes;
+	liveTriangles = (int)indexes.size()/3;
+	buildQuadrics();
+}
+
+/**
+ * @fn	int MeshSimplifier::getNumTriangles()
+ *
+ * @brief	Gets the number of triangles as of the last simplify().
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The number of triangles.
+ */
+int MeshSimplifier::getNumTriangles(){
+	weld();
+	return liveTriangles;
+}
+
+/**
+ * @fn	void MeshSimplifier::collectEdges(vector<Edge> &edges)
+ *
+ * @brief	Lists the three edges of each triangle in 'indexes', sorted so that the sides of an edge
+ * 			from different triangles are next to each other
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [out]	edges	The edges.
+ */
+void MeshSimplifier::collectEdges(vector<Edge> &edges){
+	int numTris = (int)indexes.size()/3;
+
+	edges.clear();
+	edges.reserve(numTris*3);
+	for(int t = 0; t < numTris; ++t){
+		for(int k = 0; k < 3; ++k){
+			int v1 = indexes[t*3 + k];
+			int v2 = indexes[t*3 + (k + 1)%3];
+			Edge e;
+
+			if(vertexPos[v1] < vertexPos[v2]){
+				e.vertA = v1;
+				e.vertB = v2;
+			}else{
+				e.vertA = v2;
+				e.vertB = v1;
+			}
+			e.posA = vertexPos[e.vertA];
+			e.posB = vertexPos[e.vertB];
+			e.tri = t;
+			edges.push_back(e);
+		}
+	}
+	sort(edges.begin(), edges.end());
+}
+
+/**
+ * @fn	void MeshSimplifier::addPlane(Quadric &q, const M3DVector3f normal, float d, double weight)
+ *
+ * @brief	Adds the squared distance to the plane normal.p + d = 0 to a quadric
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	q	The quadric.
+ * @param	normal   	The unit normal of the plane.
+ * @param	d		 	The plane's distance term.
+ * @param	weight   	How much the plane counts.
+ */
+void MeshSimplifier::addPlane(Quadric &q, const M3DVector3f normal, float d, double weight){
+	double a = normal[0];
+	double b = normal[1];
+	double c = normal[2];
+
+	q.a2 += weight*a*a;	q.ab += weight*a*b;	q.ac += weight*a*c;	q.ad += weight*a*d;
+	q.b2 += weight*b*b;	q.bc += weight*b*c;	q.bd += weight*b*d;
+	q.c2 += weight*c*c;	q.cd += weight*c*d;
+	q.d2 += weight*d*d;
+}
+
+/**
+ * @fn	double MeshSimplifier::evaluate(const Quadric &q, const M3DVector3f p)
+ *
+ * @brief	Gets the error of a quadric at a point
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	q	The quadric.
+ * @param	p	The point.
+ *
+ * @return	The weighted sum of squared distances from the point to the quadric's planes.
+ */
+double MeshSimplifier::evaluate(const Quadric &q, const M3DVector3f p){
+	double x = p[0];
+	double y = p[1];
+	double z = p[2];
+	double err = q.a2*x*x + 2.0*q.ab*x*y + 2.0*q.ac*x*z + 2.0*q.ad*x
+				+ q.b2*y*y + 2.0*q.bc*y*z + 2.0*q.bd*y
+				+ q.c2*z*z + 2.0*q.cd*z
+				+ q.d2;
+
+	return err > 0.0 ? err : 0.0; // rounding can take a perfect fit just under zero
+}
+
+/**
+ * @fn	void MeshSimplifier::buildQuadrics()
+ *
+ * @brief	Gives each position the planes of its triangles, weighted by area. Each edge of a hole or a
+ * 			seam also adds a plane through the edge at right angles to its triangle to both of its
+ * 			ends, which holds the edge in place
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void MeshSimplifier::buildQuadrics(){
+	Quadric zero = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	int numTris = (int)indexes.size()/3;
+	vector<Edge> edges;
+	vector<Vertex> normals(numTris);	// only pos is used, as the unit normal of each triangle
+
+	quadrics.assign(positions.size(), zero);
+	for(int t = 0; t < numTris; ++t){
+		const float *p0 = positions[vertexPos[indexes[t*3]]].pos;
+		const float *p1 = positions[vertexPos[indexes[t*3 + 1]]].pos;
+		const float *p2 = positions[vertexPos[indexes[t*3 + 2]]].pos;
+		M3DVector3f e1, e2;
+		float *n = normals[t].pos;
+
+		m3dSubtractVectors3(e1, p1, p0);
+		m3dSubtractVectors3(e2, p2, p0);
+		m3dCrossProduct3(n, e1, e2);
+
+		float len = m3dGetVectorLength3(n);
+		if(len <= 0.0f)
+			continue;
+		m3dScaleVector3(n, 1.0f/len);
+
+		float d = -m3dDotProduct3(n, p0);
+		for(int k = 0; k < 3; ++k)
+			addPlane(quadrics[vertexPos[indexes[t*3 + k]]], n, d, len*0.5);
+	}
+
+	collectEdges(edges);
+	for(size_t i = 0; i < edges.size(); ){
+		size_t end = i + 1;
+		while(end < edges.size() && edges[end].posA == edges[i].posA && edges[end].posB == edges[i].posB)
+			++end;
+
+		bool boundary = (end - i == 1) ||
+			(end - i == 2 && (edges[i].vertA != edges[i + 1].vertA || edges[i].vertB != edges[i + 1].vertB));
+
+		for(; boundary && i < end; ++i){
+			const float *pa = positions[edges[i].posA].pos;
+			const float *pb = positions[edges[i].posB].pos;
+			M3DVector3f dir, n;
+
+			m3dSubtractVectors3(dir, pb, pa);
+			m3dCrossProduct3(n, dir, normals[edges[i].tri].pos);
+
+			float len = m3dGetVectorLength3(n);
+			if(len <= 0.0f)
+				continue;
+			m3dScaleVector3(n, 1.0f/len);
+
+			float d = -m3dDotProduct3(n, pa);
+			double weight = m3dGetVectorLengthSquared3(dir)*BOUNDARY_WEIGHT;
+			addPlane(quadrics[edges[i].posA], n, d, weight);
+			addPlane(quadrics[edges[i].posB], n, d, weight);
+		}
+		i = end;
+	}
+}
+
+/**
+ * @fn	void MeshSimplifier::buildAdjacency()
+ *
+ * @brief	Lists the triangles around each position
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void MeshSimplifier::buildAdjacency(){
+	int numPos = (int)positions.size();
+	int numTris = (int)indexes.size()/3;
+
+	adjacencyStart.assign(numPos + 1, 0);
+	for(size_t i = 0; i < indexes.size(); ++i)
+		++adjacencyStart[vertexPos[indexes[i]] + 1];
+	for(int p = 0; p < numPos; ++p)
+		adjacencyStart[p + 1] += adjacencyStart[p];
+
+	vector<int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+	adjacency.resize(indexes.size());
+	for(int t = 0; t < numTris; ++t){
+		for(int k = 0; k < 3; ++k)
+			adjacency[fill[vertexPos[indexes[t*3 + k]]]++] = t;
+	}
+}
+
+/**
+ * @fn	int MeshSimplifier::simplify(int targetTriangles)
+ *
+ * @brief	Works in passes. Each pass costs every edge, then collapses them cheapest first, skipping
+ * 			any that touch a triangle that has already changed in this pass. The triangles are then
+ * 			rebuilt and the next pass costs the edges again
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	targetTriangles	The number of triangles to get down to.
+ *
+ * @return	The number of triangles left.
+ */
+int MeshSimplifier::simplify(int targetTriangles){
+	vector<Edge> edges;
+	vector<Collapse> collapses;
+
+	weld();
+	while(liveTriangles > targetTriangles){
+		int numPos = (int)positions.size();
+
+		buildAdjacency();
+		collectEdges(edges);
+
+		// a position on a hole's edge only moves along that edge; one on an edge with three or more
+		// triangles doesn't move at all
+		border.assign(numPos, 0);
+		locked.assign(numPos, 0);
+		for(size_t i = 0; i < edges.size(); ){
+			size_t end = i + 1;
+			while(end < edges.size() && edges[end].posA == edges[i].posA && edges[end].posB == edges[i].posB)
+				++end;
+			if(end - i == 1){
+				border[edges[i].posA] = 1;
+				border[edges[i].posB] = 1;
+			}else if(end - i > 2){
+				locked[edges[i].posA] = 1;
+				locked[edges[i].posB] = 1;
+			}
+			i = end;
+		}
+
+		collapses.clear();
+		for(size_t i = 0; i < edges.size(); ){
+			size_t end = i + 1;
+			while(end < edges.size() && edges[end].posA == edges[i].posA && edges[end].posB == edges[i].posB)
+				++end;
+
+			int a = edges[i].posA;
+			int b = edges[i].posB;
+			bool borderEdge = (end - i == 1);
+			Collapse best = {-1, -1, 0.0};
+
+			for(int dir = 0; dir < 2; ++dir){
+				int from = dir == 0 ? a : b;
+				int to = dir == 0 ? b : a;
+				if(locked[from] || (border[from] && !borderEdge))
+					continue;
+
+				double cost = evaluate(quadrics[from], positions[to].pos) + evaluate(quadrics[to], positions[to].pos);
+				if(best.from < 0 || cost < best.cost){
+					best.from = from;
+					best.to = to;
+					best.cost = cost;
+				}
+			}
+			if(best.from >= 0)
+				collapses.push_back(best);
+			i = end;
+		}
+		sort(collapses.begin(), collapses.end());
+
+		int numVerts = (int)vertices.size();
+		int collapsed = 0;
+
+		vertexRemap.resize(numVerts);
+		for(int v = 0; v < numVerts; ++v)
+			vertexRemap[v] = v;
+		touched.assign(numPos, 0);
+
+		for(size_t i = 0; i < collapses.size() && liveTriangles > targetTriangles; ++i){
+			if(touched[collapses[i].from] || touched[collapses[i].to])
+				continue;
+			if(tryCollapse(collapses[i].from, collapses[i].to))
+				++collapsed;
+		}
+		if(collapsed == 0)
+			break;
+
+		// rebuild the triangles, dropping the ones that collapsed to a line
+		size_t out = 0;
+		for(size_t i = 0; i + 2 < indexes.size(); i += 3){
+			int v0 = vertexRemap[indexes[i]];
+			int v1 = vertexRemap[indexes[i + 1]];
+			int v2 = vertexRemap[indexes[i + 2]];
+			if(vertexPos[v0] == vertexPos[v1] || vertexPos[v1] == vertexPos[v2] || vertexPos[v2] == vertexPos[v0])
+				continue;
+			indexes[out++] = v0;
+			indexes[out++] = v1;
+			indexes[out++] = v2;
+		}
+		indexes.resize(out);
+		liveTriangles = (int)out/3;
+	}
+	return liveTriangles;
+}
+
+/**
+ * @fn	bool MeshSimplifier::tryCollapse(int from, int to)
+ *
+ * @brief	Moves position 'from' onto position 'to' if that keeps the mesh sound. Each vertex at
+ * 			'from' has to share a triangle with exactly one vertex at 'to' and becomes that vertex,
+ * 			which is what stops a collapse across a seam. The two positions may share no neighbors
+ * 			other than the third corners of the triangles along the edge, or the collapse would fold
+ * 			the surface, and no triangle left may turn over or face away from its vertex normals.
+ *
+ * 			Neither position has been touched this pass, so their triangles in 'indexes' and
+ * 			'adjacency' are still current.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	from	The position that goes.
+ * @param	to  	The position it goes to.
+ *
+ * @return	true if it collapsed.
+ */
+bool MeshSimplifier::tryCollapse(int from, int to){
+	vector<int> fromVerts;
+	vector<int> toVerts;	// what each of fromVerts becomes, or -1
+	vector<int> fromNeighbors;
+	int edgeTris = 0;
+
+	for(int i = adjacencyStart[from]; i < adjacencyStart[from + 1]; ++i){
+		const int *tri = &indexes[adjacency[i]*3];
+		int kFrom = -1;
+		int kTo = -1;
+
+		for(int k = 0; k < 3; ++k){
+			int p = vertexPos[tri[k]];
+			if(p == from)
+				kFrom = k;
+			else if(p == to)
+				kTo = k;
+			else
+				fromNeighbors.push_back(p);
+		}
+
+		size_t j = find(fromVerts.begin(), fromVerts.end(), tri[kFrom]) - fromVerts.begin();
+		if(j == fromVerts.size()){
+			fromVerts.push_back(tri[kFrom]);
+			toVerts.push_back(-1);
+		}
+
+		if(kTo >= 0){
+			if(toVerts[j] >= 0 && toVerts[j] != tri[kTo])
+				return false; // the vertex at 'from' would have to split
+			toVerts[j] = tri[kTo];
+			++edgeTris;
+			continue;
+		}
+
+		// the triangle stays, so it mustn't turn over
+		M3DVector3f before, after, e1, e2;
+		const float *p[3];
+		for(int k = 0; k < 3; ++k)
+			p[k] = positions[vertexPos[tri[k]]].pos;
+
+		m3dSubtractVectors3(e1, p[1], p[0]);
+		m3dSubtractVectors3(e2, p[2], p[0]);
+		m3dCrossProduct3(before, e1, e2);
+
+		p[kFrom] = positions[to].pos;
+		m3dSubtractVectors3(e1, p[1], p[0]);
+		m3dSubtractVectors3(e2, p[2], p[0]);
+		m3dCrossProduct3(after, e1, e2);
+
+		if(m3dDotProduct3(before, after) <= 0.0f)
+			return false;
+
+		// nor, after a run of small turns, end up facing away from its vertex normals
+		M3DVector3f vertexNormals;
+		m3dCopyVector3(vertexNormals, vertices[tri[0]].norm);
+		m3dAddVectors3(vertexNormals, vertexNormals, vertices[tri[1]].norm);
+		m3dAddVectors3(vertexNormals, vertexNormals, vertices[tri[2]].norm);
+		if(m3dDotProduct3(after, vertexNormals) < 0.0f)
+			return false;
+	}
+
+	for(size_t j = 0; j < toVerts.size(); ++j){
+		if(toVerts[j] < 0)
+			return false; // it would cross a seam
+	}
+
+	sort(fromNeighbors.begin(), fromNeighbors.end());
+	fromNeighbors.erase(unique(fromNeighbors.begin(), fromNeighbors.end()), fromNeighbors.end());
+
+	vector<int> toNeighbors;
+	vector<int> shared;
+	for(int i = adjacencyStart[to]; i < adjacencyStart[to + 1]; ++i){
+		const int *tri = &indexes[adjacency[i]*3];
+		for(int k = 0; k < 3; ++k){
+			int p = vertexPos[tri[k]];
+			if(p == from || p == to)
+				continue;
+			toNeighbors.push_back(p);
+			if(binary_search(fromNeighbors.begin(), fromNeighbors.end(), p))
+				shared.push_back(p);
+		}
+	}
+	sort(toNeighbors.begin(), toNeighbors.end());
+	toNeighbors.erase(unique(toNeighbors.begin(), toNeighbors.end()), toNeighbors.end());
+	sort(shared.begin(), shared.end());
+	int numShared = (int)(unique(shared.begin(), shared.end()) - shared.begin());
+	if(numShared > edgeTris)
+		return false;
+
+	// 'to' has to keep enough neighbors to be part of a surface, which stops a closed mesh at a
+	// tetrahedron
+	int numNeighbors = (int)fromNeighbors.size() + (int)toNeighbors.size() - numShared;
+	if(numNeighbors < edgeTris + 1)
+		return false;
+
+	for(size_t j = 0; j < fromVerts.size(); ++j)
+		vertexRemap[fromVerts[j]] = toVerts[j];
+
+	Quadric &qFrom = quadrics[from];
+	Quadric &qTo = quadrics[to];
+	qTo.a2 += qFrom.a2;	qTo.ab += qFrom.ab;	qTo.ac += qFrom.ac;	qTo.ad += qFrom.ad;
+	qTo.b2 += qFrom.b2;	qTo.bc += qFrom.bc;	qTo.bd += qFrom.bd;
+	qTo.c2 += qFrom.c2;	qTo.cd += qFrom.cd;
+	qTo.d2 += qFrom.d2;
+
+	touched[from] = 1;
+	touched[to] = 1;
+	for(size_t i = 0; i < fromNeighbors.size(); ++i)
+		touched[fromNeighbors[i]] = 1;
+
+	liveTriangles -= edgeTris;
+	return true;
+}
+
+/**
+ * @fn	void MeshSimplifier::getMesh(vector<Vertex> &verts, vector<GLushort> &tris)
+ *
+ * @brief	Gets the current mesh, with the vertices renumbered in the order the triangles use them
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [out]	verts  	The vertices.
+ * @param [out]	tris   	Three indexes per triangle.
+ */
+void MeshSimplifier::getMesh(vector<Vertex> &verts, vector<GLushort> &tris){
+	weld();
+
+	vector<int> newIndex(vertices.size(), -1);
+
+	verts.clear();
+	tris.clear();
+	tris.reserve(indexes.size());
+	for(size_t i = 0; i < indexes.size(); ++i){
+		int v = indexes[i];
+		if(newIndex[v] < 0){
+			newIndex[v] = (int)verts.size();
+			verts.push_back(vertices[v]);
+		}
+		tris.push_back((GLushort)newIndex[v]);
+	}
+}
+
+/**
+ * @fn	bool MeshSimplifier::buildBatch(GLTriangleBatch &batch)
+ *
+ * @brief	Loads the current mesh into a GLTriangleBatch.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	batch	The batch.
+ *
+ * @return	false if the mesh has too many vertices.
+ */
+bool MeshSimplifier::buildBatch(GLTriangleBatch &batch){
+	vector<Vertex> verts;
+	vector<GLushort> tris;
+
+	getMesh(verts, tris);
+	if(verts.size() > 65536){
+		fprintf(stderr, "MeshSimplifier::buildBatch() %d vertices is too many for a GLTriangleBatch\n", (int)verts.size());
+		return false;
+	}
+
+	batch.BeginMesh((GLuint)tris.size());
+	for(size_t i = 0; i + 2 < tris.size(); i += 3){
+		M3DVector3f pos[3];
+		M3DVector3f norm[3];
+		M3DVector2f tex[3];
+
+		for(int k = 0; k < 3; ++k){
+			const Vertex &v = verts[tris[i + k]];
+			m3dCopyVector3(pos[k], v.pos);
+			m3dCopyVector3(norm[k], v.norm);
+			tex[k][0] = v.tex[0];
+			tex[k][1] = v.tex[1];
+		}
+		batch.AddTriangle(pos, norm, tex);
+	}
+	batch.End();
+	return true;
+}
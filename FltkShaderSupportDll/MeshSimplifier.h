@@ -0,0 +1,283 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <GLTriangleBatch.h>
+#include <math3d.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class	MeshSimplifier
+ *
+ * @brief	Makes lower level of detail versions of a triangle mesh by edge collapse, ordered by the
+ * 			quadric error metric (Garland and Heckbert, "Surface Simplification Using Quadric Error
+ * 			Metrics"). Feed it triangles the way a GLTriangleBatch is fed, or as indexed arrays, then
+ * 			call simplify() with falling triangle counts and buildBatch() after each one to get a chain
+ * 			of levels for a LodChain.
+ *
+ * 			Each collapse moves one vertex onto a neighbor (a half-edge collapse), so every vertex
+ * 			left is one of the originals with its own normal and texture coordinate, and nothing has to
+ * 			be interpolated. Vertices at the same position with different normals or texture
+ * 			coordinates (seams) only ever collapse along the seam, and the edges of seams and of holes
+ * 			in the mesh are weighted so that they keep their shape. A collapse that would turn a
+ * 			triangle over is skipped.
+ *
+ * 			Everything except buildBatch() is plain CPU work, so it can run on a worker thread at load
+ * 			time, or offline with getMesh().
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class MeshSimplifier
+{
+public:
+
+	/**
+	 * @struct	Vertex
+	 *
+	 * @brief	One vertex of the mesh, laid out the way GLTriangleBatch takes them
+	 */
+	struct Vertex
+	{
+		M3DVector3f pos;
+		M3DVector3f norm;
+		M3DVector2f tex;
+	};
+
+	/**
+	 * @fn	MeshSimplifier::MeshSimplifier(void);
+	 *
+	 * @brief	Constructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	MeshSimplifier(void);
+
+	/**
+	 * @fn	MeshSimplifier::~MeshSimplifier(void);
+	 *
+	 * @brief	Destructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~MeshSimplifier(void);
+
+	/**
+	 * @fn	void MeshSimplifier::clear();
+	 *
+	 * @brief	Throws away the mesh, ready for new triangles
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void clear();
+
+	/**
+	 * @fn	void MeshSimplifier::addTriangle(M3DVector3f verts[3], M3DVector3f norms[3],
+	 * 		M3DVector2f texCoords[3]);
+	 *
+	 * @brief	Adds a triangle, as GLTriangleBatch::AddTriangle() does. Vertices that match to within
+	 * 			the same tolerance are welded together
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	verts	 	The positions.
+	 * @param	norms	 	The normals.
+	 * @param	texCoords	The texture coordinates.
+	 */
+	void addTriangle(M3DVector3f verts[3], M3DVector3f norms[3], M3DVector2f texCoords[3]);
+
+	/**
+	 * @fn	void MeshSimplifier::setMesh(const M3DVector3f *verts, const M3DVector3f *norms,
+	 * 		const M3DVector2f *texCoords, int numVerts, const GLushort *indexes, int numIndexes);
+	 *
+	 * @brief	Replaces the mesh with an indexed triangle list, e.g. from an asset loader
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	verts	  	The positions.
+	 * @param	norms	  	The normals.
+	 * @param	texCoords 	The texture coordinates.
+	 * @param	numVerts  	The number of vertices.
+	 * @param	indexes   	Three indexes per triangle.
+	 * @param	numIndexes	The number of indexes.
+	 */
+	void setMesh(const M3DVector3f *verts, const M3DVector3f *norms, const M3DVector2f *texCoords, int numVerts, const GLushort *indexes, int numIndexes);
+
+	/**
+	 * @fn	int MeshSimplifier::simplify(int targetTriangles);
+	 *
+	 * @brief	Collapses edges, cheapest first, until there are no more than 'targetTriangles' left
+	 * 			or nothing more can be collapsed. Carries on from the last call, so a chain of levels
+	 * 			comes from calling it with smaller and smaller targets
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	targetTriangles	The number of triangles to get down to.
+	 *
+	 * @return	The number of triangles left.
+	 */
+	int simplify(int targetTriangles);
+
+	/**
+	 * @fn	void MeshSimplifier::reset();
+	 *
+	 * @brief	Undoes every simplify() since the mesh was added
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void reset();
+
+	/**
+	 * @fn	int MeshSimplifier::getNumSourceTriangles()
+	 *
+	 * @brief	Gets the number of triangles that were added.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of triangles.
+	 */
+	int getNumSourceTriangles(){	return (int)corners.size()/3;	};
+
+	/**
+	 * @fn	int MeshSimplifier::getNumTriangles();
+	 *
+	 * @brief	Gets the number of triangles as of the last simplify().
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of triangles.
+	 */
+	int getNumTriangles();
+
+	/**
+	 * @fn	void MeshSimplifier::getMesh(vector<Vertex> &verts, vector<GLushort> &tris);
+	 *
+	 * @brief	Gets the current mesh as an indexed triangle list, with only the vertices it uses
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [out]	verts  	The vertices.
+	 * @param [out]	tris   	Three indexes per triangle.
+	 */
+	void getMesh(vector<Vertex> &verts, vector<GLushort> &tris);
+
+	/**
+	 * @fn	bool MeshSimplifier::buildBatch(GLTriangleBatch &batch);
+	 *
+	 * @brief	Loads the current mesh into a GLTriangleBatch. Needs the GL context
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	batch	The batch, which should not have been built yet.
+	 *
+	 * @return	false if the mesh has more vertices than 16 bit indexes can reach.
+	 */
+	bool buildBatch(GLTriangleBatch &batch);
+
+protected:
+
+	/**
+	 * @struct	Quadric
+	 *
+	 * @brief	The symmetric 4x4 matrix of a sum of squared distances to planes. Kept in doubles, as
+	 * 			the terms of a large flat area cancel
+	 */
+	struct Quadric
+	{
+		double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+	};
+
+	/**
+	 * @struct	Edge
+	 *
+	 * @brief	One side of an edge between two positions, from one triangle
+	 */
+	struct Edge
+	{
+		int posA, posB;		// posA < posB
+		int vertA, vertB;	// the vertices that the triangle uses at posA and posB
+		int tri;
+		bool operator<(const Edge &e) const {	return posA < e.posA || (posA == e.posA && posB < e.posB);	};
+	};
+
+	/**
+	 * @struct	Collapse
+	 *
+	 * @brief	Moving position 'from' onto position 'to', for 'cost'
+	 */
+	struct Collapse
+	{
+		int from;
+		int to;
+		double cost;
+		bool operator<(const Collapse &c) const {	return cost < c.cost;	};
+	};
+
+	void weld();
+	static void weldClose(const vector<Vertex> &in, int numFloats, vector<Vertex> &out, vector<int> &remap);
+	void collectEdges(vector<Edge> &edges);
+	void buildQuadrics();
+	void buildAdjacency();
+	bool tryCollapse(int from, int to);
+
+	static void addPlane(Quadric &q, const M3DVector3f normal, float d, double weight);
+	static double evaluate(const Quadric &q, const M3DVector3f p);
+
+	/**
+	 * @summary	Three vertices per triangle as they were added, before welding
+	 */
+	vector<Vertex> corners;
+
+	/**
+	 * @summary	The welded vertices, the position each is at, and where each position is
+	 */
+	vector<Vertex> vertices;
+	vector<int> vertexPos;
+	vector<Vertex> positions;
+	bool welded;
+
+	/**
+	 * @summary	The triangles as welded, and as simplified so far
+	 */
+	vector<int> sourceIndexes;
+	vector<int> indexes;
+
+	/**
+	 * @summary	The error quadric of each position
+	 */
+	vector<Quadric> quadrics;
+
+	/**
+	 * @summary	For each position, its triangles (adjacency[adjacencyStart[p]] onwards). Rebuilt at
+	 * 			the start of each pass of simplify()
+	 */
+	vector<int> adjacencyStart;
+	vector<int> adjacency;
+
+	/**
+	 * @summary	Per pass: where each vertex has been collapsed to, the positions that have been
+	 * 			changed, the positions that must not move, and the positions on a border or seam
+	 */
+	vector<int> vertexRemap;
+	vector<unsigned char> touched;
+	vector<unsigned char> locked;
+	vector<unsigned char> border;
+
+	/**
+	 * @summary	The number of triangles left in 'indexes' that haven't been collapsed away
+	 */
+	int liveTriangles;
+};
@@ -0,0 +1,153 @@
+#include "StdAfx.h"
+#include "OffscreenTarget.h"
+
+static const GLenum fboBuffs[] = { GL_COLOR_ATTACHMENT0 };
+
+/**
+ * @fn	OffscreenTarget::OffscreenTarget(void)
+ *
+ * @brief	Constructor. Nothing is allocated until create() is called
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+OffscreenTarget::OffscreenTarget(void)
+{
+	fbo = 0;
+	colorBuffer = 0;
+	depthBuffer = 0;
+	width = 0;
+	height = 0;
+}
+
+OffscreenTarget::~OffscreenTarget(void)
+{
+}
+
+/**
+ * @fn	bool OffscreenTarget::create(int w, int h)
+ *
+ * @brief	Creates the framebuffer and its renderbuffers, replacing any previous ones.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	w	The width.
+ * @param	h	The height.
+ *
+ * @return	true if the framebuffer is complete.
+ */
+bool OffscreenTarget::create(int w, int h){
+	GLenum status;
+
+	cleanup();
+	width = w;
+	height = h;
+
+	glGenRenderbuffers(1, &colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+	status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if(status != GL_FRAMEBUFFER_COMPLETE){
+		fprintf(stderr, "OffscreenTarget::create() framebuffer incomplete: 0x%x\n", status);
+		cleanup();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @fn	void OffscreenTarget::bind()
+ *
+ * @brief	Binds the framebuffer for both drawing and reading
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void OffscreenTarget::bind(){
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glDrawBuffers(1, fboBuffs);
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+}
+
+/**
+ * @fn	bool OffscreenTarget::saveTGA(const char *fileName)
+ *
+ * @brief	Reads back the color buffer and writes it as an uncompressed 32 bit TGA file
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	fileName	Filename of the file.
+ *
+ * @return	true if it succeeds, false if it fails.
+ */
+bool OffscreenTarget::saveTGA(const char *fileName){
+	FILE *fp;
+	unsigned char header[18];
+	unsigned char *pixels;
+
+	if(fbo == 0)
+		return false;
+
+	if(fopen_s(&fp, fileName, "wb") != 0){
+		fprintf(stderr, "OffscreenTarget::saveTGA() unable to open '%s'\n", fileName);
+		return false;
+	}
+
+	pixels = new unsigned char[width*height*4];
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, pixels); // TGA is bottom-up BGRA, same as GL
+
+	memset(header, 0, sizeof(header));
+	header[2] = 2; // uncompressed true color
+	header[12] = (unsigned char)(width & 0xff);
+	header[13] = (unsigned char)(width >> 8);
+	header[14] = (unsigned char)(height & 0xff);
+	header[15] = (unsigned char)(height >> 8);
+	header[16] = 32;
+	header[17] = 8; // alpha bits
+
+	fwrite(header, sizeof(header), 1, fp);
+	fwrite(pixels, width*height*4, 1, fp);
+	fclose(fp);
+
+	delete[] pixels;
+	return true;
+}
+
+/**
+ * @fn	void OffscreenTarget::cleanup()
+ *
+ * @brief	Deletes the framebuffer and renderbuffers and rebinds the default framebuffer
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void OffscreenTarget::cleanup(){
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if(fbo != 0)
+		glDeleteFramebuffers(1, &fbo);
+	if(colorBuffer != 0)
+		glDeleteRenderbuffers(1, &colorBuffer);
+	if(depthBuffer != 0)
+		glDeleteRenderbuffers(1, &depthBuffer);
+	fbo = 0;
+	colorBuffer = 0;
+	depthBuffer = 0;
+}
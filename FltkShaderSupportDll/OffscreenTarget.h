@@ -0,0 +1,138 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <stdio.h>
+
+/**
+ * @class	OffscreenTarget
+ *
+ * @brief	A framebuffer object with a color and a depth renderbuffer that Gl_ShaderWindow can draw into
+ * 			instead of the window's back buffer. Used by the headless mode so that frames can be
+ * 			rendered, timed and captured without anything being put on the screen.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class OffscreenTarget
+{
+public:
+
+	/**
+	 * @fn	OffscreenTarget::OffscreenTarget(void);
+	 *
+	 * @brief	Constructor. Nothing is allocated until create() is called
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	OffscreenTarget(void);
+
+	/**
+	 * @fn	OffscreenTarget::~OffscreenTarget(void);
+	 *
+	 * @brief	Destructor. Call cleanup() while the GL context is still current first
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~OffscreenTarget(void);
+
+	/**
+	 * @fn	bool OffscreenTarget::create(int w, int h);
+	 *
+	 * @brief	Creates the framebuffer and its renderbuffers, replacing any previous ones.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	w	The width.
+	 * @param	h	The height.
+	 *
+	 * @return	true if the framebuffer is complete.
+	 */
+	bool create(int w, int h);
+
+	/**
+	 * @fn	void OffscreenTarget::bind();
+	 *
+	 * @brief	Binds the framebuffer for both drawing and reading, so that post-process passes such as
+	 * 			ScreenRepaint read back what was just drawn
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void bind();
+
+	/**
+	 * @fn	bool OffscreenTarget::saveTGA(const char *fileName);
+	 *
+	 * @brief	Reads back the color buffer and writes it as an uncompressed 32 bit TGA file. This waits
+	 * 			for the GPU, so only call it outside the timed frames
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	fileName	Filename of the file.
+	 *
+	 * @return	true if it succeeds, false if it fails.
+	 */
+	bool saveTGA(const char *fileName);
+
+	/**
+	 * @fn	int OffscreenTarget::getWidth()
+	 *
+	 * @brief	Gets the width.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The width.
+	 */
+	int getWidth(){	return width;	};
+
+	/**
+	 * @fn	int OffscreenTarget::getHeight()
+	 *
+	 * @brief	Gets the height.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The height.
+	 */
+	int getHeight(){	return height;	};
+
+	/**
+	 * @fn	void OffscreenTarget::cleanup();
+	 *
+	 * @brief	Deletes the framebuffer and renderbuffers and rebinds the default framebuffer
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void cleanup();
+
+protected:
+
+	/**
+	 * @summary	The framebuffer object
+	 */
+	GLuint fbo;
+
+	/**
+	 * @summary	The color renderbuffer
+	 */
+	GLuint colorBuffer;
+
+	/**
+	 * @summary	The depth renderbuffer
+	 */
+	GLuint depthBuffer;
+
+	/**
+	 * @summary	The size of the buffers
+	 */
+	int width;
+	int height;
+};
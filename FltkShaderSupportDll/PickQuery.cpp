@@ -0,0 +1,127 @@
+#include "StdAfx.h"
+#include "PickQuery.h"
+#include <stdio.h>
+
+/**
+ * @fn	PickQuery::PickQuery(void)
+ *
+ * @brief	Constructor. No GL calls are made until the first begin()
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+PickQuery::PickQuery(void)
+{
+	for(int i = 0; i < NUM_QUERIES; ++i){
+		queries[i] = 0;
+		pending[i] = false;
+	}
+	next = 0;
+	oldest = 0;
+	testing = false;
+	initialized = false;
+	failed = false;
+}
+
+PickQuery::~PickQuery(void)
+{
+}
+
+/**
+ * @fn	void PickQuery::begin()
+ *
+ * @brief	Starts testing the GL commands that follow, unless every query in the ring is still in flight
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void PickQuery::begin(){
+	if(!initialized){
+		if(failed)
+			return;
+		glGenQueries(NUM_QUERIES, queries);
+		if(queries[0] == 0){
+			printf("PickQuery::begin() glGenQueries ERROR: %s\n", gluErrorString(glGetError()));
+			failed = true;
+			return;
+		}
+		initialized = true;
+	}
+
+	// the GPU is more than NUM_QUERIES picks behind. Skip this one rather than wait
+	if(pending[next])
+		return;
+
+	glBeginQuery(GL_ANY_SAMPLES_PASSED, queries[next]);
+	testing = true;
+}
+
+/**
+ * @fn	void PickQuery::end()
+ *
+ * @brief	Stops testing.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void PickQuery::end(){
+	if(!testing)
+		return;
+
+	glEndQuery(GL_ANY_SAMPLES_PASSED);
+	pending[next] = true;
+	next = (next + 1) % NUM_QUERIES;
+	testing = false;
+}
+
+/**
+ * @fn	bool PickQuery::getResult(bool &hit)
+ *
+ * @brief	Gets the oldest finished test without waiting, if there is one. Queries complete in the
+ * 			order they were issued, so if the oldest isn't available yet none of the others are either
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param [in,out]	hit	true if anything was drawn.
+ *
+ * @return	true if a result was returned, false if nothing has finished yet.
+ */
+bool PickQuery::getResult(bool &hit){
+	GLint available = 0;
+	GLint samples = 0;
+
+	if(!pending[oldest])
+		return false;
+
+	glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+	if(!available)
+		return false;
+
+	glGetQueryObjectiv(queries[oldest], GL_QUERY_RESULT, &samples);
+	pending[oldest] = false;
+	oldest = (oldest + 1) % NUM_QUERIES;
+
+	hit = (samples != 0);
+	return true;
+}
+
+/**
+ * @fn	void PickQuery::cleanup()
+ *
+ * @brief	Deletes the query objects.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void PickQuery::cleanup(){
+	if(initialized){
+		glDeleteQueries(NUM_QUERIES, queries);
+		initialized = false;
+	}
+	for(int i = 0; i < NUM_QUERIES; ++i)
+		pending[i] = false;
+	next = 0;
+	oldest = 0;
+	testing = false;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+
+/**
+ * @class	PickQuery
+ *
+ * @brief	Finds out whether a block of GL commands drew anything, using GL_ANY_SAMPLES_PASSED
+ * 			occlusion queries. Like GpuTimer, the queries are kept in a small ring and a result is only
+ * 			read back once GL_QUERY_RESULT_AVAILABLE says it is ready (usually a frame or two later),
+ * 			so picking never waits for the GPU. If every query in the ring is still in flight, that
+ * 			begin()/end() pair is not tested.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class PickQuery
+{
+public:
+
+	/**
+	 * @brief	Number of queries in the ring
+	 */
+	enum {NUM_QUERIES = 4};
+
+	/**
+	 * @fn	PickQuery::PickQuery(void);
+	 *
+	 * @brief	Constructor. No GL calls are made until the first begin()
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	PickQuery(void);
+
+	/**
+	 * @fn	PickQuery::~PickQuery(void);
+	 *
+	 * @brief	Destructor. Call cleanup() while the GL context is still current first
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~PickQuery(void);
+
+	/**
+	 * @fn	void PickQuery::begin();
+	 *
+	 * @brief	Starts testing the GL commands that follow, unless every query in the ring is still in flight
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void begin();
+
+	/**
+	 * @fn	void PickQuery::end();
+	 *
+	 * @brief	Stops testing.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void end();
+
+	/**
+	 * @fn	bool PickQuery::getResult(bool &hit);
+	 *
+	 * @brief	Gets the oldest finished test without waiting, if there is one
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	hit	true if anything was drawn.
+	 *
+	 * @return	true if a result was returned, false if nothing has finished yet.
+	 */
+	bool getResult(bool &hit);
+
+	/**
+	 * @fn	bool PickQuery::isPending()
+	 *
+	 * @brief	Query if any test is still waiting to be read.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if a result is on its way.
+	 */
+	bool isPending(){	return pending[oldest];	};
+
+	/**
+	 * @fn	bool PickQuery::isValid()
+	 *
+	 * @brief	Query if the query objects could be created
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	false if glGenQueries() failed.
+	 */
+	bool isValid(){	return !failed;	};
+
+	/**
+	 * @fn	void PickQuery::cleanup();
+	 *
+	 * @brief	Deletes the query objects.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void cleanup();
+
+protected:
+
+	/**
+	 * @summary	The ring of query objects
+	 */
+	GLuint queries[NUM_QUERIES];
+
+	/**
+	 * @summary	true for each query that has been issued but not read back
+	 */
+	bool pending[NUM_QUERIES];
+
+	/**
+	 * @summary	The query that the next begin() will use
+	 */
+	int next;
+
+	/**
+	 * @summary	The oldest query that may still be pending
+	 */
+	int oldest;
+
+	/**
+	 * @summary	true between a begin() that started a query and its end()
+	 */
+	bool testing;
+
+	bool initialized;
+	bool failed;
+};
@@ -0,0 +1,212 @@
+#include "StdAfx.h"
+#include "RayCaster.h"
+#include "DrawableObject.h"
+#include <algorithm>
+#include <float.h>
+
+/**
+ * @fn	bool RayCaster::unproject(const M3DMatrix44f modelView, const M3DMatrix44f projection,
+ * 		const int viewport[4], float winX, float winY, M3DVector3f origin, M3DVector3f dir)
+ *
+ * @brief	Makes the ray under a window position by taking the point on the near and the far plane
+ * 			back through the inverse of projection * modelView, the way gluUnProject() does
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	modelView 	The model view matrix.
+ * @param	projection	The projection matrix.
+ * @param	viewport  	The viewport.
+ * @param	winX	  	The x coordinate.
+ * @param	winY	  	The y coordinate.
+ * @param	origin	  	[out] The start of the ray.
+ * @param	dir		  	[out] The unit direction of the ray.
+ *
+ * @return	false if the matrices can't be inverted.
+ */
+bool RayCaster::unproject(const M3DMatrix44f modelView, const M3DMatrix44f projection, const int viewport[4],
+		float winX, float winY, M3DVector3f origin, M3DVector3f dir){
+	M3DMatrix44f mvp, inverse;
+	M3DVector4f ndc, nearPt, farPt;
+
+	m3dMatrixMultiply44(mvp, projection, modelView);
+	m3dInvertMatrix44(inverse, mvp);
+
+	ndc[0] = (winX - viewport[0]) / viewport[2] * 2.0f - 1.0f;
+	ndc[1] = (winY - viewport[1]) / viewport[3] * 2.0f - 1.0f;
+	ndc[3] = 1.0f;
+
+	ndc[2] = -1.0f;
+	m3dTransformVector4(nearPt, ndc, inverse);
+	ndc[2] = 1.0f;
+	m3dTransformVector4(farPt, ndc, inverse);
+
+	if(nearPt[3] == 0.0f || farPt[3] == 0.0f)
+		return false;
+
+	for(int i = 0; i < 3; ++i){
+		origin[i] = nearPt[i] / nearPt[3];
+		dir[i] = farPt[i] / farPt[3] - origin[i];
+	}
+	m3dNormalizeVector3(dir);
+	return true;
+}
+
+/**
+ * @fn	bool RayCaster::raySphere(const M3DVector3f origin, const M3DVector3f dir,
+ * 		const M3DVector3f center, float radius, float &distance)
+ *
+ * @brief	Tests a ray against a sphere.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	origin			The start of the ray.
+ * @param	dir				The unit direction of the ray.
+ * @param	center			The center of the sphere.
+ * @param	radius			The radius.
+ * @param [out]	distance	Where the ray enters the sphere.
+ *
+ * @return	true if the ray hits the sphere in front of its origin.
+ */
+bool RayCaster::raySphere(const M3DVector3f origin, const M3DVector3f dir, const M3DVector3f center, float radius, float &distance){
+	M3DVector3f toCenter;
+	float along, closestSq, halfChord;
+
+	m3dSubtractVectors3(toCenter, center, origin);
+	along = m3dDotProduct3(toCenter, dir);
+	closestSq = m3dDotProduct3(toCenter, toCenter) - along*along;
+	if(closestSq > radius*radius)
+		return false;
+
+	halfChord = sqrt(radius*radius - closestSq);
+	if(along + halfChord < 0.0f)
+		return false; // behind the ray
+
+	distance = (along - halfChord > 0.0f) ? along - halfChord : 0.0f;
+	return true;
+}
+
+/**
+ * @fn	bool RayCaster::rayAABB(const M3DVector3f origin, const M3DVector3f dir,
+ * 		const float boxMin[3], const float boxMax[3], float &distance)
+ *
+ * @brief	Tests a ray against an axis aligned box with the slab method.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	origin			The start of the ray.
+ * @param	dir				The unit direction of the ray.
+ * @param	boxMin			The minimum corner.
+ * @param	boxMax			The maximum corner.
+ * @param [out]	distance	Where the ray enters the box.
+ *
+ * @return	true if the ray hits the box in front of its origin.
+ */
+bool RayCaster::rayAABB(const M3DVector3f origin, const M3DVector3f dir, const float boxMin[3], const float boxMax[3], float &distance){
+	float tNear = 0.0f;
+	float tFar = FLT_MAX;
+
+	for(int i = 0; i < 3; ++i){
+		if(fabs(dir[i]) < 1e-8f){
+			// parallel to this pair of planes, so it has to start between them
+			if(origin[i] < boxMin[i] || origin[i] > boxMax[i])
+				return false;
+			continue;
+		}
+
+		float t0 = (boxMin[i] - origin[i]) / dir[i];
+		float t1 = (boxMax[i] - origin[i]) / dir[i];
+		if(t0 > t1){
+			float t = t0;
+			t0 = t1;
+			t1 = t;
+		}
+		if(t0 > tNear)
+			tNear = t0;
+		if(t1 < tFar)
+			tFar = t1;
+		if(tNear > tFar)
+			return false;
+	}
+
+	distance = tNear;
+	return true;
+}
+
+/**
+ * @fn	bool RayCaster::rayTriangle(const M3DVector3f origin, const M3DVector3f dir,
+ * 		const M3DVector3f v0, const M3DVector3f v1, const M3DVector3f v2, float &distance)
+ *
+ * @brief	Tests a ray against a triangle (Moller-Trumbore).
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	origin			The start of the ray.
+ * @param	dir				The direction of the ray.
+ * @param	v0				The first corner.
+ * @param	v1				The second corner.
+ * @param	v2				The third corner.
+ * @param [out]	distance	Where the ray hits the triangle.
+ *
+ * @return	true if the ray hits the triangle in front of its origin.
+ */
+bool RayCaster::rayTriangle(const M3DVector3f origin, const M3DVector3f dir,
+		const M3DVector3f v0, const M3DVector3f v1, const M3DVector3f v2, float &distance){
+	M3DVector3f edge1, edge2, p, s, q;
+	float det, invDet, u, v, t;
+
+	m3dSubtractVectors3(edge1, v1, v0);
+	m3dSubtractVectors3(edge2, v2, v0);
+	m3dCrossProduct3(p, dir, edge2);
+	det = m3dDotProduct3(edge1, p);
+	if(fabs(det) < 1e-8f)
+		return false; // parallel to the triangle
+
+	invDet = 1.0f / det;
+	m3dSubtractVectors3(s, origin, v0);
+	u = m3dDotProduct3(s, p) * invDet;
+	if(u < 0.0f || u > 1.0f)
+		return false;
+
+	m3dCrossProduct3(q, s, edge1);
+	v = m3dDotProduct3(dir, q) * invDet;
+	if(v < 0.0f || u + v > 1.0f)
+		return false;
+
+	t = m3dDotProduct3(edge2, q) * invDet;
+	if(t < 0.0f)
+		return false;
+
+	distance = t;
+	return true;
+}
+
+/**
+ * @fn	void RayCaster::castRay(const vector<DrawableObject*> &objects, const M3DVector3f origin,
+ * 		const M3DVector3f dir, vector<Hit> &hits)
+ *
+ * @brief	Tests a ray against each object with DrawableObject::rayIntersect().
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	objects			The objects to test.
+ * @param	origin			The start of the ray, in world space.
+ * @param	dir				The unit direction of the ray.
+ * @param [out]	hits		The objects hit, nearest first.
+ */
+void RayCaster::castRay(const vector<DrawableObject*> &objects, const M3DVector3f origin, const M3DVector3f dir, vector<Hit> &hits){
+	Hit hit;
+
+	hits.clear();
+	for(unsigned int i = 0; i < objects.size(); ++i){
+		if(objects[i]->rayIntersect(origin, dir, hit.distance)){
+			hit.obj = objects[i];
+			hits.push_back(hit);
+		}
+	}
+	sort(hits.begin(), hits.end());
+}
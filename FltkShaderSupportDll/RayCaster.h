@@ -0,0 +1,138 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <math3d.h>
+#include <vector>
+
+using namespace std;
+
+class DrawableObject;
+
+/**
+ * @class	RayCaster
+ *
+ * @brief	Picking on the CPU. A ray is cast from the eye through the cursor and tested against each
+ * 			object's bounding sphere, then its bounding box, so a pick costs no GPU round trip at all and
+ * 			can be made from the simulation thread. Objects that want exact hits can override
+ * 			DrawableObject::rayIntersect() and finish with rayTriangle() against their own vertices.
+ * 			Like GLCapabilities, everything is static.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class RayCaster
+{
+public:
+
+	/**
+	 * @struct	Hit
+	 *
+	 * @brief	An object the ray hit, and how far along the ray (in world units) it hit it
+	 */
+	struct Hit
+	{
+		DrawableObject	*obj;
+		float			distance;
+
+		bool operator<(const Hit &h) const {	return distance < h.distance;	};
+	};
+
+	/**
+	 * @fn	static void RayCaster::unproject(const M3DMatrix44f modelView, const M3DMatrix44f projection,
+	 * 		const int viewport[4], float winX, float winY, M3DVector3f origin, M3DVector3f dir);
+	 *
+	 * @brief	Makes the ray that starts on the near plane under a window position and heads away from
+	 * 			the eye, in the space that modelView maps to eye space.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	modelView 	The model view matrix.
+	 * @param	projection	The projection matrix.
+	 * @param	viewport  	The viewport.
+	 * @param	winX	  	The x coordinate, in GL window coordinates.
+	 * @param	winY	  	The y coordinate, in GL window coordinates (origin at the bottom).
+	 * @param	origin	  	[out] The start of the ray.
+	 * @param	dir		  	[out] The unit direction of the ray.
+	 *
+	 * @return	false if the matrices can't be inverted.
+	 */
+	static bool unproject(const M3DMatrix44f modelView, const M3DMatrix44f projection, const int viewport[4],
+		float winX, float winY, M3DVector3f origin, M3DVector3f dir);
+
+	/**
+	 * @fn	static bool RayCaster::raySphere(const M3DVector3f origin, const M3DVector3f dir,
+	 * 		const M3DVector3f center, float radius, float &distance);
+	 *
+	 * @brief	Tests a ray against a sphere.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	origin			The start of the ray.
+	 * @param	dir				The unit direction of the ray.
+	 * @param	center			The center of the sphere.
+	 * @param	radius			The radius.
+	 * @param [out]	distance	Where the ray enters the sphere, or zero if it starts inside.
+	 *
+	 * @return	true if the ray hits the sphere in front of its origin.
+	 */
+	static bool raySphere(const M3DVector3f origin, const M3DVector3f dir, const M3DVector3f center, float radius, float &distance);
+
+	/**
+	 * @fn	static bool RayCaster::rayAABB(const M3DVector3f origin, const M3DVector3f dir,
+	 * 		const float boxMin[3], const float boxMax[3], float &distance);
+	 *
+	 * @brief	Tests a ray against an axis aligned box with the slab method.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	origin			The start of the ray.
+	 * @param	dir				The unit direction of the ray.
+	 * @param	boxMin			The minimum corner.
+	 * @param	boxMax			The maximum corner.
+	 * @param [out]	distance	Where the ray enters the box, or zero if it starts inside.
+	 *
+	 * @return	true if the ray hits the box in front of its origin.
+	 */
+	static bool rayAABB(const M3DVector3f origin, const M3DVector3f dir, const float boxMin[3], const float boxMax[3], float &distance);
+
+	/**
+	 * @fn	static bool RayCaster::rayTriangle(const M3DVector3f origin, const M3DVector3f dir,
+	 * 		const M3DVector3f v0, const M3DVector3f v1, const M3DVector3f v2, float &distance);
+	 *
+	 * @brief	Tests a ray against a triangle (Moller-Trumbore). Both sides of the triangle count
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	origin			The start of the ray.
+	 * @param	dir				The direction of the ray.
+	 * @param	v0				The first corner.
+	 * @param	v1				The second corner.
+	 * @param	v2				The third corner.
+	 * @param [out]	distance	Where the ray hits the triangle.
+	 *
+	 * @return	true if the ray hits the triangle in front of its origin.
+	 */
+	static bool rayTriangle(const M3DVector3f origin, const M3DVector3f dir,
+		const M3DVector3f v0, const M3DVector3f v1, const M3DVector3f v2, float &distance);
+
+	/**
+	 * @fn	static void RayCaster::castRay(const vector<DrawableObject*> &objects,
+	 * 		const M3DVector3f origin, const M3DVector3f dir, vector<Hit> &hits);
+	 *
+	 * @brief	Tests a ray against each object with DrawableObject::rayIntersect().
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	objects			The objects to test.
+	 * @param	origin			The start of the ray, in world space.
+	 * @param	dir				The unit direction of the ray.
+	 * @param [out]	hits		The objects hit, nearest first.
+	 */
+	static void castRay(const vector<DrawableObject*> &objects, const M3DVector3f origin, const M3DVector3f dir, vector<Hit> &hits);
+};
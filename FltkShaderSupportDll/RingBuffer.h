@@ -0,0 +1,98 @@
+#pragma once
+
+#include <windows.h>
+
+/**
+ * @class	RingBuffer
+ *
+ * @brief	Lock-free fixed size queue from one writer thread to one reader thread. Each index is only
+ * 			ever written by one side, so a memory barrier before publishing it is all the
+ * 			synchronization needed. SIZE must be a power of two; the ring holds SIZE-1 items.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+template <class T, int SIZE>
+class RingBuffer
+{
+public:
+
+	/**
+	 * @fn	RingBuffer::RingBuffer()
+	 *
+	 * @brief	Constructor. The ring starts empty
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	RingBuffer(){
+		writeIndex = 0;
+		readIndex = 0;
+	}
+
+	/**
+	 * @fn	bool RingBuffer::push(const T &item)
+	 *
+	 * @brief	Adds an item at the back. Only call from the writer thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	item	The item.
+	 *
+	 * @return	false if the ring is full, in which case the item is not added.
+	 */
+	bool push(const T &item){
+		LONG w = writeIndex;
+		LONG next = (w + 1) & INDEX_MASK;
+		if(next == readIndex)
+			return false;
+		items[w] = item;
+		MemoryBarrier(); // the item must be visible before the index that publishes it
+		writeIndex = next;
+		return true;
+	}
+
+	/**
+	 * @fn	bool RingBuffer::pop(T &item)
+	 *
+	 * @brief	Takes the item at the front. Only call from the reader thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param [in,out]	item	The item.
+	 *
+	 * @return	false if the ring is empty.
+	 */
+	bool pop(T &item){
+		LONG r = readIndex;
+		if(r == writeIndex)
+			return false;
+		MemoryBarrier();
+		item = items[r];
+		MemoryBarrier(); // finish reading the slot before the writer is allowed to reuse it
+		readIndex = (r + 1) & INDEX_MASK;
+		return true;
+	}
+
+	/**
+	 * @fn	bool RingBuffer::isEmpty()
+	 *
+	 * @brief	Query if the ring is empty. Only a snapshot if called while the other side is active
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if empty.
+	 */
+	bool isEmpty(){	return readIndex == writeIndex;	};
+
+private:
+	static const LONG INDEX_MASK = SIZE - 1;
+
+	T items[SIZE];
+	volatile LONG writeIndex;
+	volatile LONG readIndex;
+};
@@ -23,6 +23,7 @@ ScreenRepaint::ScreenRepaint(GLuint activeTexture, const char* vertFileName, con
 	: DrawableObject(activeTexture)
 {
 	screenTextureID = activeTexture; // this is done in the superclass, but for some reason we need to do it here, or we get a GL_ERROR
+	setSnapshotSafe(true); // render() only reads what resize() sets, on the same thread
 
 	vertexFileName = (char*)malloc(strlen(vertFileName)+2);
 	strcpy(vertexFileName, vertFileName);
@@ -31,6 +32,7 @@ ScreenRepaint::ScreenRepaint(GLuint activeTexture, const char* vertFileName, con
 	strcpy(fragmentFileName, fragFileName);
 
 	fboInitialized = false;
+	setName("ScreenRepaint");
 }
 
 
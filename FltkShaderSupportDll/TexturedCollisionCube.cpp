@@ -4,6 +4,7 @@
 
 TexturedCollisionCube::TexturedCollisionCube(GLuint activeTexture, float xsize, float ysize, float zsize, char* texFileName): CollisionCubeBase(activeTexture, xsize, ysize, zsize)
 {
+	setName("TexturedCollisionCube");
 	setup(texFileName);
 	materialType = NONE_SELECTED;
 }
@@ -31,25 +32,10 @@ void TexturedCollisionCube::setup(char* texFileName){
 }
 
 void TexturedCollisionCube::calcCorners(){
-	modelMat.LoadIdentity();
-	modelMat.Translate(position[0], position[1], position[2]);
-			
-	modelMat.Rotate(orientation[1], 0.0f, 1.0f, 0.0f);
-	modelMat.Rotate(orientation[2], 1.0f, 0.0f, 0.0f);
-
-	modelMat.Translate(minAARB[0], minAARB[1], minAARB[2]);
-	modelMat.GetMatrix(matrix);
-	setPosFromMatrix(cornerPos[0]);
-
-	modelMat.LoadIdentity();
-	modelMat.Translate(position[0], position[1], position[2]);
-			
-	modelMat.Rotate(orientation[1], 0.0f, 1.0f, 0.0f);
-	modelMat.Rotate(orientation[2], 1.0f, 0.0f, 0.0f);
-
-	modelMat.Translate(maxAARB[0], maxAARB[1], maxAARB[2]);
-	modelMat.GetMatrix(matrix);
-	setPosFromMatrix(cornerPos[1]);
+	const M3DMatrix44f &rigid = getRigidMatrix();
+
+	m3dTransformVector3(cornerPos[0], minAARB, rigid);
+	m3dTransformVector3(cornerPos[1], maxAARB, rigid);
 }
 
 void TexturedCollisionCube::environmentCalc(){
@@ -67,6 +53,7 @@ void TexturedCollisionCube::environmentCalc(){
 	calcDeltaTime();
 	orientation[1] += deltaTime * scalar;
 	orientation[2] += deltaTime * scalar;
+	setTransformDirty();
 	//Dprint::add("deltatTime = %.2f, scalar = %.2f, cube angle = %.2f", deltaTime, scalar, orientation[1]);
 }
 
@@ -76,12 +63,10 @@ void TexturedCollisionCube::render(GLMatrixStack &modelViewStack, GLMatrixStack
 	//Dprint::add("TexturedCollisionCube position = (%.2f, %.2f, %.2f)", position[0], position[1], position[2]);
 	//Dprint::add("TexturedCollisionCube orientation = (%.2f, %.2f, %.2f)", orientation[0], orientation[1], orientation[2]);
 
+	const DrawableState &state = getRenderState();
+
 	modelViewStack.PushMatrix();
-		//modelViewStack.Translate(position[0] + size[0]*0.5f, position[1] + size[1]*0.5f, position[2] + size[2]*0.5f);
-		modelViewStack.Translate(position[0], position[1], position[2]);
-		modelViewStack.Rotate(orientation[1], 0.0f, 1.0f, 0.0f);
-		modelViewStack.Rotate(orientation[2], 1.0f, 0.0f, 0.0f);
-		modelViewStack.Scale(size[0], size[1], size[2]);
+		modelViewStack.MultMatrix(getModelMatrix(state));
 
 		glBindTexture(GL_TEXTURE_2D, textureId);
 		shaderManager.UseStockShader(GLT_SHADER_TEXTURE_POINT_LIGHT_DIFF, modelViewStack.GetMatrix(), projectionStack.GetMatrix(), vLightPos, vWhite, 0);
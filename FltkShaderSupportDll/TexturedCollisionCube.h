@@ -79,6 +79,5 @@ private:
 	GLuint	textureId;
 	GLuint	litTexShaderId;
 	float cornerPos[8][3];
-	GLMatrixStack modelMat;
 };
 
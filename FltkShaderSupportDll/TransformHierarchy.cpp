@@ -0,0 +1,304 @@
+#include "StdAfx.h"
+#include "TransformHierarchy.h"
+#include "DrawableObject.h"
+
+/**
+ * @fn	TransformHierarchy::TransformHierarchy(void)
+ *
+ * @brief	Constructor.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+TransformHierarchy::TransformHierarchy(void)
+{
+	layoutDirty = false;
+}
+
+TransformHierarchy::~TransformHierarchy(void)
+{
+}
+
+/**
+ * @fn	int TransformHierarchy::addNode(int parent)
+ *
+ * @brief	Adds a node at the end of the arrays. Its parent was added before it, so is already ahead
+ * 			of it, and update() stays correct before the next relayout()
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	parent	The parent's handle, or NO_PARENT for a root.
+ *
+ * @return	The new node's handle, or NO_PARENT if the parent doesn't exist.
+ */
+int TransformHierarchy::addNode(int parent){
+	Matrix identity;
+	int handle;
+
+	if(parent != NO_PARENT && !isNode(parent)){
+		fprintf(stderr, "TransformHierarchy::addNode() no node %d\n", parent);
+		return NO_PARENT;
+	}
+
+	if(freeHandles.empty()){
+		handle = (int)handleSlot.size();
+		handleSlot.push_back(NO_PARENT);
+	}else{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+
+	m3dLoadIdentity44(identity.m);
+	handleSlot[handle] = (int)slotHandle.size();
+	parentSlot.push_back(parent == NO_PARENT ? NO_PARENT : handleSlot[parent]);
+	slotHandle.push_back(handle);
+	local.push_back(identity);
+	world.push_back(identity);
+	dirty.push_back(1);
+
+	layoutDirty = true;
+	return handle;
+}
+
+/**
+ * @fn	void TransformHierarchy::removeNode(int node)
+ *
+ * @brief	Removes a node and its subtree. Children always follow their parents, so one pass from the
+ * 			node's slot onwards finds the whole subtree
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node	The node's handle.
+ */
+void TransformHierarchy::removeNode(int node){
+	if(!isNode(node))
+		return;
+
+	vector<unsigned char> removed(slotHandle.size(), 0);
+	int first = handleSlot[node];
+
+	removed[first] = 1;
+	for(size_t i = first + 1; i < slotHandle.size(); ++i){
+		if(parentSlot[i] != NO_PARENT && removed[parentSlot[i]])
+			removed[i] = 1;
+	}
+	for(size_t i = first; i < slotHandle.size(); ++i){
+		if(removed[i]){
+			handleSlot[slotHandle[i]] = NO_PARENT;
+			freeHandles.push_back(slotHandle[i]);
+			slotHandle[i] = NO_PARENT;
+		}
+	}
+	relayout();
+}
+
+/**
+ * @fn	void TransformHierarchy::clear()
+ *
+ * @brief	Removes every node
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void TransformHierarchy::clear(){
+	parentSlot.clear();
+	slotHandle.clear();
+	local.clear();
+	world.clear();
+	dirty.clear();
+	handleSlot.clear();
+	freeHandles.clear();
+	layoutDirty = false;
+}
+
+/**
+ * @fn	void TransformHierarchy::setLocalMatrix(int node, const M3DMatrix44f mat)
+ *
+ * @brief	Sets a node's local matrix and marks it dirty.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node	The node's handle.
+ * @param	mat 	The local matrix.
+ */
+void TransformHierarchy::setLocalMatrix(int node, const M3DMatrix44f mat){
+	if(!isNode(node))
+		return;
+
+	int slot = handleSlot[node];
+	m3dCopyMatrix44(local[slot].m, mat);
+	dirty[slot] = 1;
+}
+
+/**
+ * @fn	void TransformHierarchy::setLocalTransform(int node, const float *pos, const float *orient,
+ * 		float scale)
+ *
+ * @brief	Sets a node's local matrix from a position, an orientation and a scale.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node  	The node's handle.
+ * @param	pos   	The position.
+ * @param	orient	The orientation in degrees.
+ * @param	scale 	The scale.
+ */
+void TransformHierarchy::setLocalTransform(int node, const float *pos, const float *orient, float scale){
+	M3DMatrix44f mat;
+
+	DrawableObject::composeTransform(mat, pos, orient, scale, scale, scale);
+	setLocalMatrix(node, mat);
+}
+
+/**
+ * @fn	const M3DMatrix44f& TransformHierarchy::getLocalMatrix(int node)
+ *
+ * @brief	Gets a node's local matrix.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node	The node's handle. Must be a node.
+ *
+ * @return	The local matrix.
+ */
+const M3DMatrix44f& TransformHierarchy::getLocalMatrix(int node){
+	return local[handleSlot[node]].m;
+}
+
+/**
+ * @fn	const M3DMatrix44f& TransformHierarchy::getWorldMatrix(int node)
+ *
+ * @brief	Gets a node's world matrix as of the last update().
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node	The node's handle. Must be a node.
+ *
+ * @return	The world matrix.
+ */
+const M3DMatrix44f& TransformHierarchy::getWorldMatrix(int node){
+	return world[handleSlot[node]].m;
+}
+
+/**
+ * @fn	int TransformHierarchy::getParent(int node)
+ *
+ * @brief	Gets a node's parent.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @param	node	The node's handle.
+ *
+ * @return	The parent's handle, or NO_PARENT for a root (or a handle that isn't a node).
+ */
+int TransformHierarchy::getParent(int node){
+	if(!isNode(node))
+		return NO_PARENT;
+
+	int parent = parentSlot[handleSlot[node]];
+	return parent == NO_PARENT ? NO_PARENT : slotHandle[parent];
+}
+
+/**
+ * @fn	int TransformHierarchy::update()
+ *
+ * @brief	Recomputes the world matrices of dirty nodes and their descendants. A node inherits its
+ * 			parent's dirty flag on the way past, and since parents come first the flag has already
+ * 			been passed down to them by the time a child is reached
+ *
+ * @author	agent
+ * @date	10/17/2026
+ *
+ * @return	The number of world matrices that were recomputed.
+ */
+int TransformHierarchy::update(){
+	int updated = 0;
+	int n;
+
+	if(layoutDirty)
+		relayout();
+
+	n = (int)slotHandle.size();
+	for(int i = 0; i < n; ++i){
+		int parent = parentSlot[i];
+
+		if(parent != NO_PARENT && dirty[parent])
+			dirty[i] = 1;
+		if(!dirty[i])
+			continue;
+
+		if(parent == NO_PARENT)
+			m3dCopyMatrix44(world[i].m, local[i].m);
+		else
+			m3dMatrixMultiply44(world[i].m, world[parent].m, local[i].m);
+		++updated;
+	}
+
+	// only cleared once every child has seen its parent's flag
+	if(updated > 0)
+		dirty.assign(n, 0);
+	return updated;
+}
+
+/**
+ * @fn	void TransformHierarchy::relayout()
+ *
+ * @brief	Sorts the slots into breadth-first order: the roots, then their children, then theirs.
+ * 			Removed slots are dropped, and the parent slots and handles are remapped to the new order
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+void TransformHierarchy::relayout(){
+	int n = (int)slotHandle.size();
+	vector<vector<int> > children(n);
+	vector<int> order;
+	vector<int> newSlot(n, NO_PARENT);
+
+	order.reserve(n);
+	for(int i = 0; i < n; ++i){
+		if(slotHandle[i] == NO_PARENT)
+			continue;
+		if(parentSlot[i] == NO_PARENT)
+			order.push_back(i);
+		else
+			children[parentSlot[i]].push_back(i);
+	}
+	for(size_t i = 0; i < order.size(); ++i){
+		const vector<int> &kids = children[order[i]];
+		order.insert(order.end(), kids.begin(), kids.end());
+	}
+	for(size_t i = 0; i < order.size(); ++i){
+		newSlot[order[i]] = (int)i;
+	}
+
+	vector<int> newParent(order.size());
+	vector<int> newHandle(order.size());
+	vector<Matrix> newLocal(order.size());
+	vector<Matrix> newWorld(order.size());
+	vector<unsigned char> newDirty(order.size());
+
+	for(size_t i = 0; i < order.size(); ++i){
+		int old = order[i];
+		newParent[i] = parentSlot[old] == NO_PARENT ? NO_PARENT : newSlot[parentSlot[old]];
+		newHandle[i] = slotHandle[old];
+		newLocal[i] = local[old];
+		newWorld[i] = world[old];
+		newDirty[i] = dirty[old];
+		handleSlot[newHandle[i]] = (int)i;
+	}
+
+	parentSlot.swap(newParent);
+	slotHandle.swap(newHandle);
+	local.swap(newLocal);
+	world.swap(newWorld);
+	dirty.swap(newDirty);
+	layoutDirty = false;
+}
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <GLTools.h>	// OpenGL toolkit
+#include <math3d.h>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class	TransformHierarchy
+ *
+ * @brief	A tree of transforms, each with a local matrix (relative to its parent) and a world matrix
+ * 			(the product of every local matrix from the root down). Setting a local matrix marks the
+ * 			node dirty, and update() recomputes the world matrices of dirty nodes and everything below
+ * 			them, so branches that didn't change cost a flag test instead of a 4x4 multiply.
+ *
+ * 			Nodes are stored breadth-first in parallel arrays, so update() walks memory front to back
+ * 			and a parent is always finished before its children are reached. Nodes are referred to by
+ * 			handles, which stay the same when the arrays are reordered. New nodes go on the end (which
+ * 			keeps parents ahead of children) and the arrays are put back in breadth-first order by the
+ * 			next update().
+ *
+ * 			Not thread safe. The owner builds and updates it, normally from environmentCalc().
+ *
+ * 			This is a matrix tree for the parts of a single object (SolarSystem's planets, say), not a
+ * 			scene graph: DrawableObjects can't be parented to one another through it, and
+ * 			getModelMatrix(), getWorldBounds(), culling and the BVH never look at it. An object that
+ * 			draws from a hierarchy has to set bounds that cover every node itself.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+class TransformHierarchy
+{
+public:
+
+	/**
+	 * @summary	The parent of a root node
+	 */
+	static const int NO_PARENT = -1;
+
+	/**
+	 * @fn	TransformHierarchy::TransformHierarchy(void);
+	 *
+	 * @brief	Constructor. Starts empty
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	TransformHierarchy(void);
+
+	/**
+	 * @fn	TransformHierarchy::~TransformHierarchy(void);
+	 *
+	 * @brief	Destructor.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	~TransformHierarchy(void);
+
+	/**
+	 * @fn	int TransformHierarchy::addNode(int parent = NO_PARENT);
+	 *
+	 * @brief	Adds a node with an identity local matrix.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	parent	The parent's handle, or NO_PARENT for a root.
+	 *
+	 * @return	The new node's handle, or NO_PARENT if the parent doesn't exist.
+	 */
+	int addNode(int parent = NO_PARENT);
+
+	/**
+	 * @fn	void TransformHierarchy::removeNode(int node);
+	 *
+	 * @brief	Removes a node and everything below it. Their handles may be reused by later nodes
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	node	The node's handle.
+	 */
+	void removeNode(int node);
+
+	/**
+	 * @fn	void TransformHierarchy::clear();
+	 *
+	 * @brief	Removes every node
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void clear();
+
+	/**
+	 * @fn	void TransformHierarchy::setLocalMatrix(int node, const M3DMatrix44f mat);
+	 *
+	 * @brief	Sets a node's transform relative to its parent and marks it dirty.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	node	The node's handle.
+	 * @param	mat 	The local matrix.
+	 */
+	void setLocalMatrix(int node, const M3DMatrix44f mat);
+
+	/**
+	 * @fn	void TransformHierarchy::setLocalTransform(int node, const float *pos, const float *orient,
+	 * 		float scale);
+	 *
+	 * @brief	Sets a node's transform from a position, an orientation and a uniform scale, composed
+	 * 			the same way as DrawableObject's model matrix
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	node  	The node's handle.
+	 * @param	pos   	The position.
+	 * @param	orient	The orientation in degrees.
+	 * @param	scale 	The scale.
+	 */
+	void setLocalTransform(int node, const float *pos, const float *orient, float scale);
+
+	/**
+	 * @fn	const M3DMatrix44f& TransformHierarchy::getLocalMatrix(int node);
+	 *
+	 * @brief	Gets a node's transform relative to its parent.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	node	The node's handle.
+	 *
+	 * @return	The local matrix.
+	 */
+	const M3DMatrix44f& getLocalMatrix(int node);
+
+	/**
+	 * @fn	const M3DMatrix44f& TransformHierarchy::getWorldMatrix(int node);
+	 *
+	 * @brief	Gets a node's transform relative to the root, as of the last update().
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	node	The node's handle.
+	 *
+	 * @return	The world matrix.
+	 */
+	const M3DMatrix44f& getWorldMatrix(int node);
+
+	/**
+	 * @fn	int TransformHierarchy::getParent(int node);
+	 *
+	 * @brief	Gets a node's parent.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	node	The node's handle.
+	 *
+	 * @return	The parent's handle, or NO_PARENT for a root.
+	 */
+	int getParent(int node);
+
+	/**
+	 * @fn	int TransformHierarchy::getNumNodes()
+	 *
+	 * @brief	Gets the number of nodes.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of nodes.
+	 */
+	int getNumNodes(){	return (int)slotHandle.size();	};
+
+	/**
+	 * @fn	int TransformHierarchy::update();
+	 *
+	 * @brief	Brings the world matrices up to date, recomputing only the dirty nodes and their
+	 * 			descendants
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The number of world matrices that were recomputed.
+	 */
+	int update();
+
+protected:
+
+	/**
+	 * @struct	Matrix
+	 *
+	 * @brief	An M3DMatrix44f that can be kept in a vector
+	 */
+	struct Matrix
+	{
+		M3DMatrix44f m;
+	};
+
+	/**
+	 * @fn	bool TransformHierarchy::isNode(int node)
+	 *
+	 * @brief	Query if a handle belongs to a node.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @param	node	The handle.
+	 *
+	 * @return	true if it does.
+	 */
+	bool isNode(int node){	return node >= 0 && node < (int)handleSlot.size() && handleSlot[node] != NO_PARENT;	};
+
+	/**
+	 * @fn	void TransformHierarchy::relayout();
+	 *
+	 * @brief	Puts the arrays in breadth-first order, dropping removed nodes
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void relayout();
+
+	/**
+	 * @summary	Indexed by slot, in breadth-first order after relayout(): the parent's slot, the node's
+	 * 			handle (NO_PARENT once removed), its matrices and whether its local matrix has changed
+	 */
+	vector<int> parentSlot;
+	vector<int> slotHandle;
+	vector<Matrix> local;
+	vector<Matrix> world;
+	vector<unsigned char> dirty;
+
+	/**
+	 * @summary	Indexed by handle: the node's slot, NO_PARENT if the handle is free
+	 */
+	vector<int> handleSlot;
+	vector<int> freeHandles;
+
+	/**
+	 * @summary	true if nodes have been added since the last relayout()
+	 */
+	bool layoutDirty;
+};
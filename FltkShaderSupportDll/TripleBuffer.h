@@ -0,0 +1,114 @@
+#pragma once
+
+#include <windows.h>
+
+/**
+ * @class	TripleBuffer
+ *
+ * @brief	Lock-free handoff of a value from one writer thread to one reader thread. The writer fills
+ * 			writeBuffer() and calls publish(); the reader calls update() and then uses readBuffer().
+ * 			Neither side ever waits for the other: there are three copies of the value, one owned by the
+ * 			writer, one owned by the reader and one 'in flight' that the two sides swap with an
+ * 			InterlockedExchange.
+ *
+ * @author	agent
+ * @date	10/17/2026
+ */
+
+template <class T>
+class TripleBuffer
+{
+public:
+
+	/**
+	 * @fn	TripleBuffer::TripleBuffer()
+	 *
+	 * @brief	Constructor. The writer starts on slot 0, the reader on slot 1 and slot 2 is shared
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	TripleBuffer(){
+		writeIndex = 0;
+		readIndex = 1;
+		shared = 2;
+	}
+
+	/**
+	 * @fn	T& TripleBuffer::writeBuffer()
+	 *
+	 * @brief	The slot that the writer thread may fill. Only call from the writer thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The write slot.
+	 */
+	T& writeBuffer(){	return buffers[writeIndex];	};
+
+	/**
+	 * @fn	void TripleBuffer::publish()
+	 *
+	 * @brief	Hands the write slot to the reader and takes the shared slot as the new write slot.
+	 * 			Only call from the writer thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 */
+	void publish(){
+		writeIndex = InterlockedExchange(&shared, writeIndex | FRESH_BIT) & INDEX_MASK;
+	}
+
+	/**
+	 * @fn	bool TripleBuffer::update()
+	 *
+	 * @brief	If the writer has published since the last call, swap the read slot for the newest one.
+	 * 			Only call from the reader thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	true if readBuffer() now holds newer data, false if nothing has been published.
+	 */
+	bool update(){
+		if((shared & FRESH_BIT) == 0)
+			return false;
+		readIndex = InterlockedExchange(&shared, readIndex) & INDEX_MASK;
+		return true;
+	}
+
+	/**
+	 * @fn	const T& TripleBuffer::readBuffer()
+	 *
+	 * @brief	The most recent value the reader has picked up with update(). Only call from the reader thread.
+	 *
+	 * @author	agent
+	 * @date	10/17/2026
+	 *
+	 * @return	The read slot.
+	 */
+	const T& readBuffer(){	return buffers[readIndex];	};
+
+private:
+	enum{INDEX_MASK = 0x3, FRESH_BIT = 0x4};
+
+	/**
+	 * @summary	The three copies of the value
+	 */
+	T buffers[3];
+
+	/**
+	 * @summary	The slot in flight between the threads, plus a bit that says if it has been published but not read
+	 */
+	volatile LONG shared;
+
+	/**
+	 * @summary	The slot owned by the writer
+	 */
+	LONG writeIndex;
+
+	/**
+	 * @summary	The slot owned by the reader
+	 */
+	LONG readIndex;
+};